@@ -0,0 +1,83 @@
+/**
+ * CRC-16 micro-benchmark.
+ *
+ * Compares the three ModBeeCRC variants on typical ModBee frame sizes:
+ * - bitwise: the original 8-shifts-per-byte loop
+ * - table:   one 256-entry table lookup per byte
+ * - slice4:  four table lookups per 4 bytes
+ *
+ * Every variant is checked against the bitwise reference first. Results are
+ * printed as CPU cycles per byte (ESP.getCycleCount() on ESP32, micros()
+ * elsewhere).
+ *
+ * No bus hardware is needed; open the serial monitor at 115200 baud.
+ */
+
+#include <ModBeeGlobal.h>
+
+#define SERIAL_BAUD 115200
+#define BENCH_ITERATIONS 200
+
+static uint8_t benchData[MODBEE_MAX_TX_BUFFER];
+static volatile uint16_t benchSink;
+
+static inline uint32_t benchNow() {
+#if defined(ESP32)
+    return ESP.getCycleCount();
+#else
+    return micros();
+#endif
+}
+
+typedef uint16_t (*CrcFunction)(const uint8_t*, uint16_t, uint16_t);
+
+float benchVariant(CrcFunction crc, uint16_t length) {
+    uint32_t start = benchNow();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        benchSink = crc(benchData, length, MODBEE_CRC_INIT);
+    }
+    uint32_t ticks = benchNow() - start;
+
+    return (float)ticks / ((float)length * BENCH_ITERATIONS);
+}
+
+void setup() {
+    Serial.begin(SERIAL_BAUD);
+    delay(2000);
+
+    for (uint16_t i = 0; i < sizeof(benchData); i++) {
+        benchData[i] = (uint8_t)random(256);
+    }
+
+    // Sanity check: all variants must agree (also the incremental API)
+    const uint16_t checkLengths[] = {0, 1, 3, 7, 64, 511, 512};
+    bool allMatch = true;
+    for (uint16_t length : checkLengths) {
+        uint16_t reference = ModBeeCRC::calculateBitwise(benchData, length);
+        uint16_t incremental = MODBEE_CRC_INIT;
+        for (uint16_t i = 0; i < length; i++) {
+            incremental = ModBeeCRC::update(incremental, benchData[i]);
+        }
+        if (ModBeeCRC::calculateTable(benchData, length) != reference ||
+            ModBeeCRC::calculateSlice4(benchData, length) != reference ||
+            incremental != reference) {
+            Serial.printf("MISMATCH at length %u\n", length);
+            allMatch = false;
+        }
+    }
+    Serial.println(allMatch ? "CRC variants agree" : "CRC variants DISAGREE");
+
+    Serial.println("ModBee CRC-16 benchmark (cycles per byte)");
+    Serial.println(" bytes |  bitwise |    table |   slice4");
+
+    const uint16_t lengths[] = {7, 10, 32, 64, 128, 256, 512};
+    for (uint16_t length : lengths) {
+        Serial.printf("%6u | %8.2f | %8.2f | %8.2f\n", length,
+            benchVariant(ModBeeCRC::calculateBitwise, length),
+            benchVariant(ModBeeCRC::calculateTable, length),
+            benchVariant(ModBeeCRC::calculateSlice4, length));
+    }
+}
+
+void loop() {
+}
@@ -0,0 +1,142 @@
+/**
+ * RX frame parser benchmark.
+ *
+ * Compares the cost per received byte of the old buffer-probing receive path
+ * (re-running ModBeeFrame::isValidFrame over a growing buffer on every poll)
+ * against the incremental ModBeeFrameParser state machine.
+ *
+ * Frames of several sizes are built in both the legacy and v2 formats and fed
+ * in chunks, simulating how many bytes the UART hands over per loop() pass.
+ * Results are printed as CPU cycles per byte (ESP.getCycleCount() on ESP32,
+ * micros() elsewhere).
+ *
+ * No bus hardware is needed; open the serial monitor at 115200 baud.
+ */
+
+#include <ModBeeGlobal.h>
+
+#define SERIAL_BAUD 115200
+#define BENCH_ITERATIONS 50
+
+static uint8_t frameBuffer[MODBEE_MAX_TX_BUFFER] __attribute__((aligned(4)));
+static uint8_t probeBuffer[MODBEE_MAX_RX_BUFFER];
+static uint8_t parserBuffer[MODBEE_MAX_RX_BUFFER];
+
+static inline uint32_t benchNow() {
+#if defined(ESP32)
+    return ESP.getCycleCount();
+#else
+    return micros();
+#endif
+}
+
+// Build a data frame with 'sections' write-multiple-registers sections
+uint16_t buildBenchFrame(uint8_t version, uint8_t sections) {
+    ModBeeAPI::MODBEE_FRAME_VERSION = version;
+    uint16_t pos = ModBeeFrame::writeHeader(frameBuffer, 1, 2, 0, 0);
+
+    for (uint8_t s = 0; s < sections; s++) {
+        frameBuffer[pos++] = MODBEE_PACKET_DELIM;
+        frameBuffer[pos++] = 3;
+        frameBuffer[pos++] = MB_FC_WRITE_MULTIPLE_REGISTERS;
+        frameBuffer[pos++] = 0;
+        frameBuffer[pos++] = s * 8;
+        frameBuffer[pos++] = 0;
+        frameBuffer[pos++] = 8;
+        frameBuffer[pos++] = 16;
+        for (uint8_t i = 0; i < 16; i++) {
+            frameBuffer[pos++] = (uint8_t)(s + i);
+        }
+    }
+
+    return ModBeeFrame::finalizeFrame(frameBuffer, pos);
+}
+
+// Old receive path: append the chunk, then probe every candidate end position
+uint32_t runProbing(uint16_t frameLen, uint16_t chunk) {
+    uint16_t rxPos = 0;
+    uint32_t found = 0;
+
+    for (uint16_t i = 0; i < frameLen; i += chunk) {
+        uint16_t n = min((uint16_t)(frameLen - i), chunk);
+        for (uint16_t k = 0; k < n; k++) {
+            uint8_t byte = frameBuffer[i + k];
+            if (byte == MODBEE_SOF) {
+                rxPos = 0;
+            }
+            probeBuffer[rxPos++] = byte;
+        }
+
+        for (uint16_t testEnd = MODBEE_MIN_FRAME_LEN; testEnd <= rxPos; testEnd++) {
+            if (ModBeeFrame::isValidFrame(probeBuffer, testEnd)) {
+                found++;
+                rxPos = 0;
+                break;
+            }
+        }
+    }
+
+    return found;
+}
+
+// New receive path: one state machine step per byte
+uint32_t runParser(ModBeeFrameParser& parser, uint16_t frameLen) {
+    uint32_t found = 0;
+
+    for (uint16_t i = 0; i < frameLen; i++) {
+        if (parser.feed(frameBuffer[i]) == ModBeeFrameParser::RX_FRAME_COMPLETE) {
+            found++;
+        }
+    }
+
+    return found;
+}
+
+void benchmark(uint8_t version, uint8_t sections, uint16_t chunk) {
+    uint16_t frameLen = buildBenchFrame(version, sections);
+    ModBeeFrameParser parser;
+    parser.attach(parserBuffer, sizeof(parserBuffer));
+
+    uint32_t probeFrames = 0;
+    uint32_t start = benchNow();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        probeFrames += runProbing(frameLen, chunk);
+    }
+    uint32_t probeTicks = benchNow() - start;
+
+    uint32_t parserFrames = 0;
+    start = benchNow();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        parserFrames += runParser(parser, frameLen);
+    }
+    uint32_t parserTicks = benchNow() - start;
+
+    float bytes = (float)frameLen * BENCH_ITERATIONS;
+    Serial.printf("%-6s %4u B  chunk %3u | probing %9.1f/B (%lu ok) | parser %6.1f/B (%lu ok)\n",
+        version == MODBEE_FRAME_VERSION_2 ? "v2" : "legacy", frameLen, chunk,
+        probeTicks / bytes, (unsigned long)probeFrames,
+        parserTicks / bytes, (unsigned long)parserFrames);
+}
+
+void setup() {
+    Serial.begin(SERIAL_BAUD);
+    delay(2000);
+
+    Serial.println("ModBee RX parser benchmark (cycles per byte)");
+
+    const uint8_t sectionCounts[] = {0, 2, 8, 20};
+    const uint16_t chunks[] = {1, 16, 64};
+
+    for (uint8_t version = MODBEE_FRAME_VERSION_LEGACY; version <= MODBEE_FRAME_VERSION_2; version++) {
+        for (uint8_t sections : sectionCounts) {
+            for (uint16_t chunk : chunks) {
+                benchmark(version, sections, chunk);
+            }
+        }
+    }
+
+    ModBeeAPI::MODBEE_FRAME_VERSION = MODBEE_FRAME_VERSION_2;
+}
+
+void loop() {
+}
@@ -4,6 +4,9 @@
 // MODBEE EXAMPLE
 // =============================================================================
 
+// RS485 line speed
+#define MODBEE_BAUD 115200
+
 // Create ModBee API instance
 ModBeeAPI modbee;
 
@@ -86,7 +89,8 @@ void setup() {
     // =============================================================================
     
     // Configure timing parameters (optional but recommended higher values for wireless networks)
-    modbee.MODBEE_INTERFRAME_GAP_US = 5000;       // 5000µs between frames (5ms)
+    modbee.MODBEE_BAUD_RATE = MODBEE_BAUD;        // A plain Stream cannot report its baud rate
+    modbee.MODBEE_INTERFRAME_GAP_US = 0;          // 0 = derive from the baud rate (set e.g. 5000 for a fixed 5ms)
     modbee.BASE_TIMEOUT = 100;                    // 100ms token timeout
     modbee.MODBEE_MAX_RETRIES = 2;                // 2 retry attempts
 
@@ -98,6 +102,7 @@ void setup() {
     // =============================================================================
     
     // Start ModBee protocol with Node ID 1
+    Serial2.begin(MODBEE_BAUD);
     if (!modbee.begin(&Serial2, 1)) {  // Use Serial2 for RS485 communication
         Serial.println("Failed to initialize ModBee protocol!");
         while (1) delay(1000);
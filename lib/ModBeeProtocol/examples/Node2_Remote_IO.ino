@@ -86,6 +86,7 @@ void setup() {
 
     // --- Initialize ModBee Protocol ---
     Serial1.begin(MODBEE_BAUD);
+    modbee.MODBEE_BAUD_RATE = MODBEE_BAUD;  // Timing derives from it; a plain Stream cannot report it
     modbee.begin(&Serial1, NODE_ID);
 
     // --- Bind MY OUTPUT variables to the Modbus Data Map ---
@@ -3,10 +3,11 @@
 // =============================================================================
 // STATIC VARIABLE DEFINITIONS
 // =============================================================================
-unsigned long ModBeeAPI::MODBEE_INTERFRAME_GAP_US        = 5000;   
+unsigned long ModBeeAPI::MODBEE_INTERFRAME_GAP_US        = 0;      // 0 = t3.5 from the baud rate plus measured jitter
+unsigned long ModBeeAPI::MODBEE_BAUD_RATE                = 0;      // 0 = ask the transport
 unsigned long ModBeeAPI::MODBEE_OPERATION_TIMEOUT_MS     = 100;
 unsigned long ModBeeAPI::MODBEE_RESPONSE_TIMEOUT_MS      = 100;
-unsigned long ModBeeAPI::MODBEE_RETRY_DELAY_MS           = 100;
+unsigned long ModBeeAPI::MODBEE_RETRY_DELAY_MS           = 100;   // Unused: a retry goes out in our next data frame
 unsigned long ModBeeAPI::MODBEE_MAX_RETRIES              = 2;
 
 // PROTOCOL TIMING ONLY
@@ -14,16 +15,28 @@ unsigned long ModBeeAPI::INITIAL_LISTEN_PERIOD_MS        = 2000;  // Base initia
 unsigned long ModBeeAPI::TOKEN_RESPONSE_TIMEOUT_MS       = 50;    // Token passing timeout
 unsigned long ModBeeAPI::BASE_TIMEOUT                    = 100;  
 unsigned long ModBeeAPI::NODE_TIMEOUT_MS                 = 50;
+unsigned long ModBeeAPI::MODBEE_TARGET_ROTATION_US       = 0;     // TTRT, 0 = no token-hold budget
 
-unsigned long ModBeeAPI::MODBEE_TOKEN_RECLAIM_TIMEOUT    = 30;    // Token reclaim timeout (ms)
+unsigned long ModBeeAPI::MODBEE_TOKEN_RECLAIM_TIMEOUT    = 30;    // Token reclaim silence per node until the ring is timed (ms)
 unsigned long ModBeeAPI::MODBEE_JOIN_CYCLE_INTERVAL      = 50;    // Join invitation interval (ms)
 unsigned long ModBeeAPI::MODBEE_JOIN_RESPONSE_TIMEOUT    = 20;    // Join response wait time (ms)
+uint8_t ModBeeAPI::MODBEE_JOIN_SLOTS                     = 0;     // Slots per join window while building, 0 = one invitation per node
+uint8_t ModBeeAPI::MODBEE_IDLE_SKIP_ROTATIONS            = 0;     // Rotations an idle node's turn is skipped (needs short tokens), 0 = never
+unsigned long ModBeeAPI::MODBEE_TIME_SYNC_INTERVAL_MS    = 100;   // Time master's time section interval, 0 = no network time
+unsigned long ModBeeAPI::MODBEE_POLL_BYTES_PER_HOLD      = 256;   // Request bytes the polling table queues per token hold, 0 = no limit
 
 int ModBeeAPI::MODBEE_MAX_NODES                          = 10;      // Maximum nodes allowed in network
 bool ModBeeAPI::enableFailSafe                           = false;
 
+// WIRE FORMAT
+uint8_t ModBeeAPI::MODBEE_FRAME_VERSION                  = MODBEE_FRAME_VERSION_2;  // TX format (set to legacy for old firmware)
+bool ModBeeAPI::MODBEE_BYTE_STUFFING                     = true;    // Stuff v2 frames while every known node does
+bool ModBeeAPI::MODBEE_COMPACT_SECTIONS                  = false;   // TLV sections while every known node sends them
+bool ModBeeAPI::MODBEE_TOKEN_SEQUENCE                    = true;    // Sequence tokens while every known node does
+bool ModBeeAPI::MODBEE_SHORT_TOKENS                      = false;   // 5-byte token passes when there is nothing to send
 
-ModBeeAPI::ModBeeAPI() : _protocol(nullptr), _debugHandler(nullptr) {
+
+ModBeeAPI::ModBeeAPI() : _protocol(nullptr), _ownedTransport(nullptr), _debugHandler(nullptr), _operationPriority(MBEE_PRIORITY_LOW) {
     // Constructor - protocol will be created in begin()
 }
 
@@ -44,6 +57,29 @@ bool ModBeeAPI::begin(Stream* serial, uint8_t nodeID) {
         return false; // Invalid stream
     }
     
+    // Wrap the stream in a transport owned by this instance
+    _ownedTransport = createSerialTransport(serial);
+    if (!_ownedTransport) {
+        return false; // Memory allocation failed
+    }
+    
+    if (!begin(_ownedTransport, nodeID)) {
+        delete _ownedTransport;
+        _ownedTransport = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ModBeeAPI::begin(ModBeeTransport* transport, uint8_t nodeID) {
+    if (_protocol) {
+        return false; // Already initialized
+    }
+    
+    if (!transport || !transport->begin()) {
+        return false; // Invalid or unusable transport
+    }
+    
     // Create protocol instance
     _protocol = new ModBeeProtocol();
     if (!_protocol) {
@@ -51,20 +87,31 @@ bool ModBeeAPI::begin(Stream* serial, uint8_t nodeID) {
     }
     
     // Initialize protocol
-    _protocol->begin(nodeID, serial);
+    _protocol->begin(nodeID, transport);
     return true;
 }
 
 void ModBeeAPI::loop() {
     if (_protocol) {
         _protocol->loop();
+        servicePolls();
     }
 }
 
 void ModBeeAPI::end() {
     if (_protocol) {
-        delete _protocol;
+        // Requests still waiting are cancelled while the protocol is intact. It is
+        // detached first, so a callback that starts another request is refused
+        ModBeeProtocol* protocol = _protocol;
         _protocol = nullptr;
+        protocol->getOperations().clearPendingOperations();
+        protocol->getOperations().dispatchCompletions();
+        delete protocol;
+    }
+    _pollTable.clear();
+    if (_ownedTransport) {
+        delete _ownedTransport;
+        _ownedTransport = nullptr;
     }
 }
 
@@ -226,27 +273,230 @@ bool ModBeeAPI::removeIreg(uint16_t address) {
 // =============================================================================
 
 bool ModBeeAPI::readHreg(uint8_t nodeID, uint16_t offset, int16_t& value, uint8_t fc) {
-    return readHreg_impl(nodeID, offset, &value, 1, fc);
+    return readHreg_impl(nodeID, offset, &value, 1, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::readCoil(uint8_t nodeID, uint16_t offset, bool& value, uint8_t fc) {
-    return readCoil_impl(nodeID, offset, &value, 1, fc);
+    return readCoil_impl(nodeID, offset, &value, 1, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::readIreg(uint8_t nodeID, uint16_t offset, int16_t& value, uint8_t fc) {
-    return readIreg_impl(nodeID, offset, &value, 1, fc);
+    return readIreg_impl(nodeID, offset, &value, 1, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::readIsts(uint8_t nodeID, uint16_t offset, bool& value, uint8_t fc) {
-    return readIsts_impl(nodeID, offset, &value, 1, fc);
+    return readIsts_impl(nodeID, offset, &value, 1, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::writeHreg(uint8_t nodeID, uint16_t offset, int16_t value, uint8_t fc) {
-    return writeHreg_impl(nodeID, offset, &value, 1, fc);
+    // value lives on this stack frame: send a copy, not a pointer to it
+    return writeHreg_impl(nodeID, offset, &value, 1, fc, true) != MBEE_REQUEST_FAILED;
 }
 
 bool ModBeeAPI::writeCoil(uint8_t nodeID, uint16_t offset, bool value, uint8_t fc) {
-    return writeCoil_impl(nodeID, offset, &value, 1, fc);
+    return writeCoil_impl(nodeID, offset, &value, 1, fc, true) != MBEE_REQUEST_FAILED;
+}
+
+// =============================================================================
+// MULTICAST WRITES
+// =============================================================================
+
+bool ModBeeAPI::writeHregGroup(uint8_t group, uint16_t offset, int16_t value, uint8_t fc) {
+    return writeHreg_impl(MODBEE_BROADCAST_ID, offset, &value, 1, fc, true, group) != MBEE_REQUEST_FAILED;
+}
+
+bool ModBeeAPI::writeCoilGroup(uint8_t group, uint16_t offset, bool value, uint8_t fc) {
+    return writeCoil_impl(MODBEE_BROADCAST_ID, offset, &value, 1, fc, true, group) != MBEE_REQUEST_FAILED;
+}
+
+void ModBeeAPI::joinGroup(uint8_t group) {
+    if (_protocol) {
+        _protocol->joinGroup(group);
+    }
+}
+
+void ModBeeAPI::leaveGroup(uint8_t group) {
+    if (_protocol) {
+        _protocol->leaveGroup(group);
+    }
+}
+
+bool ModBeeAPI::isGroupMember(uint8_t group) {
+    if (_protocol) {
+        return _protocol->isGroupMember(group);
+    }
+    return false;
+}
+
+// =============================================================================
+// NETWORK TIME
+// =============================================================================
+
+uint32_t ModBeeAPI::networkMicros() {
+    if (_protocol) {
+        return _protocol->getNetworkTime().now();
+    }
+    return micros();
+}
+
+bool ModBeeAPI::isTimeSynced() {
+    if (_protocol) {
+        return _protocol->getNetworkTime().isSynced();
+    }
+    return false;
+}
+
+ModBeeTimeStats ModBeeAPI::getTimeStatistics() {
+    if (_protocol) {
+        return _protocol->getNetworkTime().getStatistics();
+    }
+    return ModBeeTimeStats();
+}
+
+bool ModBeeAPI::writeHregAt(uint8_t nodeID, uint16_t offset, int16_t value, uint32_t atNetworkUs) {
+    // Network time 0 is sent as 1: 0 means on arrival
+    return writeHreg_impl(nodeID, offset, &value, 1, 0, true, MODBEE_GROUP_ALL, atNetworkUs ? atNetworkUs : 1) != MBEE_REQUEST_FAILED;
+}
+
+bool ModBeeAPI::writeCoilAt(uint8_t nodeID, uint16_t offset, bool value, uint32_t atNetworkUs) {
+    return writeCoil_impl(nodeID, offset, &value, 1, 0, true, MODBEE_GROUP_ALL, atNetworkUs ? atNetworkUs : 1) != MBEE_REQUEST_FAILED;
+}
+
+bool ModBeeAPI::writeHregGroupAt(uint8_t group, uint16_t offset, int16_t value, uint32_t atNetworkUs) {
+    return writeHreg_impl(MODBEE_BROADCAST_ID, offset, &value, 1, 0, true, group, atNetworkUs ? atNetworkUs : 1) != MBEE_REQUEST_FAILED;
+}
+
+bool ModBeeAPI::writeCoilGroupAt(uint8_t group, uint16_t offset, bool value, uint32_t atNetworkUs) {
+    return writeCoil_impl(MODBEE_BROADCAST_ID, offset, &value, 1, 0, true, group, atNetworkUs ? atNetworkUs : 1) != MBEE_REQUEST_FAILED;
+}
+
+// =============================================================================
+// PUBLISH/SUBSCRIBE
+// =============================================================================
+
+bool ModBeeAPI::publishHreg(uint16_t offset, uint16_t numregs) {
+    return publish_impl(MB_HOLDING_REGISTER, offset, numregs);
+}
+
+bool ModBeeAPI::publishCoil(uint16_t offset, uint16_t numcoils) {
+    return publish_impl(MB_OUTPUT_COIL, offset, numcoils);
+}
+
+bool ModBeeAPI::publishIreg(uint16_t offset, uint16_t numiregs) {
+    return publish_impl(MB_INPUT_REGISTER, offset, numiregs);
+}
+
+bool ModBeeAPI::publishIsts(uint16_t offset, uint16_t numists) {
+    return publish_impl(MB_INPUT_STATUS, offset, numists);
+}
+
+bool ModBeeAPI::unpublish(ModBeeRegisterType type, uint16_t offset) {
+    if (_protocol) {
+        return _protocol->getCyclicData().removePublication(ModBeeCyclicData::getReadFunction(type), offset);
+    }
+    return false;
+}
+
+bool ModBeeAPI::subscribeHreg(uint8_t nodeID, uint16_t offset, int16_t& value) {
+    return subscribe_impl(nodeID, MB_HOLDING_REGISTER, offset, &value, 1);
+}
+
+bool ModBeeAPI::subscribeCoil(uint8_t nodeID, uint16_t offset, bool& value) {
+    return subscribe_impl(nodeID, MB_OUTPUT_COIL, offset, &value, 1);
+}
+
+bool ModBeeAPI::subscribeIreg(uint8_t nodeID, uint16_t offset, int16_t& value) {
+    return subscribe_impl(nodeID, MB_INPUT_REGISTER, offset, &value, 1);
+}
+
+bool ModBeeAPI::subscribeIsts(uint8_t nodeID, uint16_t offset, bool& value) {
+    return subscribe_impl(nodeID, MB_INPUT_STATUS, offset, &value, 1);
+}
+
+bool ModBeeAPI::unsubscribe(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset) {
+    if (_protocol) {
+        return _protocol->getCyclicData().removeSubscription(nodeID, ModBeeCyclicData::getReadFunction(type), offset);
+    }
+    return false;
+}
+
+unsigned long ModBeeAPI::getSubscriptionAge(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset) {
+    if (!_protocol) return ULONG_MAX;
+    
+    const ModBeeSubscription* subscription =
+        _protocol->getCyclicData().findSubscription(nodeID, ModBeeCyclicData::getReadFunction(type), offset);
+    if (!subscription || !subscription->updated) {
+        return ULONG_MAX;
+    }
+    return (uint32_t)(millis() - subscription->lastUpdate);
+}
+
+// =============================================================================
+// POLLING TABLE
+// =============================================================================
+
+bool ModBeeAPI::pollHreg(uint8_t nodeID, uint16_t offset, int16_t& value, unsigned long periodMs) {
+    return poll_impl(nodeID, MB_HOLDING_REGISTER, offset, &value, 1, periodMs);
+}
+
+bool ModBeeAPI::pollCoil(uint8_t nodeID, uint16_t offset, bool& value, unsigned long periodMs) {
+    return poll_impl(nodeID, MB_OUTPUT_COIL, offset, &value, 1, periodMs);
+}
+
+bool ModBeeAPI::pollIreg(uint8_t nodeID, uint16_t offset, int16_t& value, unsigned long periodMs) {
+    return poll_impl(nodeID, MB_INPUT_REGISTER, offset, &value, 1, periodMs);
+}
+
+bool ModBeeAPI::pollIsts(uint8_t nodeID, uint16_t offset, bool& value, unsigned long periodMs) {
+    return poll_impl(nodeID, MB_INPUT_STATUS, offset, &value, 1, periodMs);
+}
+
+bool ModBeeAPI::unpoll(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset) {
+    // A read still out must not land in variables the sketch may now free
+    uint8_t function = ModBeeCyclicData::getReadFunction(type);
+    const ModBeePollPoint* point = _pollTable.findPoint(nodeID, function, offset);
+    if (point && _protocol) {
+        _protocol->getOperations().detachReads(nodeID, function, offset, point->values);
+    }
+    return _pollTable.removePoint(nodeID, function, offset);
+}
+
+ModBeePollStats ModBeeAPI::getPollStatistics() {
+    return _pollTable.getStatistics();
+}
+
+// =============================================================================
+// ASYNC REQUESTS
+// =============================================================================
+
+ModBeeRequest ModBeeAPI::readHregAsync(uint8_t nodeID, uint16_t offset, int16_t& value, ModBeeCompletion onComplete) {
+    ModBeeRequest request(onComplete);
+    return request.start(readHreg_impl(nodeID, offset, &value, 1, 0, request.completion()));
+}
+
+ModBeeRequest ModBeeAPI::readCoilAsync(uint8_t nodeID, uint16_t offset, bool& value, ModBeeCompletion onComplete) {
+    ModBeeRequest request(onComplete);
+    return request.start(readCoil_impl(nodeID, offset, &value, 1, 0, request.completion()));
+}
+
+ModBeeRequest ModBeeAPI::readIregAsync(uint8_t nodeID, uint16_t offset, int16_t& value, ModBeeCompletion onComplete) {
+    ModBeeRequest request(onComplete);
+    return request.start(readIreg_impl(nodeID, offset, &value, 1, 0, request.completion()));
+}
+
+ModBeeRequest ModBeeAPI::readIstsAsync(uint8_t nodeID, uint16_t offset, bool& value, ModBeeCompletion onComplete) {
+    ModBeeRequest request(onComplete);
+    return request.start(readIsts_impl(nodeID, offset, &value, 1, 0, request.completion()));
+}
+
+ModBeeRequest ModBeeAPI::writeHregAsync(uint8_t nodeID, uint16_t offset, int16_t value, ModBeeCompletion onComplete) {
+    ModBeeRequest request(onComplete);
+    return request.start(writeHreg_impl(nodeID, offset, &value, 1, 0, true, MODBEE_GROUP_ALL, 0, request.completion()));
+}
+
+ModBeeRequest ModBeeAPI::writeCoilAsync(uint8_t nodeID, uint16_t offset, bool value, ModBeeCompletion onComplete) {
+    ModBeeRequest request(onComplete);
+    return request.start(writeCoil_impl(nodeID, offset, &value, 1, 0, true, MODBEE_GROUP_ALL, 0, request.completion()));
 }
 
 // =============================================================================
@@ -254,39 +504,39 @@ bool ModBeeAPI::writeCoil(uint8_t nodeID, uint16_t offset, bool value, uint8_t f
 // =============================================================================
 
 bool ModBeeAPI::readHregManual(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numregs, uint8_t fc) {
-    return readHreg_impl(nodeID, offset, values, numregs, fc);
+    return readHreg_impl(nodeID, offset, values, numregs, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::readCoilManual(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numcoils, uint8_t fc) {
-    return readCoil_impl(nodeID, offset, values, numcoils, fc);
+    return readCoil_impl(nodeID, offset, values, numcoils, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::readIregManual(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numiregs, uint8_t fc) {
-    return readIreg_impl(nodeID, offset, values, numiregs, fc);
+    return readIreg_impl(nodeID, offset, values, numiregs, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::readIstsManual(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numists, uint8_t fc) {
-    return readIsts_impl(nodeID, offset, values, numists, fc);
+    return readIsts_impl(nodeID, offset, values, numists, fc) == MBEE_REQUEST_DONE;
 }
 
 bool ModBeeAPI::writeHregManual(uint8_t nodeID, uint16_t offset, const int16_t* values, uint16_t numregs, uint8_t fc) {
-    return writeHreg_impl(nodeID, offset, values, numregs, fc);
+    return writeHreg_impl(nodeID, offset, values, numregs, fc) != MBEE_REQUEST_FAILED;
 }
 
 bool ModBeeAPI::writeCoilManual(uint8_t nodeID, uint16_t offset, const bool* values, uint16_t numcoils, uint8_t fc) {
-    return writeCoil_impl(nodeID, offset, values, numcoils, fc);
+    return writeCoil_impl(nodeID, offset, values, numcoils, fc) != MBEE_REQUEST_FAILED;
 }
 
 // =============================================================================
 // IMPLEMENTATION METHODS - Called by templates and manual functions
 // =============================================================================
 
-bool ModBeeAPI::readHreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numregs, uint8_t fc) {
-    if (!_protocol || !values) return false;
+ModBeeRequestState ModBeeAPI::readHreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numregs, uint8_t fc, ModBeeCompletion onComplete) {
+    if (!_protocol || !values) return MBEE_REQUEST_FAILED;
     
     // Check if target node exists
     if (!isNodeKnown(nodeID)) {
-        return false;
+        return MBEE_REQUEST_FAILED;
     }
     
     if (nodeID == _protocol->getNodeID()) {
@@ -295,24 +545,15 @@ bool ModBeeAPI::readHreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values,
             if (_protocol->getDataMap().hasHreg(offset + i)) {
                 values[i] = _protocol->getDataMap().getHreg(offset + i);
             } else {
-                return false; // Missing register
+                return MBEE_REQUEST_FAILED; // Missing register
             }
         }
-        return true;
+        return MBEE_REQUEST_DONE;
     }
     
     // Remote read - direct response approach
     uint8_t functionCode = (fc != 0) ? fc : MB_FC_READ_HOLDING_REGISTERS;
     
-    // Check for duplicates
-    auto& pendingOps = _protocol->getOperations().getPendingOps();
-    for (const auto& op : pendingOps) {
-        if (op.destNodeID == nodeID && op.req.function == functionCode &&
-            op.req.startAddr == offset && op.req.quantity == numregs) {
-            return false; // Already pending
-        }
-    }
-    
     // Create operation with direct response pointer
     ModbusRequest req;
     req.function = functionCode;
@@ -330,19 +571,24 @@ bool ModBeeAPI::readHreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values,
     op.isArray = (numregs > 1);
     op.arraySize = numregs;
     
-    _protocol->getOperations().addPendingOperation(op, *_protocol);
+    op.priority = _operationPriority;
+    op.onComplete = onComplete;
+    
+    if (!_protocol->getOperations().addPendingOperation(op, *_protocol)) {
+        return MBEE_REQUEST_FAILED;
+    }
     
     MBEE_DEBUG_IO("ADDED: Direct response array operation - Node:%d FC:%02X Addr:%d Qty:%d", 
         nodeID, functionCode, offset, numregs);
-    return false; // Queued, not immediate
+    return MBEE_REQUEST_PENDING; // Queued, not immediate
 }
 
-bool ModBeeAPI::readCoil_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numcoils, uint8_t fc) {
-    if (!_protocol || !values) return false;
+ModBeeRequestState ModBeeAPI::readCoil_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numcoils, uint8_t fc, ModBeeCompletion onComplete) {
+    if (!_protocol || !values) return MBEE_REQUEST_FAILED;
     
     // Check if target node exists
     if (!isNodeKnown(nodeID)) {
-        return false;
+        return MBEE_REQUEST_FAILED;
     }
     
     if (nodeID == _protocol->getNodeID()) {
@@ -351,24 +597,15 @@ bool ModBeeAPI::readCoil_impl(uint8_t nodeID, uint16_t offset, bool* values, uin
             if (_protocol->getDataMap().hasCoil(offset + i)) {
                 values[i] = _protocol->getDataMap().getCoil(offset + i);
             } else {
-                return false; // Missing coil
+                return MBEE_REQUEST_FAILED; // Missing coil
             }
         }
-        return true;
+        return MBEE_REQUEST_DONE;
     }
     
     // Remote read - direct response approach
     uint8_t functionCode = (fc != 0) ? fc : MB_FC_READ_COILS;
     
-    // Check for duplicates
-    auto& pendingOps = _protocol->getOperations().getPendingOps();
-    for (const auto& op : pendingOps) {
-        if (op.destNodeID == nodeID && op.req.function == functionCode &&
-            op.req.startAddr == offset && op.req.quantity == numcoils) {
-            return false; // Already pending
-        }
-    }
-    
     // Create operation with direct response pointer
     ModbusRequest req;
     req.function = functionCode;
@@ -386,19 +623,24 @@ bool ModBeeAPI::readCoil_impl(uint8_t nodeID, uint16_t offset, bool* values, uin
     op.isArray = (numcoils > 1);
     op.arraySize = numcoils;
     
-    _protocol->getOperations().addPendingOperation(op, *_protocol);
+    op.priority = _operationPriority;
+    op.onComplete = onComplete;
+    
+    if (!_protocol->getOperations().addPendingOperation(op, *_protocol)) {
+        return MBEE_REQUEST_FAILED;
+    }
     
     MBEE_DEBUG_IO("ADDED: Direct response array operation - Node:%d FC:%02X Addr:%d Qty:%d", 
         nodeID, functionCode, offset, numcoils);
-    return false; // Queued, not immediate
+    return MBEE_REQUEST_PENDING; // Queued, not immediate
 }
 
-bool ModBeeAPI::readIreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numiregs, uint8_t fc) {
-    if (!_protocol || !values) return false;
+ModBeeRequestState ModBeeAPI::readIreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numiregs, uint8_t fc, ModBeeCompletion onComplete) {
+    if (!_protocol || !values) return MBEE_REQUEST_FAILED;
     
     // Check if target node exists
     if (!isNodeKnown(nodeID)) {
-        return false;
+        return MBEE_REQUEST_FAILED;
     }
     
     if (nodeID == _protocol->getNodeID()) {
@@ -407,24 +649,15 @@ bool ModBeeAPI::readIreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values,
             if (_protocol->getDataMap().hasIreg(offset + i)) {
                 values[i] = _protocol->getDataMap().getIreg(offset + i);
             } else {
-                return false; // Missing register
+                return MBEE_REQUEST_FAILED; // Missing register
             }
         }
-        return true;
+        return MBEE_REQUEST_DONE;
     }
     
     // Remote read - direct response approach
     uint8_t functionCode = (fc != 0) ? fc : MB_FC_READ_INPUT_REGISTERS;
     
-    // Check for duplicates
-    auto& pendingOps = _protocol->getOperations().getPendingOps();
-    for (const auto& op : pendingOps) {
-        if (op.destNodeID == nodeID && op.req.function == functionCode &&
-            op.req.startAddr == offset && op.req.quantity == numiregs) {
-            return false; // Already pending
-        }
-    }
-    
     // Create operation with direct response pointer
     ModbusRequest req;
     req.function = functionCode;
@@ -442,19 +675,24 @@ bool ModBeeAPI::readIreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values,
     op.isArray = (numiregs > 1);
     op.arraySize = numiregs;
     
-    _protocol->getOperations().addPendingOperation(op, *_protocol);
+    op.priority = _operationPriority;
+    op.onComplete = onComplete;
+    
+    if (!_protocol->getOperations().addPendingOperation(op, *_protocol)) {
+        return MBEE_REQUEST_FAILED;
+    }
     
     MBEE_DEBUG_IO("ADDED: Direct response array operation - Node:%d FC:%02X Addr:%d Qty:%d", 
         nodeID, functionCode, offset, numiregs);
-    return false; // Queued, not immediate
+    return MBEE_REQUEST_PENDING; // Queued, not immediate
 }
 
-bool ModBeeAPI::readIsts_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numists, uint8_t fc) {
-    if (!_protocol || !values) return false;
+ModBeeRequestState ModBeeAPI::readIsts_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numists, uint8_t fc, ModBeeCompletion onComplete) {
+    if (!_protocol || !values) return MBEE_REQUEST_FAILED;
     
     // Check if target node exists
     if (!isNodeKnown(nodeID)) {
-        return false;
+        return MBEE_REQUEST_FAILED;
     }
     
     if (nodeID == _protocol->getNodeID()) {
@@ -463,24 +701,15 @@ bool ModBeeAPI::readIsts_impl(uint8_t nodeID, uint16_t offset, bool* values, uin
             if (_protocol->getDataMap().hasIsts(offset + i)) {
                 values[i] = _protocol->getDataMap().getIsts(offset + i);
             } else {
-                return false; // Missing input
+                return MBEE_REQUEST_FAILED; // Missing input
             }
         }
-        return true;
+        return MBEE_REQUEST_DONE;
     }
     
     // Remote read - direct response approach
     uint8_t functionCode = (fc != 0) ? fc : MB_FC_READ_DISCRETE_INPUTS;
     
-    // Check for duplicates
-    auto& pendingOps = _protocol->getOperations().getPendingOps();
-    for (const auto& op : pendingOps) {
-        if (op.destNodeID == nodeID && op.req.function == functionCode &&
-            op.req.startAddr == offset && op.req.quantity == numists) {
-            return false; // Already pending
-        }
-    }
-    
     // Create operation with direct response pointer
     ModbusRequest req;
     req.function = functionCode;
@@ -498,29 +727,37 @@ bool ModBeeAPI::readIsts_impl(uint8_t nodeID, uint16_t offset, bool* values, uin
     op.isArray = (numists > 1);
     op.arraySize = numists;
     
-    _protocol->getOperations().addPendingOperation(op, *_protocol);
+    op.priority = _operationPriority;
+    op.onComplete = onComplete;
+    
+    if (!_protocol->getOperations().addPendingOperation(op, *_protocol)) {
+        return MBEE_REQUEST_FAILED;
+    }
     
     MBEE_DEBUG_IO("ADDED: Direct response array operation - Node:%d FC:%02X Addr:%d Qty:%d", 
         nodeID, functionCode, offset, numists);
-    return false; // Queued, not immediate
+    return MBEE_REQUEST_PENDING; // Queued, not immediate
 }
 
-bool ModBeeAPI::writeHreg_impl(uint8_t nodeID, uint16_t offset, const int16_t* values, uint16_t numregs, uint8_t fc) {
-    if (!_protocol || !values) return false;
+ModBeeRequestState ModBeeAPI::writeHreg_impl(uint8_t nodeID, uint16_t offset, const int16_t* values, uint16_t numregs, uint8_t fc, bool copyValues, uint8_t group, uint32_t applyAtUs, ModBeeCompletion onComplete) {
+    if (!_protocol || !values) return MBEE_REQUEST_FAILED;
     
-    // Check if target node exists
-    if (!isNodeKnown(nodeID)) {
-        return false;
+    // Check if target node exists (MODBEE_BROADCAST_ID: every member of the group)
+    if (nodeID != MODBEE_BROADCAST_ID && !isNodeKnown(nodeID)) {
+        return MBEE_REQUEST_FAILED;
     }
     
-    if (nodeID == _protocol->getNodeID()) {
+    // A scheduled write carries the values it was queued with
+    copyValues = copyValues || applyAtUs != 0;
+    
+    if (nodeID == _protocol->getNodeID() && applyAtUs == 0) {
         // Local write
         for (uint16_t i = 0; i < numregs; i++) {
             if (!_protocol->getDataMap().setHreg(offset + i, values[i])) {
-                return false; // Write failed
+                return MBEE_REQUEST_FAILED; // Write failed
             }
         }
-        return true;
+        return MBEE_REQUEST_DONE;
     }
     
     // Determine function code based on quantity
@@ -540,6 +777,7 @@ bool ModBeeAPI::writeHreg_impl(uint8_t nodeID, uint16_t offset, const int16_t* v
     
     PendingModbusOp op;
     op.destNodeID = nodeID;
+    op.group = group;
     op.sourceNodeID = _protocol->getNodeID();
     op.req = req;
     op.timestamp = millis();
@@ -550,26 +788,57 @@ bool ModBeeAPI::writeHreg_impl(uint8_t nodeID, uint16_t offset, const int16_t* v
     op.isArray = (numregs > 1);
     op.arraySize = numregs;
     
-    _protocol->getOperations().addPendingOperation(op, *_protocol);
-    return true;
+    if (copyValues) {
+        // Pack the values now in the layout the frame builder falls back to
+        if (functionCode != MB_FC_WRITE_SINGLE_REGISTER) {
+            op.req.data.push_back(numregs * 2);
+        }
+        for (uint16_t i = 0; i < numregs; i++) {
+            op.req.data.push_back((values[i] >> 8) & 0xFF);
+            op.req.data.push_back(values[i] & 0xFF);
+        }
+        op.resultPtr = nullptr;
+    }
+    op.req.applyAtUs = applyAtUs;
+    
+    if (nodeID == _protocol->getNodeID()) {
+        // Scheduled local write: held with the received ones, or applied now if it cannot be
+        if (_protocol->getNetworkTime().scheduleWrite(op.req, nodeID)) {
+            return MBEE_REQUEST_DONE;
+        }
+        ModbusHandler handler(_protocol->getDataMap());
+        ModbusRequest response;
+        return handler.processRequest(op.req, response, nodeID) ? MBEE_REQUEST_DONE : MBEE_REQUEST_FAILED;
+    }
+    
+    op.priority = _operationPriority;
+    op.onComplete = onComplete;
+    
+    if (!_protocol->getOperations().addPendingOperation(op, *_protocol)) {
+        return MBEE_REQUEST_FAILED;
+    }
+    return MBEE_REQUEST_PENDING;
 }
 
-bool ModBeeAPI::writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* values, uint16_t numcoils, uint8_t fc) {
-    if (!_protocol || !values) return false;
+ModBeeRequestState ModBeeAPI::writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* values, uint16_t numcoils, uint8_t fc, bool copyValues, uint8_t group, uint32_t applyAtUs, ModBeeCompletion onComplete) {
+    if (!_protocol || !values) return MBEE_REQUEST_FAILED;
     
-    // Check if target node exists
-    if (!isNodeKnown(nodeID)) {
-        return false;
+    // Check if target node exists (MODBEE_BROADCAST_ID: every member of the group)
+    if (nodeID != MODBEE_BROADCAST_ID && !isNodeKnown(nodeID)) {
+        return MBEE_REQUEST_FAILED;
     }
     
-    if (nodeID == _protocol->getNodeID()) {
+    // A scheduled write carries the values it was queued with
+    copyValues = copyValues || applyAtUs != 0;
+    
+    if (nodeID == _protocol->getNodeID() && applyAtUs == 0) {
         // Local write
         for (uint16_t i = 0; i < numcoils; i++) {
             if (!_protocol->getDataMap().setCoil(offset + i, values[i])) {
-                return false; // Write failed
+                return MBEE_REQUEST_FAILED; // Write failed
             }
         }
-        return true;
+        return MBEE_REQUEST_DONE;
     }
     
     // Determine function code based on quantity
@@ -589,6 +858,7 @@ bool ModBeeAPI::writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* valu
     
     PendingModbusOp op;
     op.destNodeID = nodeID;
+    op.group = group;
     op.sourceNodeID = _protocol->getNodeID();
     op.req = req;
     op.timestamp = millis();
@@ -599,8 +869,116 @@ bool ModBeeAPI::writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* valu
     op.isArray = (numcoils > 1);
     op.arraySize = numcoils;
     
-    _protocol->getOperations().addPendingOperation(op, *_protocol);
-    return true;
+    if (copyValues) {
+        // Pack the values now in the layout the frame builder falls back to
+        if (functionCode == MB_FC_WRITE_SINGLE_COIL) {
+            op.req.data.push_back(values[0] ? 0xFF : 0x00);
+            op.req.data.push_back(0x00);
+        } else {
+            uint8_t byteCount = (numcoils + 7) / 8;
+            op.req.data.push_back(byteCount);
+            op.req.data.resize(1 + byteCount, 0);
+            for (uint16_t i = 0; i < numcoils; i++) {
+                if (values[i]) {
+                    op.req.data[1 + i / 8] |= (1 << (i % 8));
+                }
+            }
+        }
+        op.resultPtr = nullptr;
+    }
+    op.req.applyAtUs = applyAtUs;
+    
+    if (nodeID == _protocol->getNodeID()) {
+        // Scheduled local write: held with the received ones, or applied now if it cannot be
+        if (_protocol->getNetworkTime().scheduleWrite(op.req, nodeID)) {
+            return MBEE_REQUEST_DONE;
+        }
+        ModbusHandler handler(_protocol->getDataMap());
+        ModbusRequest response;
+        return handler.processRequest(op.req, response, nodeID) ? MBEE_REQUEST_DONE : MBEE_REQUEST_FAILED;
+    }
+    
+    op.priority = _operationPriority;
+    op.onComplete = onComplete;
+    
+    if (!_protocol->getOperations().addPendingOperation(op, *_protocol)) {
+        return MBEE_REQUEST_FAILED;
+    }
+    return MBEE_REQUEST_PENDING;
+}
+
+bool ModBeeAPI::publish_impl(ModBeeRegisterType type, uint16_t offset, uint16_t count) {
+    if (!_protocol) return false;
+    
+    // Every address must be bound already, or the range would never go out
+    ModbusRequest request;
+    request.function = ModBeeCyclicData::getReadFunction(type);
+    request.startAddr = offset;
+    request.quantity = count;
+    
+    ModbusHandler handler(_protocol->getDataMap());
+    ModbusRequest response;
+    handler.processRequest(request, response, _protocol->getNodeID());
+    if (response.function & 0x80) {
+        return false;
+    }
+    
+    return _protocol->getCyclicData().addPublication(request.function, offset, count);
+}
+
+bool ModBeeAPI::subscribe_impl(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset, void* values, uint16_t count) {
+    if (!_protocol || !values) return false;
+    
+    // The publisher need not be in the ring yet: values arrive once it is
+    if (nodeID == _protocol->getNodeID()) {
+        return false;
+    }
+    
+    return _protocol->getCyclicData().addSubscription(nodeID, ModBeeCyclicData::getReadFunction(type), offset, count, values);
+}
+
+bool ModBeeAPI::poll_impl(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset, void* values, uint16_t count, unsigned long periodMs) {
+    // Our own data map needs no polling, and like a subscription the node need not be in the ring yet
+    if (_protocol && nodeID == _protocol->getNodeID()) {
+        return false;
+    }
+    
+    // Rebinding a point lets go of the old variables, as unpoll() does
+    uint8_t function = ModBeeCyclicData::getReadFunction(type);
+    const ModBeePollPoint* point = _pollTable.findPoint(nodeID, function, offset);
+    if (point && point->values != values && _protocol) {
+        _protocol->getOperations().detachReads(nodeID, function, offset, point->values);
+    }
+    return _pollTable.addPoint(nodeID, function, offset, count, values, periodMs, _operationPriority);
+}
+
+void ModBeeAPI::servicePolls() {
+    if (_pollTable.empty()) return;
+    
+    ModBeeOperations& operations = _protocol->getOperations();
+    _pollTable.service(millis(), _protocol->getTokenHoldCount(), !operations.hasPendingOperations(),
+                       [this](const ModBeePollPoint& point, ModBeeCompletion onComplete) {
+        // Each point keeps the priority it was added with
+        ModBeePriority priority = _operationPriority;
+        _operationPriority = point.priority;
+        ModBeeRequestState state = MBEE_REQUEST_FAILED;
+        switch (point.function) {
+            case MB_FC_READ_HOLDING_REGISTERS:
+                state = readHreg_impl(point.nodeID, point.startAddr, (int16_t*)point.values, point.quantity, 0, onComplete);
+                break;
+            case MB_FC_READ_COILS:
+                state = readCoil_impl(point.nodeID, point.startAddr, (bool*)point.values, point.quantity, 0, onComplete);
+                break;
+            case MB_FC_READ_INPUT_REGISTERS:
+                state = readIreg_impl(point.nodeID, point.startAddr, (int16_t*)point.values, point.quantity, 0, onComplete);
+                break;
+            case MB_FC_READ_DISCRETE_INPUTS:
+                state = readIsts_impl(point.nodeID, point.startAddr, (bool*)point.values, point.quantity, 0, onComplete);
+                break;
+        }
+        _operationPriority = priority;
+        return state;
+    });
 }
 
 // =============================================================================
@@ -609,7 +987,8 @@ bool ModBeeAPI::writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* valu
 
 uint16_t ModBeeAPI::getPendingOpCount() {
     if (_protocol) {
-        return _protocol->getOperations().getPendingOpCount();
+        // Queued operations plus reads sent and still awaiting their response
+        return _protocol->getOperations().getPendingOpCount() + _protocol->getOperations().getTransactionCount();
     }
     return 0;
 }
@@ -620,6 +999,10 @@ void ModBeeAPI::clearPendingOps() {
     }
 }
 
+void ModBeeAPI::setOperationPriority(ModBeePriority priority) {
+    _operationPriority = priority;
+}
+
 void ModBeeAPI::getStatistics(uint16_t& pendingOps, uint16_t& completedOps) {
     if (_protocol) {
         pendingOps = _protocol->getOperations().getPendingOpCount();
@@ -630,6 +1013,28 @@ void ModBeeAPI::getStatistics(uint16_t& pendingOps, uint16_t& completedOps) {
     }
 }
 
+ModBeeIOStats ModBeeAPI::getBusStatistics() {
+    if (_protocol) {
+        return _protocol->getIO().getStatistics();
+    }
+    return ModBeeIOStats();
+}
+
+OperationStats ModBeeAPI::getOperationStatistics() {
+    OperationStats stats = OperationStats();
+    if (_protocol) {
+        _protocol->getOperations().getStatistics(stats);
+    }
+    return stats;
+}
+
+ModBeeTokenStats ModBeeAPI::getTokenStatistics() {
+    if (_protocol) {
+        return _protocol->getTokenStatistics();
+    }
+    return ModBeeTokenStats();
+}
+
 // =============================================================================
 // CALLBACK REGISTRATION FUNCTIONS
 // =============================================================================
@@ -14,6 +14,7 @@ public:
     // High Level Variables - Static but modifiable
     // =============================================================================
     static unsigned long MODBEE_INTERFRAME_GAP_US;
+    static unsigned long MODBEE_BAUD_RATE;
     static unsigned long MODBEE_OPERATION_TIMEOUT_MS;
     static unsigned long MODBEE_RESPONSE_TIMEOUT_MS;
     static unsigned long MODBEE_READ_TIMEOUT_MS;
@@ -25,19 +26,32 @@ public:
     static unsigned long TOKEN_RESPONSE_TIMEOUT_MS;
     static unsigned long BASE_TIMEOUT;
     static unsigned long NODE_TIMEOUT_MS;
+    static unsigned long MODBEE_TARGET_ROTATION_US;
 
     static unsigned long MODBEE_TOKEN_RECLAIM_TIMEOUT;
     static unsigned long MODBEE_JOIN_CYCLE_INTERVAL;
     static unsigned long MODBEE_JOIN_RESPONSE_TIMEOUT;
+    static uint8_t MODBEE_JOIN_SLOTS;
+    static uint8_t MODBEE_IDLE_SKIP_ROTATIONS;
+    static unsigned long MODBEE_TIME_SYNC_INTERVAL_MS;
+    static unsigned long MODBEE_POLL_BYTES_PER_HOLD;
 
     static int MODBEE_MAX_NODES; 
     static bool enableFailSafe;
 
+    // WIRE FORMAT
+    static uint8_t MODBEE_FRAME_VERSION;
+    static bool MODBEE_BYTE_STUFFING;
+    static bool MODBEE_COMPACT_SECTIONS;
+    static bool MODBEE_TOKEN_SEQUENCE;
+    static bool MODBEE_SHORT_TOKENS;
+
     // =============================================================================
     // PROTOCOL MANAGEMENT
     // =============================================================================
     
     bool begin(Stream* serial, uint8_t nodeID = 1);
+    bool begin(ModBeeTransport* transport, uint8_t nodeID = 1);
     void loop();
     void end();
     bool isInitialized();
@@ -83,33 +97,33 @@ public:
     // AUTO-SIZING Read functions (template-based for fixed arrays)
     template<size_t N>
     bool readHreg(uint8_t nodeID, uint16_t offset, int16_t (&values)[N], uint8_t fc = 0) {
-        return readHreg_impl(nodeID, offset, values, N, fc);
+        return readHreg_impl(nodeID, offset, values, N, fc) == MBEE_REQUEST_DONE;
     }
     
     template<size_t N>
     bool readCoil(uint8_t nodeID, uint16_t offset, bool (&values)[N], uint8_t fc = 0) {
-        return readCoil_impl(nodeID, offset, values, N, fc);
+        return readCoil_impl(nodeID, offset, values, N, fc) == MBEE_REQUEST_DONE;
     }
     
     template<size_t N>
     bool readIreg(uint8_t nodeID, uint16_t offset, int16_t (&values)[N], uint8_t fc = 0) {
-        return readIreg_impl(nodeID, offset, values, N, fc);
+        return readIreg_impl(nodeID, offset, values, N, fc) == MBEE_REQUEST_DONE;
     }
     
     template<size_t N>
     bool readIsts(uint8_t nodeID, uint16_t offset, bool (&values)[N], uint8_t fc = 0) {
-        return readIsts_impl(nodeID, offset, values, N, fc);
+        return readIsts_impl(nodeID, offset, values, N, fc) == MBEE_REQUEST_DONE;
     }
     
     // AUTO-SIZING Write functions (template-based for fixed arrays)
     template<size_t N>
     bool writeHreg(uint8_t nodeID, uint16_t offset, const int16_t (&values)[N], uint8_t fc = 0) {
-        return writeHreg_impl(nodeID, offset, values, N, fc);
+        return writeHreg_impl(nodeID, offset, values, N, fc) != MBEE_REQUEST_FAILED;
     }
     
     template<size_t N>
     bool writeCoil(uint8_t nodeID, uint16_t offset, const bool (&values)[N], uint8_t fc = 0) {
-        return writeCoil_impl(nodeID, offset, values, N, fc);
+        return writeCoil_impl(nodeID, offset, values, N, fc) != MBEE_REQUEST_FAILED;
     }
     
     // =============================================================================
@@ -140,6 +154,170 @@ public:
     bool writeHreg(uint8_t nodeID, uint16_t offset, int16_t value, uint8_t fc = 0);
     bool writeCoil(uint8_t nodeID, uint16_t offset, bool value, uint8_t fc = 0);
     
+    // =============================================================================
+    // ASYNC REQUESTS - A handle that reports completion, exception or timeout
+    // =============================================================================
+    
+    // The variable is written before the callback runs; callbacks run from loop()
+    template<size_t N>
+    ModBeeRequest readHregAsync(uint8_t nodeID, uint16_t offset, int16_t (&values)[N], ModBeeCompletion onComplete = nullptr) {
+        ModBeeRequest request(onComplete);
+        return request.start(readHreg_impl(nodeID, offset, values, N, 0, request.completion()));
+    }
+    
+    template<size_t N>
+    ModBeeRequest readCoilAsync(uint8_t nodeID, uint16_t offset, bool (&values)[N], ModBeeCompletion onComplete = nullptr) {
+        ModBeeRequest request(onComplete);
+        return request.start(readCoil_impl(nodeID, offset, values, N, 0, request.completion()));
+    }
+    
+    template<size_t N>
+    ModBeeRequest readIregAsync(uint8_t nodeID, uint16_t offset, int16_t (&values)[N], ModBeeCompletion onComplete = nullptr) {
+        ModBeeRequest request(onComplete);
+        return request.start(readIreg_impl(nodeID, offset, values, N, 0, request.completion()));
+    }
+    
+    template<size_t N>
+    ModBeeRequest readIstsAsync(uint8_t nodeID, uint16_t offset, bool (&values)[N], ModBeeCompletion onComplete = nullptr) {
+        ModBeeRequest request(onComplete);
+        return request.start(readIsts_impl(nodeID, offset, values, N, 0, request.completion()));
+    }
+    
+    ModBeeRequest readHregAsync(uint8_t nodeID, uint16_t offset, int16_t& value, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequest readCoilAsync(uint8_t nodeID, uint16_t offset, bool& value, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequest readIregAsync(uint8_t nodeID, uint16_t offset, int16_t& value, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequest readIstsAsync(uint8_t nodeID, uint16_t offset, bool& value, ModBeeCompletion onComplete = nullptr);
+    
+    // Writes are not answered: they are done once sent. Arrays are read at send time
+    // like writeHreg(), single values are copied
+    template<size_t N>
+    ModBeeRequest writeHregAsync(uint8_t nodeID, uint16_t offset, const int16_t (&values)[N], ModBeeCompletion onComplete = nullptr) {
+        ModBeeRequest request(onComplete);
+        return request.start(writeHreg_impl(nodeID, offset, values, N, 0, false, MODBEE_GROUP_ALL, 0, request.completion()));
+    }
+    
+    template<size_t N>
+    ModBeeRequest writeCoilAsync(uint8_t nodeID, uint16_t offset, const bool (&values)[N], ModBeeCompletion onComplete = nullptr) {
+        ModBeeRequest request(onComplete);
+        return request.start(writeCoil_impl(nodeID, offset, values, N, 0, false, MODBEE_GROUP_ALL, 0, request.completion()));
+    }
+    
+    ModBeeRequest writeHregAsync(uint8_t nodeID, uint16_t offset, int16_t value, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequest writeCoilAsync(uint8_t nodeID, uint16_t offset, bool value, ModBeeCompletion onComplete = nullptr);
+    
+    // =============================================================================
+    // MULTICAST WRITES - One section, applied by every member of the group
+    // =============================================================================
+    
+    // MODBEE_GROUP_ALL reaches every node, like writing to node MODBEE_BROADCAST_ID
+    template<size_t N>
+    bool writeHregGroup(uint8_t group, uint16_t offset, const int16_t (&values)[N], uint8_t fc = 0) {
+        return writeHreg_impl(MODBEE_BROADCAST_ID, offset, values, N, fc, false, group) != MBEE_REQUEST_FAILED;
+    }
+    
+    template<size_t N>
+    bool writeCoilGroup(uint8_t group, uint16_t offset, const bool (&values)[N], uint8_t fc = 0) {
+        return writeCoil_impl(MODBEE_BROADCAST_ID, offset, values, N, fc, false, group) != MBEE_REQUEST_FAILED;
+    }
+    
+    bool writeHregGroup(uint8_t group, uint16_t offset, int16_t value, uint8_t fc = 0);
+    bool writeCoilGroup(uint8_t group, uint16_t offset, bool value, uint8_t fc = 0);
+    
+    // =============================================================================
+    // NETWORK TIME - The time master's clock, shared by every node in the ring
+    // =============================================================================
+    
+    // Microseconds on the network time base, wraps like micros()
+    uint32_t networkMicros();
+    bool isTimeSynced();
+    ModBeeTimeStats getTimeStatistics();
+    
+    // Writes applied when the network time reaches atNetworkUs, on every target at once
+    // (values are copied when queued; a time already past applies on arrival)
+    bool writeHregAt(uint8_t nodeID, uint16_t offset, int16_t value, uint32_t atNetworkUs);
+    bool writeCoilAt(uint8_t nodeID, uint16_t offset, bool value, uint32_t atNetworkUs);
+    bool writeHregGroupAt(uint8_t group, uint16_t offset, int16_t value, uint32_t atNetworkUs);
+    bool writeCoilGroupAt(uint8_t group, uint16_t offset, bool value, uint32_t atNetworkUs);
+    
+    // Group membership (every node is in MODBEE_GROUP_ALL)
+    void joinGroup(uint8_t group);
+    void leaveGroup(uint8_t group);
+    bool isGroupMember(uint8_t group);
+    
+    // =============================================================================
+    // PUBLISH/SUBSCRIBE - Cyclic data carried by every data frame
+    // =============================================================================
+    
+    // Publish a local data map range: it goes out in every data frame this node sends
+    bool publishHreg(uint16_t offset, uint16_t numregs = 1);
+    bool publishCoil(uint16_t offset, uint16_t numcoils = 1);
+    bool publishIreg(uint16_t offset, uint16_t numiregs = 1);
+    bool publishIsts(uint16_t offset, uint16_t numists = 1);
+    bool unpublish(ModBeeRegisterType type, uint16_t offset);
+    
+    // Subscribe to a range nodeID publishes: the variables update in place as its frames pass
+    template<size_t N>
+    bool subscribeHreg(uint8_t nodeID, uint16_t offset, int16_t (&values)[N]) {
+        return subscribe_impl(nodeID, MB_HOLDING_REGISTER, offset, values, N);
+    }
+    
+    template<size_t N>
+    bool subscribeCoil(uint8_t nodeID, uint16_t offset, bool (&values)[N]) {
+        return subscribe_impl(nodeID, MB_OUTPUT_COIL, offset, values, N);
+    }
+    
+    template<size_t N>
+    bool subscribeIreg(uint8_t nodeID, uint16_t offset, int16_t (&values)[N]) {
+        return subscribe_impl(nodeID, MB_INPUT_REGISTER, offset, values, N);
+    }
+    
+    template<size_t N>
+    bool subscribeIsts(uint8_t nodeID, uint16_t offset, bool (&values)[N]) {
+        return subscribe_impl(nodeID, MB_INPUT_STATUS, offset, values, N);
+    }
+    
+    bool subscribeHreg(uint8_t nodeID, uint16_t offset, int16_t& value);
+    bool subscribeCoil(uint8_t nodeID, uint16_t offset, bool& value);
+    bool subscribeIreg(uint8_t nodeID, uint16_t offset, int16_t& value);
+    bool subscribeIsts(uint8_t nodeID, uint16_t offset, bool& value);
+    bool unsubscribe(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset);
+    
+    // Milliseconds since a subscription was last updated, ULONG_MAX until its first update
+    unsigned long getSubscriptionAge(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset);
+    
+    // =============================================================================
+    // POLLING TABLE - Remote ranges read every period, batched per token hold
+    // =============================================================================
+    
+    // The variables update in place as responses arrive; a point is read at most once
+    // per period and never twice at once (see MODBEE_POLL_BYTES_PER_HOLD)
+    template<size_t N>
+    bool pollHreg(uint8_t nodeID, uint16_t offset, int16_t (&values)[N], unsigned long periodMs) {
+        return poll_impl(nodeID, MB_HOLDING_REGISTER, offset, values, N, periodMs);
+    }
+    
+    template<size_t N>
+    bool pollCoil(uint8_t nodeID, uint16_t offset, bool (&values)[N], unsigned long periodMs) {
+        return poll_impl(nodeID, MB_OUTPUT_COIL, offset, values, N, periodMs);
+    }
+    
+    template<size_t N>
+    bool pollIreg(uint8_t nodeID, uint16_t offset, int16_t (&values)[N], unsigned long periodMs) {
+        return poll_impl(nodeID, MB_INPUT_REGISTER, offset, values, N, periodMs);
+    }
+    
+    template<size_t N>
+    bool pollIsts(uint8_t nodeID, uint16_t offset, bool (&values)[N], unsigned long periodMs) {
+        return poll_impl(nodeID, MB_INPUT_STATUS, offset, values, N, periodMs);
+    }
+    
+    bool pollHreg(uint8_t nodeID, uint16_t offset, int16_t& value, unsigned long periodMs);
+    bool pollCoil(uint8_t nodeID, uint16_t offset, bool& value, unsigned long periodMs);
+    bool pollIreg(uint8_t nodeID, uint16_t offset, int16_t& value, unsigned long periodMs);
+    bool pollIsts(uint8_t nodeID, uint16_t offset, bool& value, unsigned long periodMs);
+    bool unpoll(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset);
+    ModBeePollStats getPollStatistics();
+    
     // =============================================================================
     // UTILITY AND STATUS FUNCTIONS
     // =============================================================================
@@ -148,8 +326,14 @@ public:
     uint16_t getPendingOpCount();
     void clearPendingOps();
     
+    // Priority of the reads and writes queued after this call (see MODBEE_TARGET_ROTATION_US)
+    void setOperationPriority(ModBeePriority priority);
+    
     // Statistics
     void getStatistics(uint16_t& pendingOps, uint16_t& completedOps);
+    ModBeeIOStats getBusStatistics();
+    OperationStats getOperationStatistics();
+    ModBeeTokenStats getTokenStatistics();
     
     // Error handling
     void onError(void (*errorHandler)(ModBeeError error, const char* message));
@@ -158,13 +342,21 @@ public:
 private:
     // Direct protocol instance
     ModBeeProtocol* _protocol;
+    ModBeeTransport* _ownedTransport;   // Created by begin(Stream*), deleted by end()
     void (*_debugHandler)(const char* category, const char* message);
+    ModBeePriority _operationPriority;  // Applied to every operation queued from now on
+    ModBeePollTable _pollTable;         // Periodic reads, serviced after every protocol loop
 
     // Implementation methods for templates
-    bool readHreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numregs, uint8_t fc);
-    bool readCoil_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numcoils, uint8_t fc);
-    bool readIreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numiregs, uint8_t fc);
-    bool readIsts_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numists, uint8_t fc);
-    bool writeHreg_impl(uint8_t nodeID, uint16_t offset, const int16_t* values, uint16_t numregs, uint8_t fc);
-    bool writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* values, uint16_t numcoils, uint8_t fc);
+    // DONE when completed locally, PENDING when queued, FAILED otherwise
+    ModBeeRequestState readHreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numregs, uint8_t fc, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequestState readCoil_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numcoils, uint8_t fc, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequestState readIreg_impl(uint8_t nodeID, uint16_t offset, int16_t* values, uint16_t numiregs, uint8_t fc, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequestState readIsts_impl(uint8_t nodeID, uint16_t offset, bool* values, uint16_t numists, uint8_t fc, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequestState writeHreg_impl(uint8_t nodeID, uint16_t offset, const int16_t* values, uint16_t numregs, uint8_t fc, bool copyValues = false, uint8_t group = MODBEE_GROUP_ALL, uint32_t applyAtUs = 0, ModBeeCompletion onComplete = nullptr);
+    ModBeeRequestState writeCoil_impl(uint8_t nodeID, uint16_t offset, const bool* values, uint16_t numcoils, uint8_t fc, bool copyValues = false, uint8_t group = MODBEE_GROUP_ALL, uint32_t applyAtUs = 0, ModBeeCompletion onComplete = nullptr);
+    bool publish_impl(ModBeeRegisterType type, uint16_t offset, uint16_t count);
+    bool subscribe_impl(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset, void* values, uint16_t count);
+    bool poll_impl(uint8_t nodeID, ModBeeRegisterType type, uint16_t offset, void* values, uint16_t count, unsigned long periodMs);
+    void servicePolls();
 };
\ No newline at end of file
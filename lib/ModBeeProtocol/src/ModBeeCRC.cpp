@@ -0,0 +1,130 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// COMPILE-TIME TABLE GENERATION
+// =============================================================================
+namespace {
+
+// Single-expression constexpr helpers so the tables build under C++11
+constexpr uint16_t crcShift(uint16_t crc, uint8_t bits) {
+    return bits == 0 ? crc : crcShift((crc & 0x0001) ? (crc >> 1) ^ MODBEE_CRC_POLY : (crc >> 1), bits - 1);
+}
+
+constexpr uint16_t crcT0(uint16_t i) {
+    return crcShift(i, 8);
+}
+
+constexpr uint16_t crcT1(uint16_t i) {
+    return (crcT0(i) >> 8) ^ crcT0(crcT0(i) & 0xFF);
+}
+
+constexpr uint16_t crcT2(uint16_t i) {
+    return (crcT1(i) >> 8) ^ crcT0(crcT1(i) & 0xFF);
+}
+
+constexpr uint16_t crcT3(uint16_t i) {
+    return (crcT2(i) >> 8) ^ crcT0(crcT2(i) & 0xFF);
+}
+
+} // namespace
+
+#define MODBEE_CRC_ROW4(f, n)    f(n), f(n + 1), f(n + 2), f(n + 3)
+#define MODBEE_CRC_ROW16(f, n)   MODBEE_CRC_ROW4(f, n), MODBEE_CRC_ROW4(f, n + 4), MODBEE_CRC_ROW4(f, n + 8), MODBEE_CRC_ROW4(f, n + 12)
+#define MODBEE_CRC_ROW64(f, n)   MODBEE_CRC_ROW16(f, n), MODBEE_CRC_ROW16(f, n + 16), MODBEE_CRC_ROW16(f, n + 32), MODBEE_CRC_ROW16(f, n + 48)
+#define MODBEE_CRC_ROW256(f)     MODBEE_CRC_ROW64(f, 0), MODBEE_CRC_ROW64(f, 64), MODBEE_CRC_ROW64(f, 128), MODBEE_CRC_ROW64(f, 192)
+
+MODBEE_CRC_TABLE_ATTR const uint16_t ModBeeCRC::_table[4][256] = {
+    { MODBEE_CRC_ROW256(crcT0) },
+    { MODBEE_CRC_ROW256(crcT1) },
+    { MODBEE_CRC_ROW256(crcT2) },
+    { MODBEE_CRC_ROW256(crcT3) }
+};
+
+// =============================================================================
+// WHOLE BUFFER API
+// =============================================================================
+uint16_t ModBeeCRC::calculate(const uint8_t* buffer, uint16_t length, uint16_t crc) {
+#if MODBEE_CRC_SLICE_BY_4
+    return calculateSlice4(buffer, length, crc);
+#else
+    return calculateTable(buffer, length, crc);
+#endif
+}
+
+// =============================================================================
+// INDIVIDUAL VARIANTS
+// =============================================================================
+uint16_t ModBeeCRC::calculateBitwise(const uint8_t* buffer, uint16_t length, uint16_t crc) {
+    if (!buffer) {
+        return crc;
+    }
+
+    for (uint16_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)buffer[i];
+
+        for (uint8_t j = 0; j < 8; j++) {
+            if (crc & 0x0001) {
+                crc = (crc >> 1) ^ MODBEE_CRC_POLY;
+            } else {
+                crc = crc >> 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+uint16_t ModBeeCRC::calculateTable(const uint8_t* buffer, uint16_t length, uint16_t crc) {
+    if (!buffer) {
+        return crc;
+    }
+
+    for (uint16_t i = 0; i < length; i++) {
+        crc = update(crc, buffer[i]);
+    }
+
+    return crc;
+}
+
+uint16_t ModBeeCRC::calculateSlice4(const uint8_t* buffer, uint16_t length, uint16_t crc) {
+    if (!buffer) {
+        return crc;
+    }
+
+    // Four bytes per step: the two CRC bytes fold into the first two data bytes
+    while (length >= 4) {
+        uint8_t b0 = buffer[0] ^ (uint8_t)crc;
+        uint8_t b1 = buffer[1] ^ (uint8_t)(crc >> 8);
+
+        crc = _table[3][b0] ^ _table[2][b1] ^ _table[1][buffer[2]] ^ _table[0][buffer[3]];
+
+        buffer += 4;
+        length -= 4;
+    }
+
+    // Tail bytes
+    while (length--) {
+        crc = update(crc, *buffer++);
+    }
+
+    return crc;
+}
+
+// =============================================================================
+// CRC-8 (SHORT TOKEN CHECK)
+// =============================================================================
+uint8_t ModBeeCRC::calculate8(const uint8_t* buffer, uint16_t length, uint8_t crc) {
+    if (!buffer) {
+        return crc;
+    }
+
+    // Only ever a few bytes: bitwise, no table in DRAM
+    while (length--) {
+        crc ^= *buffer++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ MODBEE_CRC8_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
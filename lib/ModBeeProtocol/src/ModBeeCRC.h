@@ -0,0 +1,60 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// CRC CONFIGURATION
+// =============================================================================
+
+// Use slice-by-4 for whole-buffer CRCs (set to 0 to use the single table loop)
+#ifndef MODBEE_CRC_SLICE_BY_4
+#define MODBEE_CRC_SLICE_BY_4    1
+#endif
+
+// Keep lookup tables in internal RAM on ESP32 (no flash cache misses, ISR safe)
+#if defined(ESP32) && defined(DRAM_ATTR)
+#define MODBEE_CRC_TABLE_ATTR    DRAM_ATTR
+#else
+#define MODBEE_CRC_TABLE_ATTR
+#endif
+
+#define MODBEE_CRC_INIT          0xFFFF  // Modbus CRC-16 initial value
+#define MODBEE_CRC_POLY          0xA001  // Modbus CRC-16 polynomial (reflected 0x8005)
+#define MODBEE_CRC8_INIT         0xFF    // Short token check initial value
+#define MODBEE_CRC8_POLY         0x2F    // CRC-8/AUTOSAR, Hamming distance 4 up to 119 data bits
+
+/**
+ * Modbus CRC-16 engine shared by ModBeeFrame and ModbusFrame
+ * Lookup tables are generated at compile time. update() folds one byte into a
+ * running CRC for incremental use; calculate() picks the fastest whole-buffer
+ * variant. The bitwise and table variants are kept for benchmarking.
+ */
+class ModBeeCRC {
+public:
+    // =============================================================================
+    // INCREMENTAL API
+    // =============================================================================
+    static inline uint16_t update(uint16_t crc, uint8_t byte) {
+        return (crc >> 8) ^ _table[0][(crc ^ byte) & 0xFF];
+    }
+
+    // =============================================================================
+    // WHOLE BUFFER API
+    // =============================================================================
+    static uint16_t calculate(const uint8_t* buffer, uint16_t length, uint16_t crc = MODBEE_CRC_INIT);
+
+    // =============================================================================
+    // INDIVIDUAL VARIANTS (BENCHMARKING)
+    // =============================================================================
+    static uint16_t calculateBitwise(const uint8_t* buffer, uint16_t length, uint16_t crc = MODBEE_CRC_INIT);
+    static uint16_t calculateTable(const uint8_t* buffer, uint16_t length, uint16_t crc = MODBEE_CRC_INIT);
+    static uint16_t calculateSlice4(const uint8_t* buffer, uint16_t length, uint16_t crc = MODBEE_CRC_INIT);
+
+    // =============================================================================
+    // CRC-8 (SHORT TOKEN CHECK)
+    // =============================================================================
+    static uint8_t calculate8(const uint8_t* buffer, uint16_t length, uint8_t crc = MODBEE_CRC8_INIT);
+
+private:
+    // _table[0] is the classic byte table, _table[k] advances a byte through k more zero bytes
+    static const uint16_t _table[4][256];
+};
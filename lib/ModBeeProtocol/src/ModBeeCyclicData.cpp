@@ -0,0 +1,175 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// CONSTRUCTOR AND DESTRUCTOR
+// =============================================================================
+ModBeeCyclicData::ModBeeCyclicData() {
+}
+
+ModBeeCyclicData::~ModBeeCyclicData() {
+    clearPublications();
+    clearSubscriptions();
+}
+
+// =============================================================================
+// PUBLICATIONS
+// =============================================================================
+bool ModBeeCyclicData::addPublication(uint8_t function, uint16_t startAddr, uint16_t quantity) {
+    ModbusRequest request;
+    request.function = function;
+    request.startAddr = startAddr;
+    request.quantity = quantity;
+    if (!ModbusFrame::isReadFunction(function) || !ModbusFrame::validateRequest(request)) {
+        return false;
+    }
+
+    // Publishing a range again resizes it
+    for (auto& publication : _publications) {
+        if (publication.function == function && publication.startAddr == startAddr) {
+            publication.quantity = quantity;
+            return true;
+        }
+    }
+
+    if (_publications.size() >= MODBEE_MAX_PUBLICATIONS) {
+        return false;
+    }
+    _publications.push_back({function, startAddr, quantity});
+    return true;
+}
+
+bool ModBeeCyclicData::removePublication(uint8_t function, uint16_t startAddr) {
+    for (auto it = _publications.begin(); it != _publications.end(); ++it) {
+        if (it->function == function && it->startAddr == startAddr) {
+            _publications.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+// =============================================================================
+// SUBSCRIPTIONS
+// =============================================================================
+bool ModBeeCyclicData::addSubscription(uint8_t nodeID, uint8_t function, uint16_t startAddr, uint16_t quantity, void* values) {
+    if (nodeID == MODBEE_BROADCAST_ID || !values || quantity == 0 || !ModbusFrame::isReadFunction(function)) {
+        return false;
+    }
+
+    // Subscribing again rebinds the range
+    for (auto& subscription : _subscriptions) {
+        if (subscription.nodeID == nodeID && subscription.function == function && subscription.startAddr == startAddr) {
+            subscription.quantity = quantity;
+            subscription.values = values;
+            subscription.updated = false;
+            return true;
+        }
+    }
+
+    if (_subscriptions.size() >= MODBEE_MAX_SUBSCRIPTIONS) {
+        return false;
+    }
+
+    ModBeeSubscription subscription;
+    subscription.nodeID = nodeID;
+    subscription.function = function;
+    subscription.startAddr = startAddr;
+    subscription.quantity = quantity;
+    subscription.values = values;
+    subscription.lastUpdate = 0;
+    subscription.updated = false;
+    _subscriptions.push_back(subscription);
+    _publishers.insert(nodeID);
+    return true;
+}
+
+bool ModBeeCyclicData::removeSubscription(uint8_t nodeID, uint8_t function, uint16_t startAddr) {
+    for (auto it = _subscriptions.begin(); it != _subscriptions.end(); ++it) {
+        if (it->nodeID == nodeID && it->function == function && it->startAddr == startAddr) {
+            _subscriptions.erase(it);
+            updatePublishers();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModBeeCyclicData::clearSubscriptions() {
+    _subscriptions.clear();
+    _publishers.clear();
+}
+
+const ModBeeSubscription* ModBeeCyclicData::findSubscription(uint8_t nodeID, uint8_t function, uint16_t startAddr) const {
+    for (const auto& subscription : _subscriptions) {
+        if (subscription.nodeID == nodeID && subscription.function == function && subscription.startAddr == startAddr) {
+            return &subscription;
+        }
+    }
+    return nullptr;
+}
+
+uint16_t ModBeeCyclicData::applyPublication(const ModbusRequest& response, uint8_t srcNodeID) {
+    if (!_publishers.contains(srcNodeID) || (response.function & 0x80) || response.data.empty()) {
+        return 0;
+    }
+
+    // Response data is [BYTE COUNT] [DATA]; never read past either
+    const uint8_t* data = &response.data[1];
+    uint16_t dataLength = std::min((size_t)response.data[0], response.data.size() - 1);
+    bool bits = isBitFunction(response.function);
+    uint32_t publishedEnd = (uint32_t)response.startAddr +
+        std::min<uint32_t>(response.quantity, bits ? dataLength * 8 : dataLength / 2);
+
+    uint16_t updated = 0;
+    uint32_t now = millis();
+    for (auto& subscription : _subscriptions) {
+        if (subscription.nodeID != srcNodeID || subscription.function != response.function) {
+            continue;
+        }
+
+        // A subscription may cover part of a publication, or a publication part of it
+        uint32_t first = std::max<uint32_t>(subscription.startAddr, response.startAddr);
+        uint32_t last = std::min<uint32_t>((uint32_t)subscription.startAddr + subscription.quantity, publishedEnd);
+        if (first >= last) {
+            continue;
+        }
+
+        for (uint32_t address = first; address < last; address++) {
+            uint16_t from = address - response.startAddr;
+            uint16_t to = address - subscription.startAddr;
+            if (bits) {
+                static_cast<bool*>(subscription.values)[to] = (data[from >> 3] >> (from & 7)) & 0x01;
+            } else {
+                static_cast<int16_t*>(subscription.values)[to] = (int16_t)((data[from * 2] << 8) | data[from * 2 + 1]);
+            }
+        }
+        subscription.lastUpdate = now;
+        subscription.updated = true;
+        updated++;
+    }
+    return updated;
+}
+
+void ModBeeCyclicData::updatePublishers() {
+    _publishers.clear();
+    for (const auto& subscription : _subscriptions) {
+        _publishers.insert(subscription.nodeID);
+    }
+}
+
+// =============================================================================
+// UTILITIES
+// =============================================================================
+uint8_t ModBeeCyclicData::getReadFunction(ModBeeRegisterType type) {
+    switch (type) {
+        case MB_OUTPUT_COIL:      return MB_FC_READ_COILS;
+        case MB_INPUT_STATUS:     return MB_FC_READ_DISCRETE_INPUTS;
+        case MB_HOLDING_REGISTER: return MB_FC_READ_HOLDING_REGISTERS;
+        default:                  return MB_FC_READ_INPUT_REGISTERS;
+    }
+}
+
+bool ModBeeCyclicData::isBitFunction(uint8_t function) {
+    function &= 0x7F;
+    return function == MB_FC_READ_COILS || function == MB_FC_READ_DISCRETE_INPUTS;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+/**
+ * Publish/subscribe tables for cyclic data exchange
+ * Publications are local data map ranges that ride in every data frame this
+ * node sends, as a read response multicast to everyone. Subscriptions bind a
+ * range another node publishes to local variables, which are updated in place
+ * as its frames pass: consumers see fresh values once per token rotation
+ * without a request ever going out.
+ */
+class ModBeeCyclicData {
+public:
+    // =============================================================================
+    // CONSTRUCTOR AND DESTRUCTOR
+    // =============================================================================
+    ModBeeCyclicData();
+    ~ModBeeCyclicData();
+
+    // =============================================================================
+    // PUBLICATIONS
+    // =============================================================================
+    bool addPublication(uint8_t function, uint16_t startAddr, uint16_t quantity);
+    bool removePublication(uint8_t function, uint16_t startAddr);
+    void clearPublications() { _publications.clear(); }
+    const std::vector<ModBeePublication>& getPublications() const { return _publications; }
+    bool hasPublications() const { return !_publications.empty(); }
+
+    // =============================================================================
+    // SUBSCRIPTIONS
+    // =============================================================================
+    bool addSubscription(uint8_t nodeID, uint8_t function, uint16_t startAddr, uint16_t quantity, void* values);
+    bool removeSubscription(uint8_t nodeID, uint8_t function, uint16_t startAddr);
+    void clearSubscriptions();
+    const ModBeeSubscription* findSubscription(uint8_t nodeID, uint8_t function, uint16_t startAddr) const;
+    bool isSubscribedTo(uint8_t nodeID) const { return _publishers.contains(nodeID); }
+
+    // Copies a publication into every subscription it overlaps, returns how many were updated
+    uint16_t applyPublication(const ModbusRequest& response, uint8_t srcNodeID);
+
+    // =============================================================================
+    // UTILITIES
+    // =============================================================================
+    static uint8_t getReadFunction(ModBeeRegisterType type);
+    static bool isBitFunction(uint8_t function);
+
+private:
+    std::vector<ModBeePublication> _publications;
+    std::vector<ModBeeSubscription> _subscriptions;
+    ModBeeNodeSet _publishers;          // Nodes with at least one subscription, checked per section
+
+    void updatePublishers();
+};
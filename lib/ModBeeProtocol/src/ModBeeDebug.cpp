@@ -307,8 +307,13 @@
             
             if (start < length) {
                 uint8_t targetNodeID = frame[start];
-                written = snprintf(p, remaining, "  Section %d: Target:%d, Bytes:%d\n", 
-                    i, targetNodeID, end - start - 1);
+                if (targetNodeID == MODBEE_BROADCAST_ID && start + 1 < end) {
+                    written = snprintf(p, remaining, "  Section %d: Group:%d, Bytes:%d\n", 
+                        i, frame[start + 1], end - start - 2);
+                } else {
+                    written = snprintf(p, remaining, "  Section %d: Target:%d, Bytes:%d\n", 
+                        i, targetNodeID, end - start - 1);
+                }
                 if (written < 0 || (size_t)written >= remaining) break;
                 p += written;
                 remaining -= written;
@@ -323,6 +328,9 @@
     // =============================================================================
     
     const char* ModBeeDebug::getFrameTypeString(const uint8_t* frame, uint16_t length) {
+        if (ModBeeFrame::isShortTokenFrame(frame, length)) {
+            return "SHORT TOKEN";
+        }
         if (!frame || length < MODBEE_MIN_FRAME_LEN) {
             return "INVALID";
         }
@@ -8,35 +8,72 @@ uint16_t ModBeeFrame::buildControlFrame(
     uint8_t srcNodeID,
     uint8_t nextMasterID,
     uint8_t addNodeID,
-    uint8_t removeNodeID) {
+    uint8_t removeNodeID,
+    bool stuffed,
+    bool compact,
+    uint8_t tokenSequence) {
     
     if (!buffer) {
         return 0;
     }
     
-    uint16_t pos = 0;
-    
-    // Start of frame
-    buffer[pos++] = MODBEE_SOF;
+    // Header (SOF, version/length for v2, SRC, NEXT, ADD, REM)
+    uint16_t pos = writeHeader(buffer, srcNodeID, nextMasterID, addNodeID, removeNodeID, stuffed, compact, tokenSequence);
     
-    // Source node ID
-    buffer[pos++] = srcNodeID;
-    
-    // Next master ID (0 if not passing token)
-    buffer[pos++] = nextMasterID;
+    // Patch length and append CRC
+    return finalizeFrame(buffer, pos);
+}
+
+uint16_t ModBeeFrame::buildJoinWindowFrame(
+    uint8_t* buffer,
+    uint8_t srcNodeID,
+    uint8_t firstNodeID,
+    uint8_t lastNodeID,
+    uint8_t slots,
+    uint32_t slotUs,
+    bool stuffed,
+    bool compact,
+    uint8_t tokenSequence) {
+    
+    if (!buffer || slots == 0 || firstNodeID > lastNodeID) {
+        return 0;
+    }
     
-    // Add node ID (0 if not adding)
-    buffer[pos++] = addNodeID;
+    // Header with REM = MODBEE_JOIN_WINDOW, then the window description
+    uint16_t pos = writeHeader(buffer, srcNodeID, 0, 0, MODBEE_JOIN_WINDOW, stuffed, compact, tokenSequence);
+    uint32_t slotUnits = std::min((slotUs + MODBEE_JOIN_SLOT_UNIT_US - 1) / MODBEE_JOIN_SLOT_UNIT_US, (uint32_t)0xFFFF);
+    buffer[pos++] = firstNodeID;
+    buffer[pos++] = lastNodeID;
+    buffer[pos++] = slots;
+    buffer[pos++] = (slotUnits >> 8) & 0xFF;
+    buffer[pos++] = slotUnits & 0xFF;
     
-    // Remove node ID (0 if not removing)
-    buffer[pos++] = removeNodeID;
+    return finalizeFrame(buffer, pos);
+}
+
+uint16_t ModBeeFrame::buildShortTokenFrame(
+    uint8_t* buffer,
+    uint8_t srcNodeID,
+    uint8_t nextMasterID,
+    uint8_t tokenSequence) {
     
-    // Calculate and append CRC
-    uint16_t crc = calculateCRC(buffer, pos);
-    buffer[pos++] = (crc >> 8) & 0xFF;
-    buffer[pos++] = crc & 0xFF;
+    if (!buffer) {
+        return 0;
+    }
     
-    return pos;
+    // Fixed length, no LEN field and never stuffed: SRC or NEXT may be 0x7E
+    buffer[0] = MODBEE_SOF;
+    buffer[1] = MODBEE_SHORT_TOKEN_MARKER;
+    buffer[2] = srcNodeID;
+    buffer[3] = nextMasterID;
+    buffer[4] = getShortTokenCheck(srcNodeID, nextMasterID, tokenSequence);
+    return MODBEE_SHORT_TOKEN_LEN;
+}
+
+uint8_t ModBeeFrame::getShortTokenCheck(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t tokenSequence) {
+    // The sequence is covered but not sent: a pass of a reclaimed token fails like a corrupted one
+    uint8_t fields[4] = { MODBEE_SHORT_TOKEN_MARKER, srcNodeID, nextMasterID, tokenSequence };
+    return ModBeeCRC::calculate8(fields, sizeof(fields));
 }
 
 // =============================================================================
@@ -62,26 +99,8 @@ uint16_t ModBeeFrame::buildDataFrame(
         return 0;
     }
     
-    uint16_t pos = 0;
-    
-    // Build header with overflow protection
-    if (pos + 5 > MODBEE_MAX_TX_BUFFER - 10) { // Reserve space for CRC and safety margin
-        return 0;
-    }
-    
-    buffer[pos++] = MODBEE_SOF;
-    
-    // Source node ID
-    buffer[pos++] = srcNodeID;
-    
-    // Next master ID
-    buffer[pos++] = nextMasterID;
-    
-    // Add node ID
-    buffer[pos++] = addNodeID;
-    
-    // Remove node ID
-    buffer[pos++] = removeNodeID;
+    // Build header
+    uint16_t pos = writeHeader(buffer, srcNodeID, nextMasterID, addNodeID, removeNodeID);
     
     // Add operations with strict validation
     for (const auto& op : operations) {
@@ -96,8 +115,11 @@ uint16_t ModBeeFrame::buildDataFrame(
         // Add section delimiter
         buffer[pos++] = MODBEE_PACKET_DELIM;
         
-        // Add slave ID
+        // Add slave ID (and group of a multicast write)
         buffer[pos++] = op.destNodeID;
+        if (op.destNodeID == MODBEE_BROADCAST_ID) {
+            buffer[pos++] = op.group;
+        }
         
         // Build Modbus section
         uint16_t modbusLen = 0;
@@ -129,14 +151,572 @@ uint16_t ModBeeFrame::buildDataFrame(
         return 0;
     }
     
-    // Calculate and add CRC
-    uint16_t crc = calculateCRC(buffer, pos);
-    buffer[pos++] = (crc >> 8) & 0xFF;
-    buffer[pos++] = crc & 0xFF;
+    // Patch length and add CRC
+    return finalizeFrame(buffer, pos);
+}
+
+// =============================================================================
+// WIRE FORMAT LAYOUT
+// =============================================================================
+uint16_t ModBeeFrame::writeHeader(
+    uint8_t* buffer,
+    uint8_t srcNodeID,
+    uint8_t nextMasterID,
+    uint8_t addNodeID,
+    uint8_t removeNodeID,
+    bool stuffed,
+    bool compact,
+    uint8_t tokenSequence) {
+    
+    uint16_t pos = 0;
+    
+    // Start of frame
+    buffer[pos++] = MODBEE_SOF;
+    
+    // v2: version marker and a length placeholder patched by finalizeFrame()
+    // Compact sections need no stuffing: no section boundary depends on a byte value
+    // The token sequence rides in the LEN_H bits a 512-byte frame never uses
+    if (ModBeeAPI::MODBEE_FRAME_VERSION >= MODBEE_FRAME_VERSION_2) {
+        buffer[pos++] = compact ? MODBEE_FRAME_V2_COMPACT_MARKER :
+                        stuffed ? MODBEE_FRAME_V2_STUFFED_MARKER : MODBEE_FRAME_V2_MARKER;
+        buffer[pos++] = (tokenSequence & MODBEE_TOKEN_SEQ_MAX) << MODBEE_TOKEN_SEQ_SHIFT;
+        buffer[pos++] = 0;
+    }
+    
+    // Source node ID
+    buffer[pos++] = srcNodeID;
+    
+    // Next master ID (0 if not passing token)
+    buffer[pos++] = nextMasterID;
+    
+    // Add node ID (0 if not adding)
+    buffer[pos++] = addNodeID;
+    
+    // Remove node ID (0 if not removing)
+    buffer[pos++] = removeNodeID;
     
     return pos;
 }
 
+uint16_t ModBeeFrame::finalizeFrame(uint8_t* buffer, uint16_t length) {
+    if (!buffer || length + 2 > MODBEE_MAX_TX_BUFFER) {
+        return 0;
+    }
+    
+    // v2 length covers the whole frame, SOF through CRC
+    if (getFrameVersion(buffer, length) == MODBEE_FRAME_VERSION_2) {
+        uint16_t frameLen = length + 2;
+        buffer[2] = (buffer[2] & ~MODBEE_FRAME_LEN_H_MASK) | ((frameLen >> 8) & MODBEE_FRAME_LEN_H_MASK);
+        buffer[3] = frameLen & 0xFF;
+    }
+    
+    uint16_t crc = calculateCRC(buffer, length);
+    buffer[length++] = (crc >> 8) & 0xFF;
+    buffer[length++] = crc & 0xFF;
+    
+    return length;
+}
+
+uint16_t ModBeeFrame::getTransactionSectionLength(bool compact) {
+    return compact ? 3 : 4;
+}
+
+uint16_t ModBeeFrame::writeTransactionSection(uint8_t* buffer, uint8_t targetNodeID, uint8_t transactionID, bool compact) {
+    // Compact: [TAG|LEN] [DEST] [TID]; otherwise [DELIM] [DEST] [FC] [TID]
+    uint16_t pos = 0;
+    if (compact) {
+        buffer[pos++] = MODBEE_COMPACT_TRANSACTION | 2;
+    } else {
+        buffer[pos++] = MODBEE_PACKET_DELIM;
+    }
+    buffer[pos++] = targetNodeID;
+    if (!compact) {
+        buffer[pos++] = MODBEE_FC_TRANSACTION;
+    }
+    buffer[pos++] = transactionID;
+    return pos;
+}
+
+uint16_t ModBeeFrame::getTimeSectionLength(bool multicast) {
+    // [DELIM] or [TAG|LEN], [DEST] ([GROUP]) [FC] [TIME]: the same size in both formats
+    return 3 + multicast + MODBEE_TIME_FIELD_LEN;
+}
+
+uint16_t ModBeeFrame::writeTimeSection(uint8_t* buffer, uint8_t targetNodeID, uint8_t group, uint8_t functionCode, uint32_t timeUs, bool compact) {
+    bool multicast = (targetNodeID == MODBEE_BROADCAST_ID);
+    uint16_t pos = 0;
+    buffer[pos++] = compact ? (MODBEE_COMPACT_EXTENSION | (2 + multicast + MODBEE_TIME_FIELD_LEN)) : MODBEE_PACKET_DELIM;
+    buffer[pos++] = targetNodeID;
+    if (multicast) {
+        buffer[pos++] = group;
+    }
+    buffer[pos++] = functionCode;
+    
+    // Six 6-bit groups, most significant first (the top group holds only 2 bits)
+    for (int8_t shift = 30; shift >= 0; shift -= 6) {
+        buffer[pos++] = (timeUs >> shift) & 0x3F;
+    }
+    return pos;
+}
+
+bool ModBeeFrame::readTimeField(const uint8_t* buffer, uint32_t& timeUs) {
+    timeUs = 0;
+    for (uint8_t i = 0; i < MODBEE_TIME_FIELD_LEN; i++) {
+        if (buffer[i] > 0x3F || (i == 0 && buffer[i] > 0x03)) {
+            return false;
+        }
+        timeUs = (timeUs << 6) | buffer[i];
+    }
+    return true;
+}
+
+uint8_t ModBeeFrame::getFrameVersion(const uint8_t* buffer, uint16_t length) {
+    if (buffer && length >= 2 &&
+        (buffer[1] == MODBEE_FRAME_V2_MARKER || buffer[1] == MODBEE_FRAME_V2_STUFFED_MARKER ||
+         buffer[1] == MODBEE_FRAME_V2_COMPACT_MARKER)) {
+        return MODBEE_FRAME_VERSION_2;
+    }
+    return MODBEE_FRAME_VERSION_LEGACY;
+}
+
+uint16_t ModBeeFrame::getHeaderOffset(const uint8_t* buffer, uint16_t length) {
+    // Legacy: SOF(1) | v2: SOF(1) + VER(1) + LEN(2)
+    return (getFrameVersion(buffer, length) == MODBEE_FRAME_VERSION_2) ? 4 : 1;
+}
+
+uint16_t ModBeeFrame::getPayloadOffset(const uint8_t* buffer, uint16_t length) {
+    // Header is SRC + NEXT + ADD + REM
+    return getHeaderOffset(buffer, length) + 4;
+}
+
+uint16_t ModBeeFrame::getFrameOverhead() {
+    // Header + CRC for the configured TX format
+    return (ModBeeAPI::MODBEE_FRAME_VERSION >= MODBEE_FRAME_VERSION_2) ? MODBEE_V2_MIN_FRAME_LEN : MODBEE_MIN_FRAME_LEN;
+}
+
+// =============================================================================
+// BYTE STUFFING
+// =============================================================================
+bool ModBeeFrame::isStuffedFrame(const uint8_t* buffer, uint16_t length) {
+    return buffer && length >= 2 && buffer[1] == MODBEE_FRAME_V2_STUFFED_MARKER;
+}
+
+uint16_t ModBeeFrame::stuffFrame(
+    const uint8_t* frame,
+    uint16_t length,
+    const uint16_t* delimiters,
+    uint8_t delimiterCount,
+    uint8_t* out,
+    uint16_t outCapacity) {
+    
+    if (!frame || !out || length < 2 || outCapacity < 2) {
+        return 0;
+    }
+    
+    // SOF and version marker go out as-is
+    uint16_t outPos = 0;
+    out[outPos++] = frame[0];
+    out[outPos++] = frame[1];
+    
+    uint8_t nextDelim = 0;
+    for (uint16_t i = 2; i < length; i++) {
+        uint8_t byte = frame[i];
+        
+        // Section delimiters are the only raw 0x7C left on the wire
+        bool isDelimiter = false;
+        if (nextDelim < delimiterCount && delimiters[nextDelim] == i) {
+            isDelimiter = true;
+            nextDelim++;
+        }
+        
+        bool escape = (byte == MODBEE_SOF || byte == MODBEE_ESCAPE ||
+                       (byte == MODBEE_PACKET_DELIM && !isDelimiter));
+        
+        if (outPos + (escape ? 2 : 1) > outCapacity) {
+            return 0;
+        }
+        
+        if (escape) {
+            out[outPos++] = MODBEE_ESCAPE;
+            out[outPos++] = byte ^ MODBEE_ESCAPE_XOR;
+        } else {
+            out[outPos++] = byte;
+        }
+    }
+    
+    return outPos;
+}
+
+// =============================================================================
+// COMPACT SECTIONS
+// =============================================================================
+bool ModBeeFrame::isCompactFrame(const uint8_t* buffer, uint16_t length) {
+    return buffer && length >= 2 && buffer[1] == MODBEE_FRAME_V2_COMPACT_MARKER;
+}
+
+uint16_t ModBeeFrame::getCompactRequestLength(const uint8_t* pdu, uint16_t pduLength, bool multicast) {
+    CompactFields fields;
+    if (!getRequestFields(pdu, pduLength, fields)) {
+        return 0;
+    }
+    fields.multicast = multicast;
+    return getCompactSectionLength(fields);
+}
+
+uint16_t ModBeeFrame::writeCompactRequest(uint8_t* buffer, uint8_t targetNodeID, const uint8_t* pdu, uint16_t pduLength, uint8_t group) {
+    CompactFields fields;
+    if (!getRequestFields(pdu, pduLength, fields)) {
+        return 0;
+    }
+    fields.multicast = (targetNodeID == MODBEE_BROADCAST_ID);
+    fields.group = group;
+    return writeCompactFields(buffer, targetNodeID, fields);
+}
+
+uint16_t ModBeeFrame::getCompactResponseLength(const ModbusRequest& response, bool multicast) {
+    CompactFields fields;
+    if (!getResponseFields(response, fields)) {
+        return 0;
+    }
+    fields.multicast = multicast;
+    return getCompactSectionLength(fields);
+}
+
+uint16_t ModBeeFrame::writeCompactResponse(uint8_t* buffer, uint8_t targetNodeID, const ModbusRequest& response, uint8_t group) {
+    CompactFields fields;
+    if (!getResponseFields(response, fields)) {
+        return 0;
+    }
+    fields.multicast = (targetNodeID == MODBEE_BROADCAST_ID);
+    fields.group = group;
+    return writeCompactFields(buffer, targetNodeID, fields);
+}
+
+uint16_t ModBeeFrame::nextCompactSection(
+    const uint8_t* buffer,
+    uint16_t pos,
+    uint16_t end,
+    uint8_t& tag,
+    uint16_t& valueStart,
+    uint16_t& valueEnd) {
+    
+    if (!buffer || pos >= end) {
+        return 0;
+    }
+    
+    tag = buffer[pos++];
+    uint16_t valueLength = tag & MODBEE_COMPACT_LEN_MASK;
+    tag &= ~MODBEE_COMPACT_LEN_MASK;
+    
+    if (valueLength == MODBEE_COMPACT_LEN_EXT && !readVarint(buffer, pos, end, valueLength)) {
+        return 0;
+    }
+    
+    // Every section carries at least its destination
+    if (valueLength == 0 || valueLength > end - pos) {
+        return 0;
+    }
+    
+    valueStart = pos;
+    valueEnd = pos + valueLength;
+    return valueEnd;
+}
+
+bool ModBeeFrame::decodeCompactSection(
+    const uint8_t* buffer,
+    uint8_t tag,
+    uint16_t valueStart,
+    uint16_t valueEnd,
+    ModbusRequest& request) {
+    
+    // Skip the destination (and group), the caller has already matched it
+    uint16_t pos = valueStart + (buffer[valueStart] == MODBEE_BROADCAST_ID ? 2 : 1);
+    uint8_t type = (tag >> MODBEE_COMPACT_TYPE_SHIFT) & 0x03;
+    bool bitType = (type == MB_OUTPUT_COIL || type == MB_INPUT_STATUS);
+    
+    request.isResponse = (tag & MODBEE_COMPACT_RESPONSE) != 0;
+    request.data.clear();
+    
+    if (!readVarint(buffer, pos, valueEnd, request.startAddr)) {
+        return false;
+    }
+    
+    if (request.isResponse && (tag & MODBEE_COMPACT_WRITE)) {
+        // Exception response: [ADDR] [EXCEPTION CODE]
+        if (valueEnd - pos != 1) {
+            return false;
+        }
+        request.function = getReadFunction(type) | 0x80;
+        request.quantity = 0;
+        request.data.push_back(buffer[pos]);
+        return true;
+    }
+    
+    if (request.isResponse) {
+        // Read response: [ADDR] [COUNT, bit types only] [DATA]
+        request.function = getReadFunction(type);
+        if (bitType && !readVarint(buffer, pos, valueEnd, request.quantity)) {
+            return false;
+        }
+        uint16_t byteCount = valueEnd - pos;
+        if (byteCount == 0 || byteCount > 0xFF) {
+            return false;
+        }
+        if (!bitType) {
+            request.quantity = byteCount / 2;
+        }
+        request.data.reserve(1 + byteCount);
+        request.data.push_back((uint8_t)byteCount);
+        request.data.insert(request.data.end(), &buffer[pos], &buffer[valueEnd]);
+        return true;
+    }
+    
+    if (tag & MODBEE_COMPACT_WRITE) {
+        if (type == MB_OUTPUT_COIL) {
+            // Coil write: [ADDR] [COUNT] [PACKED BITS]
+            if (!readVarint(buffer, pos, valueEnd, request.quantity) || request.quantity == 0 ||
+                valueEnd - pos != ModbusFrame::getBitPackedBytes(request.quantity)) {
+                return false;
+            }
+            if (request.quantity == 1) {
+                request.function = MB_FC_WRITE_SINGLE_COIL;
+                request.data.push_back((buffer[pos] & 0x01) ? 0xFF : 0x00);
+                request.data.push_back(0x00);
+                return true;
+            }
+            request.function = MB_FC_WRITE_MULTIPLE_COILS;
+        } else if (type == MB_HOLDING_REGISTER) {
+            // Register write: [ADDR] [VALUES], two bytes each
+            uint16_t byteCount = valueEnd - pos;
+            if (byteCount == 0 || (byteCount & 1) || byteCount > 0xFF) {
+                return false;
+            }
+            request.quantity = byteCount / 2;
+            if (request.quantity == 1) {
+                request.function = MB_FC_WRITE_SINGLE_REGISTER;
+                request.data.push_back(buffer[pos]);
+                request.data.push_back(buffer[pos + 1]);
+                return true;
+            }
+            request.function = MB_FC_WRITE_MULTIPLE_REGISTERS;
+        } else {
+            return false; // Inputs are read-only
+        }
+        
+        // Multiple writes keep the Modbus byte count prefix
+        request.data.reserve(1 + valueEnd - pos);
+        request.data.push_back((uint8_t)(valueEnd - pos));
+        request.data.insert(request.data.end(), &buffer[pos], &buffer[valueEnd]);
+        return true;
+    }
+    
+    // Read request: [ADDR] [COUNT, omitted when 1]
+    request.function = getReadFunction(type);
+    request.quantity = 1;
+    if (pos < valueEnd && !readVarint(buffer, pos, valueEnd, request.quantity)) {
+        return false;
+    }
+    return pos == valueEnd;
+}
+
+bool ModBeeFrame::getCompactGroup(const uint8_t* buffer, uint16_t valueStart, uint16_t valueEnd, uint8_t& group) {
+    if (buffer[valueStart] != MODBEE_BROADCAST_ID || valueEnd - valueStart < 2) {
+        return false;
+    }
+    group = buffer[valueStart + 1];
+    return true;
+}
+
+uint8_t ModBeeFrame::getVarintLength(uint16_t value) {
+    return (value < 0x80) ? 1 : (value < 0x4000) ? 2 : 3;
+}
+
+uint16_t ModBeeFrame::writeVarint(uint8_t* buffer, uint16_t value) {
+    // LEB128: 7 bits per byte, low bits first, high bit set on all but the last
+    uint16_t pos = 0;
+    while (value >= 0x80) {
+        buffer[pos++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buffer[pos++] = (uint8_t)value;
+    return pos;
+}
+
+bool ModBeeFrame::readVarint(const uint8_t* buffer, uint16_t& pos, uint16_t end, uint16_t& value) {
+    uint32_t result = 0;
+    for (uint8_t shift = 0; shift < 21 && pos < end; shift += 7) {
+        uint8_t byte = buffer[pos++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            if (result > 0xFFFF) {
+                return false;
+            }
+            value = (uint16_t)result;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModBeeFrame::getRequestFields(const uint8_t* pdu, uint16_t pduLength, CompactFields& fields) {
+    // Re-encodes a PDU from ModbusFrame::buildModbusRequest()
+    if (!pdu || pduLength < 5) {
+        return false;
+    }
+    
+    uint8_t type;
+    if (!getRegisterType(pdu[0], type)) {
+        return false;
+    }
+    
+    fields.tag = type << MODBEE_COMPACT_TYPE_SHIFT;
+    fields.address = ((uint16_t)pdu[1] << 8) | pdu[2];
+    fields.count = ((uint16_t)pdu[3] << 8) | pdu[4];
+    fields.hasCount = false;
+    fields.data = nullptr;
+    fields.dataLength = 0;
+    fields.multicast = false;
+    
+    switch (pdu[0]) {
+        case MB_FC_READ_COILS:
+        case MB_FC_READ_DISCRETE_INPUTS:
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_READ_INPUT_REGISTERS:
+            fields.hasCount = (fields.count != 1);
+            return true;
+            
+        case MB_FC_WRITE_SINGLE_COIL:
+            fields.tag |= MODBEE_COMPACT_WRITE;
+            fields.count = 1;
+            fields.hasCount = true;
+            fields.bit = (pdu[3] == 0xFF) ? 0x01 : 0x00;
+            fields.data = &fields.bit;
+            fields.dataLength = 1;
+            return true;
+            
+        case MB_FC_WRITE_SINGLE_REGISTER:
+            fields.tag |= MODBEE_COMPACT_WRITE;
+            fields.data = &pdu[3];
+            fields.dataLength = 2;
+            return true;
+            
+        case MB_FC_WRITE_MULTIPLE_COILS:
+        case MB_FC_WRITE_MULTIPLE_REGISTERS:
+            if (pduLength < 6 || pduLength < 6 + pdu[5]) {
+                return false;
+            }
+            fields.tag |= MODBEE_COMPACT_WRITE;
+            fields.hasCount = (pdu[0] == MB_FC_WRITE_MULTIPLE_COILS);
+            fields.data = &pdu[6];
+            fields.dataLength = pdu[5];
+            return true;
+            
+        default:
+            return false;
+    }
+}
+
+bool ModBeeFrame::getResponseFields(const ModbusRequest& response, CompactFields& fields) {
+    static const uint8_t deviceFailure = MB_EX_SLAVE_DEVICE_FAILURE;
+    
+    uint8_t type;
+    if (!getRegisterType(response.function & 0x7F, type) || !ModbusFrame::isReadFunction(response.function & 0x7F)) {
+        return false; // Writes are never acknowledged
+    }
+    
+    fields.tag = MODBEE_COMPACT_RESPONSE | (type << MODBEE_COMPACT_TYPE_SHIFT);
+    fields.address = response.startAddr;
+    fields.count = response.quantity;
+    fields.hasCount = false;
+    fields.multicast = false;
+    
+    if (response.function & 0x80) {
+        fields.tag |= MODBEE_COMPACT_WRITE;
+        fields.data = response.data.empty() ? &deviceFailure : &response.data[0];
+        fields.dataLength = 1;
+        return true;
+    }
+    
+    // Response data is [BYTE COUNT] [DATA]
+    if (response.data.empty()) {
+        return false;
+    }
+    fields.hasCount = (type == MB_OUTPUT_COIL || type == MB_INPUT_STATUS);
+    fields.data = &response.data[1];
+    fields.dataLength = std::min((size_t)response.data[0], response.data.size() - 1);
+    return fields.dataLength > 0;
+}
+
+uint16_t ModBeeFrame::getCompactValueLength(const CompactFields& fields) {
+    // DEST + GROUP + ADDR + COUNT + DATA
+    return (fields.multicast ? 2 : 1) + getVarintLength(fields.address) +
+           (fields.hasCount ? getVarintLength(fields.count) : 0) + fields.dataLength;
+}
+
+uint16_t ModBeeFrame::getCompactSectionLength(const CompactFields& fields) {
+    uint16_t valueLength = getCompactValueLength(fields);
+    return 1 + (valueLength < MODBEE_COMPACT_LEN_EXT ? 0 : getVarintLength(valueLength)) + valueLength;
+}
+
+uint16_t ModBeeFrame::writeCompactFields(uint8_t* buffer, uint8_t targetNodeID, const CompactFields& fields) {
+    uint16_t valueLength = getCompactValueLength(fields);
+    uint16_t pos = 0;
+    
+    // Short lengths ride in the TAG, longer ones follow it
+    if (valueLength < MODBEE_COMPACT_LEN_EXT) {
+        buffer[pos++] = fields.tag | valueLength;
+    } else {
+        buffer[pos++] = fields.tag | MODBEE_COMPACT_LEN_EXT;
+        pos += writeVarint(&buffer[pos], valueLength);
+    }
+    
+    buffer[pos++] = targetNodeID;
+    if (fields.multicast) {
+        buffer[pos++] = fields.group;
+    }
+    pos += writeVarint(&buffer[pos], fields.address);
+    if (fields.hasCount) {
+        pos += writeVarint(&buffer[pos], fields.count);
+    }
+    if (fields.dataLength > 0) {
+        memcpy(&buffer[pos], fields.data, fields.dataLength);
+    }
+    
+    return pos + fields.dataLength;
+}
+
+bool ModBeeFrame::getRegisterType(uint8_t functionCode, uint8_t& type) {
+    switch (functionCode) {
+        case MB_FC_READ_COILS:
+        case MB_FC_WRITE_SINGLE_COIL:
+        case MB_FC_WRITE_MULTIPLE_COILS:
+            type = MB_OUTPUT_COIL;
+            return true;
+        case MB_FC_READ_DISCRETE_INPUTS:
+            type = MB_INPUT_STATUS;
+            return true;
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_WRITE_SINGLE_REGISTER:
+        case MB_FC_WRITE_MULTIPLE_REGISTERS:
+            type = MB_HOLDING_REGISTER;
+            return true;
+        case MB_FC_READ_INPUT_REGISTERS:
+            type = MB_INPUT_REGISTER;
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint8_t ModBeeFrame::getReadFunction(uint8_t type) {
+    switch (type) {
+        case MB_OUTPUT_COIL:      return MB_FC_READ_COILS;
+        case MB_INPUT_STATUS:     return MB_FC_READ_DISCRETE_INPUTS;
+        case MB_HOLDING_REGISTER: return MB_FC_READ_HOLDING_REGISTERS;
+        default:                  return MB_FC_READ_INPUT_REGISTERS;
+    }
+}
+
 // =============================================================================
 // FRAME PARSING
 // =============================================================================
@@ -157,12 +737,36 @@ bool ModBeeFrame::parseHeader(
         return false;
     }
     
+    uint16_t hdr = getHeaderOffset(buffer, length);
+    if (length < hdr + 6) {
+        return false;
+    }
+    
     // Extract header fields
-    srcNodeID = buffer[1];
-    nextMasterID = buffer[2];
-    addNodeID = buffer[3];
-    removeNodeID = buffer[4];
+    srcNodeID = buffer[hdr];
+    nextMasterID = buffer[hdr + 1];
+    addNodeID = buffer[hdr + 2];
+    removeNodeID = buffer[hdr + 3];
+    
+    return true;
+}
+
+bool ModBeeFrame::parseShortToken(
+    const uint8_t* buffer,
+    uint16_t length,
+    uint8_t tokenSequence,
+    uint8_t& srcNodeID,
+    uint8_t& nextMasterID) {
     
+    if (!isShortTokenFrame(buffer, length)) {
+        return false;
+    }
+    if (buffer[4] != getShortTokenCheck(buffer[2], buffer[3], tokenSequence)) {
+        return false;
+    }
+    
+    srcNodeID = buffer[2];
+    nextMasterID = buffer[3];
     return true;
 }
 
@@ -197,6 +801,14 @@ bool ModBeeFrame::verifyCRC(const uint8_t* buffer, uint16_t length) {
         return false;
     }
     
+    // v2 frames must match their declared length exactly
+    if (getFrameVersion(buffer, length) == MODBEE_FRAME_VERSION_2) {
+        uint16_t declaredLen = ((uint16_t)(buffer[2] & MODBEE_FRAME_LEN_H_MASK) << 8) | buffer[3];
+        if (length < MODBEE_V2_MIN_FRAME_LEN || declaredLen != length) {
+            return false;
+        }
+    }
+    
     // Extract and validate CRC
     uint16_t receivedCRC = ((uint16_t)buffer[length - 2] << 8) | buffer[length - 1];
     uint16_t calculatedCRC = calculateCRC(buffer, length - 2);
@@ -209,6 +821,33 @@ bool ModBeeFrame::verifyCRC(const uint8_t* buffer, uint16_t length) {
     return valid;
 }
 
+bool ModBeeFrame::parseJoinWindow(const uint8_t* buffer, uint16_t bufLen, uint8_t& firstNodeID, uint8_t& lastNodeID, uint8_t& slots, uint32_t& slotUs) {
+    uint16_t pos = getPayloadOffset(buffer, bufLen);
+    if (!buffer || pos + MODBEE_JOIN_WINDOW_PAYLOAD + 2 > bufLen) {
+        return false;
+    }
+    
+    firstNodeID = buffer[pos];
+    lastNodeID = buffer[pos + 1];
+    slots = buffer[pos + 2];
+    slotUs = (((uint32_t)buffer[pos + 3] << 8) | buffer[pos + 4]) * MODBEE_JOIN_SLOT_UNIT_US;
+    
+    return slots > 0 && slots <= MODBEE_MAX_JOIN_SLOTS && firstNodeID <= lastNodeID && slotUs > 0;
+}
+
+uint8_t ModBeeFrame::getJoinSlot(uint8_t nodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots) {
+    // Each slot answers for a contiguous block of IDs, so a colliding slot splits in halves
+    uint16_t idCount = lastNodeID - firstNodeID + 1;
+    return (uint8_t)((uint16_t)(nodeID - firstNodeID) * slots / idCount);
+}
+
+void ModBeeFrame::getJoinSlotRange(uint8_t slot, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint8_t& slotFirst, uint8_t& slotLast) {
+    // Inverse of getJoinSlot: offsets o with floor(o * slots / idCount) == slot
+    uint16_t idCount = lastNodeID - firstNodeID + 1;
+    slotFirst = firstNodeID + (slot * idCount + slots - 1) / slots;
+    slotLast = firstNodeID + ((slot + 1) * idCount + slots - 1) / slots - 1;
+}
+
 // =============================================================================
 // MODBUS SECTION DETECTION
 // =============================================================================
@@ -217,8 +856,13 @@ bool ModBeeFrame::hasModbusData(const uint8_t* buffer, uint16_t length) {
         return false;
     }
     
+    // Compact frames: anything between header and CRC is a section
+    if (isCompactFrame(buffer, length)) {
+        return getPayloadOffset(buffer, length) < length - 2;
+    }
+    
     // Look for packet delimiter after header
-    for (uint16_t i = 5; i < length - 2; i++) {
+    for (uint16_t i = getPayloadOffset(buffer, length); i < length - 2; i++) {
         if (buffer[i] == MODBEE_PACKET_DELIM) {
             return true;
         }
@@ -238,10 +882,20 @@ int ModBeeFrame::findModbusSections(
     
     sections.clear();
     
-    // Start searching after header (position 5)
-    uint16_t pos = 5;
+    // Start searching after header
+    uint16_t pos = getPayloadOffset(buffer, length);
     uint16_t dataEnd = length - 2; // Exclude CRC
     
+    // Compact frames: follow the section lengths, sections start at DEST
+    if (isCompactFrame(buffer, length)) {
+        uint8_t tag;
+        uint16_t valueStart, valueEnd;
+        while (pos < dataEnd && (pos = nextCompactSection(buffer, pos, dataEnd, tag, valueStart, valueEnd)) != 0) {
+            sections.push_back(std::make_pair(valueStart, valueEnd));
+        }
+        return sections.size();
+    }
+    
     while (pos < dataEnd) {
         // Look for section delimiter
         if (buffer[pos] == MODBEE_PACKET_DELIM) {
@@ -279,6 +933,35 @@ int ModBeeFrame::findModbusSections(
     return sections.size();
 }
 
+int ModBeeFrame::findModbusSections(
+    const uint8_t* buffer,
+    uint16_t length,
+    const uint16_t* delimiters,
+    uint8_t delimiterCount,
+    std::vector<std::pair<uint16_t, uint16_t>>& sections) {
+    
+    if (!buffer || length < MODBEE_MIN_FRAME_LEN) {
+        return 0;
+    }
+    
+    sections.clear();
+    
+    // Stuffed frames: delimiter positions were recorded on RX, data 0x7C is never a boundary
+    uint16_t dataEnd = length - 2; // Exclude CRC
+    
+    for (uint8_t i = 0; i < delimiterCount; i++) {
+        uint16_t sectionStart = delimiters[i] + 1;
+        uint16_t sectionEnd = (i + 1 < delimiterCount) ? delimiters[i + 1] : dataEnd;
+        
+        // Add section if it has meaningful data (minimum 3 bytes: nodeID + FC + data)
+        if (sectionEnd <= dataEnd && sectionEnd > sectionStart + 2) {
+            sections.push_back(std::make_pair(sectionStart, sectionEnd));
+        }
+    }
+    
+    return sections.size();
+}
+
 uint8_t ModBeeFrame::extractTargetNodeID(const uint8_t* buffer, uint16_t length, uint16_t sectionStart) {
     if (!buffer || sectionStart >= length - 1) {
         return 0;
@@ -296,21 +979,7 @@ uint16_t ModBeeFrame::calculateCRC(const uint8_t* buffer, uint16_t length) {
         return 0;
     }
     
-    uint16_t crc = 0xFFFF;
-    
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= (uint16_t)buffer[i];
-        
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc = crc >> 1;
-            }
-        }
-    }
-    
-    return crc;
+    return ModBeeCRC::calculate(buffer, length);
 }
 
 // =============================================================================
@@ -321,8 +990,8 @@ bool ModBeeFrame::validateFrameLength(uint16_t length) {
 }
 
 uint16_t ModBeeFrame::getMaxDataPayload() {
-    // Max frame size minus: SOF(1) + Header(4) + CRC(2)
-    return MODBEE_MAX_TX_BUFFER - 7;
+    // Max frame size minus: SOF(1) + [VER(1) + LEN(2)] + Header(4) + CRC(2)
+    return MODBEE_MAX_TX_BUFFER - getFrameOverhead();
 }
 
 bool ModBeeFrame::canFitInFrame(uint16_t currentSize, uint16_t additionalSize) {
@@ -357,7 +1026,11 @@ bool ModBeeFrame::isTokenFrame(const uint8_t* buffer, uint16_t length) {
     }
     
     // Token frame has next master ID set and is a control-only frame
-    return (buffer[2] != 0 && !hasModbusData(buffer, length));
+    return (getNextMasterID(buffer, length) != 0 && !hasModbusData(buffer, length));
+}
+
+bool ModBeeFrame::isShortTokenFrame(const uint8_t* buffer, uint16_t length) {
+    return buffer && length == MODBEE_SHORT_TOKEN_LEN && buffer[0] == MODBEE_SOF && buffer[1] == MODBEE_SHORT_TOKEN_MARKER;
 }
 
 bool ModBeeFrame::isPresenceFrame(const uint8_t* buffer, uint16_t length) {
@@ -366,7 +1039,8 @@ bool ModBeeFrame::isPresenceFrame(const uint8_t* buffer, uint16_t length) {
     }
     
     // Presence frame has all control fields zero and no Modbus data
-    return (buffer[2] == 0 && buffer[3] == 0 && buffer[4] == 0 && !hasModbusData(buffer, length));
+    return (getNextMasterID(buffer, length) == 0 && getAddNodeID(buffer, length) == 0 &&
+            getRemoveNodeID(buffer, length) == 0 && !hasModbusData(buffer, length));
 }
 
 bool ModBeeFrame::isConnectionFrame(const uint8_t* buffer, uint16_t length) {
@@ -375,7 +1049,7 @@ bool ModBeeFrame::isConnectionFrame(const uint8_t* buffer, uint16_t length) {
     }
     
     // Connection frame has add node ID set
-    return (buffer[3] != 0);
+    return (getAddNodeID(buffer, length) != 0);
 }
 
 bool ModBeeFrame::isDisconnectionFrame(const uint8_t* buffer, uint16_t length) {
@@ -384,7 +1058,7 @@ bool ModBeeFrame::isDisconnectionFrame(const uint8_t* buffer, uint16_t length) {
     }
     
     // Disconnection frame has remove node ID set
-    return (buffer[4] != 0);
+    return (getRemoveNodeID(buffer, length) != 0);
 }
 
 bool ModBeeFrame::isDataFrame(const uint8_t* buffer, uint16_t length) {
@@ -400,19 +1074,25 @@ bool ModBeeFrame::isDataFrame(const uint8_t* buffer, uint16_t length) {
 // FIELD EXTRACTION
 // =============================================================================
 uint8_t ModBeeFrame::getSourceNodeID(const uint8_t* buffer, uint16_t length) {
+    if (isShortTokenFrame(buffer, length)) {
+        return buffer[2];
+    }
     if (!buffer || length < MODBEE_MIN_FRAME_LEN) {
         return 0;
     }
     
-    return buffer[1];
+    return buffer[getHeaderOffset(buffer, length) + 0];
 }
 
 uint8_t ModBeeFrame::getNextMasterID(const uint8_t* buffer, uint16_t length) {
+    if (isShortTokenFrame(buffer, length)) {
+        return buffer[3];
+    }
     if (!buffer || length < MODBEE_MIN_FRAME_LEN) {
         return 0;
     }
     
-    return buffer[2];
+    return buffer[getHeaderOffset(buffer, length) + 1];
 }
 
 uint8_t ModBeeFrame::getAddNodeID(const uint8_t* buffer, uint16_t length) {
@@ -420,7 +1100,7 @@ uint8_t ModBeeFrame::getAddNodeID(const uint8_t* buffer, uint16_t length) {
         return 0;
     }
     
-    return buffer[3];
+    return buffer[getHeaderOffset(buffer, length) + 2];
 }
 
 uint8_t ModBeeFrame::getRemoveNodeID(const uint8_t* buffer, uint16_t length) {
@@ -428,7 +1108,16 @@ uint8_t ModBeeFrame::getRemoveNodeID(const uint8_t* buffer, uint16_t length) {
         return 0;
     }
     
-    return buffer[4];
+    return buffer[getHeaderOffset(buffer, length) + 3];
+}
+
+uint8_t ModBeeFrame::getTokenSequence(const uint8_t* buffer, uint16_t length) {
+    // Legacy frames have no LEN field to carry one
+    if (!buffer || length < MODBEE_V2_MIN_FRAME_LEN || getFrameVersion(buffer, length) != MODBEE_FRAME_VERSION_2) {
+        return 0;
+    }
+    
+    return buffer[2] >> MODBEE_TOKEN_SEQ_SHIFT;
 }
 
 // =============================================================================
@@ -495,7 +1184,7 @@ uint16_t ModBeeFrame::addModbusSection(
 // FRAME SIZE ESTIMATION
 // =============================================================================
 uint16_t ModBeeFrame::estimateFrameSize(const std::vector<PendingModbusOp>& operations) {
-    uint16_t size = MODBEE_MIN_FRAME_LEN; // Header + CRC
+    uint16_t size = getFrameOverhead(); // Header + CRC
     
     if (!operations.empty()) {
         // Group by destination node to estimate sections
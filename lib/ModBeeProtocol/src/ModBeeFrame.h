@@ -6,15 +6,58 @@ public:
     // =============================================================================
     // BASIC FRAME BUILDING - FIX SIGNATURE TO MATCH .CPP
     // =============================================================================
-    static uint16_t buildControlFrame(uint8_t* buffer, uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID);
+    static uint16_t buildControlFrame(uint8_t* buffer, uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID, bool stuffed = false, bool compact = false, uint8_t tokenSequence = 0);
     static uint16_t buildDataFrame(uint8_t* buffer, uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID, const std::vector<PendingModbusOp>& operations, ModBeeProtocol& protocol);
+    static uint16_t buildJoinWindowFrame(uint8_t* buffer, uint8_t srcNodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint32_t slotUs, bool stuffed = false, bool compact = false, uint8_t tokenSequence = 0);
+    static uint16_t buildShortTokenFrame(uint8_t* buffer, uint8_t srcNodeID, uint8_t nextMasterID, uint8_t tokenSequence);
     static uint16_t buildResponseFrame(uint8_t* buffer, uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID, const std::vector<ModbusRequest>& responses);
     
+    // =============================================================================
+    // WIRE FORMAT LAYOUT
+    // =============================================================================
+    static uint16_t writeHeader(uint8_t* buffer, uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID, bool stuffed = false, bool compact = false, uint8_t tokenSequence = 0);
+    static uint16_t finalizeFrame(uint8_t* buffer, uint16_t length);
+    static uint16_t getTransactionSectionLength(bool compact);
+    static uint16_t writeTransactionSection(uint8_t* buffer, uint8_t targetNodeID, uint8_t transactionID, bool compact);
+    static uint16_t getTimeSectionLength(bool multicast);
+    static uint16_t writeTimeSection(uint8_t* buffer, uint8_t targetNodeID, uint8_t group, uint8_t functionCode, uint32_t timeUs, bool compact);
+    static bool readTimeField(const uint8_t* buffer, uint32_t& timeUs);
+    static uint8_t getFrameVersion(const uint8_t* buffer, uint16_t length);
+    static uint16_t getHeaderOffset(const uint8_t* buffer, uint16_t length);
+    static uint16_t getPayloadOffset(const uint8_t* buffer, uint16_t length);
+    static uint16_t getFrameOverhead();
+    
+    // =============================================================================
+    // BYTE STUFFING
+    // =============================================================================
+    static bool isStuffedFrame(const uint8_t* buffer, uint16_t length);
+    static uint16_t stuffFrame(const uint8_t* frame, uint16_t length, const uint16_t* delimiters, uint8_t delimiterCount, uint8_t* out, uint16_t outCapacity);
+    
+    // =============================================================================
+    // COMPACT SECTIONS
+    // =============================================================================
+    static bool isCompactFrame(const uint8_t* buffer, uint16_t length);
+    static uint16_t getCompactRequestLength(const uint8_t* pdu, uint16_t pduLength, bool multicast = false);
+    static uint16_t writeCompactRequest(uint8_t* buffer, uint8_t targetNodeID, const uint8_t* pdu, uint16_t pduLength, uint8_t group = MODBEE_GROUP_ALL);
+    static uint16_t getCompactResponseLength(const ModbusRequest& response, bool multicast = false);
+    static uint16_t writeCompactResponse(uint8_t* buffer, uint8_t targetNodeID, const ModbusRequest& response, uint8_t group = MODBEE_GROUP_ALL);
+    static uint16_t nextCompactSection(const uint8_t* buffer, uint16_t pos, uint16_t end, uint8_t& tag, uint16_t& valueStart, uint16_t& valueEnd);
+    static bool decodeCompactSection(const uint8_t* buffer, uint8_t tag, uint16_t valueStart, uint16_t valueEnd, ModbusRequest& request);
+    static bool getCompactGroup(const uint8_t* buffer, uint16_t valueStart, uint16_t valueEnd, uint8_t& group);
+    static uint8_t getVarintLength(uint16_t value);
+    static uint16_t writeVarint(uint8_t* buffer, uint16_t value);
+    static bool readVarint(const uint8_t* buffer, uint16_t& pos, uint16_t end, uint16_t& value);
+    
     // =============================================================================
     // PARSING
     // =============================================================================
     static bool parseHeader(const uint8_t* buffer, uint16_t bufLen, uint8_t& srcNodeID, uint8_t& nextMasterID, uint8_t& addNodeID, uint8_t& removeNodeID);
+    static bool parseShortToken(const uint8_t* buffer, uint16_t bufLen, uint8_t tokenSequence, uint8_t& srcNodeID, uint8_t& nextMasterID);
+    static bool parseJoinWindow(const uint8_t* buffer, uint16_t bufLen, uint8_t& firstNodeID, uint8_t& lastNodeID, uint8_t& slots, uint32_t& slotUs);
+    static uint8_t getJoinSlot(uint8_t nodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots);
+    static void getJoinSlotRange(uint8_t slot, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint8_t& slotFirst, uint8_t& slotLast);
     static int findModbusSections(const uint8_t* buffer, uint16_t bufLen, std::vector<std::pair<uint16_t, uint16_t>>& sections);
+    static int findModbusSections(const uint8_t* buffer, uint16_t bufLen, const uint16_t* delimiters, uint8_t delimiterCount, std::vector<std::pair<uint16_t, uint16_t>>& sections);
     
     // =============================================================================
     // VALIDATION AND UTILITIES
@@ -40,6 +83,7 @@ public:
     // FRAME TYPE CHECKING
     // =============================================================================
     static bool isTokenFrame(const uint8_t* buffer, uint16_t length);
+    static bool isShortTokenFrame(const uint8_t* buffer, uint16_t length);
     static bool isPresenceFrame(const uint8_t* buffer, uint16_t length);
     static bool isConnectionFrame(const uint8_t* buffer, uint16_t length);
     static bool isDisconnectionFrame(const uint8_t* buffer, uint16_t length);
@@ -52,6 +96,7 @@ public:
     static uint8_t getNextMasterID(const uint8_t* buffer, uint16_t length);
     static uint8_t getAddNodeID(const uint8_t* buffer, uint16_t length);
     static uint8_t getRemoveNodeID(const uint8_t* buffer, uint16_t length);
+    static uint8_t getTokenSequence(const uint8_t* buffer, uint16_t length);
     
     // =============================================================================
     // MODBUS SECTION HANDLING
@@ -66,4 +111,26 @@ public:
     static bool compactFrame(uint8_t* buffer, uint16_t& length);
     static uint16_t estimateFrameSize(const std::vector<PendingModbusOp>& operations);
     
+private:
+    // Fields of one Modbus PDU as carried by a compact section
+    struct CompactFields {
+        uint8_t tag;                    // Type bits, LEN not filled in
+        uint16_t address;
+        uint16_t count;
+        bool hasCount;
+        const uint8_t* data;
+        uint16_t dataLength;
+        uint8_t bit;                    // Storage for a single coil value
+        bool multicast;                 // DEST is MODBEE_BROADCAST_ID, a GROUP byte follows it
+        uint8_t group;
+    };
+    
+    static bool getRequestFields(const uint8_t* pdu, uint16_t pduLength, CompactFields& fields);
+    static bool getResponseFields(const ModbusRequest& response, CompactFields& fields);
+    static uint16_t getCompactValueLength(const CompactFields& fields);
+    static uint16_t getCompactSectionLength(const CompactFields& fields);
+    static uint16_t writeCompactFields(uint8_t* buffer, uint8_t targetNodeID, const CompactFields& fields);
+    static uint8_t getShortTokenCheck(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t tokenSequence);
+    static bool getRegisterType(uint8_t functionCode, uint8_t& type);
+    static uint8_t getReadFunction(uint8_t type);
 };
\ No newline at end of file
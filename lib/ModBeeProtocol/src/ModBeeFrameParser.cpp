@@ -0,0 +1,180 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// CONSTRUCTOR AND SETUP
+// =============================================================================
+ModBeeFrameParser::ModBeeFrameParser()
+    : _buffer(nullptr), _capacity(0) {
+    reset();
+}
+
+void ModBeeFrameParser::attach(uint8_t* buffer, uint16_t capacity) {
+    _buffer = buffer;
+    _capacity = capacity;
+    reset();
+}
+
+void ModBeeFrameParser::reset() {
+    _pos = 0;
+    _expectedLen = 0;
+    _frameLen = 0;
+    _crc = 0xFFFF;
+    _state = RX_HUNT;
+    _stuffed = false;
+    _escapePending = false;
+    _escapeCount = 0;
+    _delimiterCount = 0;
+}
+
+// =============================================================================
+// BYTE PROCESSING
+// =============================================================================
+ModBeeFrameParser::Result ModBeeFrameParser::feed(uint8_t byte) {
+    if (!_buffer || _capacity < MODBEE_MIN_FRAME_LEN) {
+        return RX_OVERFLOW;
+    }
+
+    // Ignore line noise between frames
+    if (_state == RX_HUNT) {
+        return (byte == MODBEE_SOF) ? restart(byte) : RX_PENDING;
+    }
+
+    // Stuffed frames: raw SOF always starts a new frame, escapes are undone here
+    bool isDelimiter = false;
+    if (_stuffed) {
+        if (byte == MODBEE_SOF) {
+            return restart(byte);
+        }
+        if (_escapePending) {
+            byte ^= MODBEE_ESCAPE_XOR;
+            _escapePending = false;
+            _escapeCount++;
+        } else if (byte == MODBEE_ESCAPE) {
+            _escapePending = true;
+            return RX_PENDING;
+        } else if (byte == MODBEE_PACKET_DELIM) {
+            isDelimiter = true;
+        }
+    }
+
+    switch (_state) {
+        case RX_VERSION:
+            if (byte == MODBEE_SOF) {
+                return restart(byte);
+            }
+            store(byte);
+            if (byte == MODBEE_SHORT_TOKEN_MARKER) {
+                _expectedLen = MODBEE_SHORT_TOKEN_LEN;
+                _state = RX_BODY_SHORT;
+            } else if (byte == MODBEE_FRAME_V2_MARKER || byte == MODBEE_FRAME_V2_STUFFED_MARKER ||
+                byte == MODBEE_FRAME_V2_COMPACT_MARKER) {
+                _stuffed = (byte == MODBEE_FRAME_V2_STUFFED_MARKER);
+                _state = RX_LENGTH_HIGH;
+            } else {
+                _state = RX_BODY_LEGACY;
+            }
+            return RX_PENDING;
+
+        case RX_LENGTH_HIGH:
+            if (byte == MODBEE_SOF) {
+                return restart(byte); // Length high byte can never be 0x7E
+            }
+            store(byte);
+            _expectedLen = (uint16_t)(byte & MODBEE_FRAME_LEN_H_MASK) << 8; // Bits 7-3 carry the token sequence
+            _state = RX_LENGTH_LOW;
+            return RX_PENDING;
+
+        case RX_LENGTH_LOW:
+            // Length counts unstuffed bytes, SOF through CRC
+            store(byte);
+            _expectedLen |= byte;
+            if (_expectedLen < MODBEE_V2_MIN_FRAME_LEN || _expectedLen > MODBEE_MAX_RX_BUFFER) {
+                reset();
+                return RX_FRAMING_ERROR;
+            }
+            if (_expectedLen > _capacity) {
+                reset();
+                return RX_OVERFLOW;
+            }
+            _state = RX_BODY_V2;
+            return RX_PENDING;
+
+        case RX_BODY_V2:
+            // Length-delimited: in plain frames SOF inside the body is data, not a restart
+            // Raw 0x7C past the 8-byte v2 header is a section delimiter in stuffed frames
+            if (isDelimiter && _pos >= 8) {
+                if (_delimiterCount >= MODBEE_MAX_FRAME_SECTIONS) {
+                    reset();
+                    return RX_OVERFLOW;
+                }
+                _delimiters[_delimiterCount++] = _pos;
+            }
+            store(byte);
+            if (_pos < _expectedLen) {
+                return RX_PENDING;
+            }
+            _frameLen = _pos;
+            _state = RX_HUNT;
+            return crcMatches() ? RX_FRAME_COMPLETE : RX_CRC_ERROR;
+
+        case RX_BODY_SHORT:
+            // Fixed length like v2: SRC, NEXT and the check byte may all be 0x7E
+            store(byte);
+            if (_pos < _expectedLen) {
+                return RX_PENDING;
+            }
+            _frameLen = _pos;
+            _state = RX_HUNT;
+            return RX_FRAME_COMPLETE;
+
+        case RX_BODY_LEGACY:
+            if (byte == MODBEE_SOF) {
+                return restart(byte); // Legacy frames always restart on SOF
+            }
+            if (_pos >= _capacity) {
+                reset();
+                return RX_OVERFLOW;
+            }
+            store(byte);
+            // Legacy frames have no length: first CRC match ends the frame
+            if (_pos >= MODBEE_MIN_FRAME_LEN && crcMatches()) {
+                _frameLen = _pos;
+                _state = RX_HUNT;
+                return RX_FRAME_COMPLETE;
+            }
+            return RX_PENDING;
+
+        default:
+            break;
+    }
+
+    return RX_PENDING;
+}
+
+// =============================================================================
+// INTERNAL HELPERS
+// =============================================================================
+ModBeeFrameParser::Result ModBeeFrameParser::restart(uint8_t byte) {
+    // Anything past a lone SOF was a partial frame
+    bool aborted = (_state != RX_HUNT && _pos > 1);
+
+    reset();
+    store(byte);
+    _state = RX_VERSION;
+
+    return aborted ? RX_ABORTED : RX_PENDING;
+}
+
+void ModBeeFrameParser::store(uint8_t byte) {
+    _buffer[_pos++] = byte;
+
+    // Keep the running CRC two bytes behind so the trailing CRC is never folded in
+    if (_pos > 2) {
+        _crc = ModBeeCRC::update(_crc, _buffer[_pos - 3]);
+    }
+}
+
+bool ModBeeFrameParser::crcMatches() const {
+    uint16_t receivedCRC = ((uint16_t)_buffer[_pos - 2] << 8) | _buffer[_pos - 1];
+    return _crc == receivedCRC;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+/**
+ * ModBee incremental frame parser
+ * Byte-at-a-time RX state machine: O(1) work per received byte, CRC folded in
+ * as bytes arrive. Handles v2 (length-prefixed), byte-stuffed v2, compact v2,
+ * short token passes and legacy (CRC-delimited) frames. A short token's check
+ * byte covers the receiver's token sequence, so ModBeeIO verifies it. Stuffed frames are unescaped in place and their
+ * section delimiter positions recorded.
+ */
+class ModBeeFrameParser {
+public:
+    // =============================================================================
+    // PARSER RESULTS
+    // =============================================================================
+    enum Result {
+        RX_PENDING,             // Byte consumed, frame not complete yet
+        RX_FRAME_COMPLETE,      // Frame complete and CRC valid (short tokens: checked by the caller)
+        RX_CRC_ERROR,           // v2 frame complete but CRC mismatch
+        RX_FRAMING_ERROR,       // Invalid length field or byte outside a frame
+        RX_OVERFLOW,            // Frame larger than the attached buffer
+        RX_ABORTED              // SOF arrived mid-frame, partial frame dropped
+    };
+
+    // =============================================================================
+    // CONSTRUCTOR AND SETUP
+    // =============================================================================
+    ModBeeFrameParser();
+    void attach(uint8_t* buffer, uint16_t capacity);
+    void reset();
+
+    // =============================================================================
+    // BYTE PROCESSING
+    // =============================================================================
+    Result feed(uint8_t byte);
+
+    // =============================================================================
+    // FRAME ACCESS
+    // =============================================================================
+    const uint8_t* getFrame() const { return _buffer; }
+    uint16_t getFrameLength() const { return _frameLen; }
+    uint16_t getBufferedBytes() const { return (_state == RX_HUNT) ? 0 : _pos; }
+    bool isIdle() const { return _state == RX_HUNT; }
+    bool isStuffed() const { return _stuffed; }
+    uint16_t getEscapeCount() const { return _escapeCount; }
+    const uint16_t* getDelimiters() const { return _delimiters; }
+    uint8_t getDelimiterCount() const { return _delimiterCount; }
+
+private:
+    // =============================================================================
+    // RX STATES
+    // =============================================================================
+    enum State {
+        RX_HUNT,                // Waiting for SOF
+        RX_VERSION,             // SOF seen, next byte selects v2 or legacy
+        RX_LENGTH_HIGH,         // v2 length high byte
+        RX_LENGTH_LOW,          // v2 length low byte
+        RX_BODY_V2,             // v2 body, ends at declared length
+        RX_BODY_SHORT,          // Short token pass, fixed length
+        RX_BODY_LEGACY          // Legacy body, ends at first CRC match
+    };
+
+    uint8_t* _buffer;
+    uint16_t _capacity;
+    uint16_t _pos;
+    uint16_t _expectedLen;
+    uint16_t _frameLen;
+    uint16_t _crc;
+    State _state;
+
+    // Byte stuffing state
+    bool _stuffed;
+    bool _escapePending;
+    uint16_t _escapeCount;
+    uint16_t _delimiters[MODBEE_MAX_FRAME_SECTIONS];
+    uint8_t _delimiterCount;
+
+    Result restart(uint8_t byte);
+    void store(uint8_t byte);
+    bool crcMatches() const;
+};
@@ -8,8 +8,11 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <stdarg.h>
+#include <limits.h>
 #include <stdio.h>
 
 // =============================================================================
@@ -25,13 +28,24 @@ class ModbusDataMap;
 // =============================================================================
 // Core ModBee library headers - include all in correct dependency order
 #include "ModBeeTypes.h"          // Basic types and constants
+#include "ModBeeCRC.h"            // Shared CRC-16 engine
+#include "ModBeeNodeSet.h"        // 256-bit node ID set
 #include "ModBeeTransport.h"      // Transport layer interface
+#include "ModBeeUartTransport.h"  // ESP-IDF UART event-queue transport (ESP32 only)
+#include "ModBeeLoopbackTransport.h" // In-memory multi-node bus
 #include "ModbusDataMap.h"        // Local data storage
 #include "ModbusFrame.h"          // Pure Modbus frame handling
+#include "ModBeeTimerQueue.h"     // Timeout queue over fixed slots
+#include "ModBeeOpPool.h"         // Fixed-capacity operation pool
 #include "ModBeeOperations.h"     // Operation queue management
+#include "ModBeeCyclicData.h"     // Publish/subscribe tables
 #include "ModbusHandler.h"        // Modbus request processing
+#include "ModBeeNetworkTime.h"    // Network time base and scheduled writes
 #include "ModBeeFrame.h"          // ModBee frame handling
+#include "ModBeeFrameParser.h"    // Incremental RX frame parser
 #include "ModBeeIO.h"             // IO operations
 #include "ModBeeProtocol.h"       // Main protocol class
+#include "ModBeeRequest.h"        // Async request handle
+#include "ModBeePollTable.h"      // Periodic reads batched per token hold
 #include "ModBeeAPI.h"            // High-level API
 #include "ModBeeDebug.h"          // Debugging utilities
\ No newline at end of file
@@ -4,15 +4,41 @@
 // CONSTRUCTOR AND DESTRUCTOR
 // =============================================================================
 ModBeeIO::ModBeeIO(ModBeeProtocol& protocol) 
-    : _protocol(protocol), 
-      _stream(nullptr), 
-      _primaryRxPos(0),
-      _processingBufferLen(0),
+    : _rxAvailable(false),
       _lastBusActivity(0),
-      _rxAvailable(false) {
-    
-    // Initialize frame queue
-    _frameQueue.clear();
+      _protocol(protocol), 
+      _transport(nullptr), 
+      _rxRingHead(0),
+      _rxParserOffset(0),
+      _rxFrameFirst(0),
+      _rxFrameCount(0),
+      _processingBuffer(nullptr),
+      _processingBufferLen(0),
+      _processingStuffed(false),
+      _processingDelimiters(nullptr),
+      _processingDelimiterCount(0),
+      _processingWireLength(0),
+      _rxTransactionID(0),
+      _rxApplyAtUs(0),
+      _rxTimingCurrent(false),
+      _txMulticastCount(0),
+      _lastRxActivityUs(0),
+      _lastRxReadUs(0),
+      _lastRxIdleUs(0),
+      _lastTxEndUs(0),
+      _lastPollUs(0),
+      _exactRxTimestamps(false),
+      _rxLatencyMeanUs(0),
+      _rxLatencyDevUs(0),
+      _silenceMeanUs(0),
+      _silenceDevUs(0),
+      _frameSilenceUs(0),
+      _statsStartMs(0),
+      _joinMonitorStartUs(0),
+      _joinMonitorSlotUs(0),
+      _joinMonitorSlots(0),
+      _joinSlotActivity(0),
+      _joinSlotErrors(0) {
     
     // Initialize statistics
     resetStatistics();
@@ -25,19 +51,36 @@ ModBeeIO::~ModBeeIO() {
 // =============================================================================
 // INITIALIZATION
 // =============================================================================
-bool ModBeeIO::begin(Stream* serialStream) {
-    if (!serialStream) {
+bool ModBeeIO::begin(ModBeeTransport* transport) {
+    if (!transport) {
         return false;
     }
     
-    _stream = serialStream;
-    _primaryRxPos = 0;
+    _transport = transport;
     _processingBufferLen = 0;
     _lastBusActivity = 0;
     _rxAvailable = false;
     
-    // Clear frame queue
-    _frameQueue.clear();
+    // Bus timing starts over; the gap re-adapts to this transport
+    uint32_t now = micros();
+    _lastRxActivityUs = now;
+    _lastRxReadUs = now;
+    _lastRxIdleUs = 0;
+    _lastTxEndUs = now;
+    _lastPollUs = now;
+    _exactRxTimestamps = false;
+    _rxLatencyMeanUs = 0;
+    _rxLatencyDevUs = 0;
+    _silenceMeanUs = 0;
+    _silenceDevUs = 0;
+    _frameSilenceUs = 0;
+    _joinMonitorSlots = 0;
+    
+    // Clear RX ring and frame queue
+    _rxRingHead = 0;
+    _rxFrameFirst = 0;
+    _rxFrameCount = 0;
+    attachRxSpace();
     
     // Reset statistics
     resetStatistics();
@@ -46,153 +89,367 @@ bool ModBeeIO::begin(Stream* serialStream) {
 }
 
 // =============================================================================
-// MAIN PROCESSING LOOP - DOUBLE BUFFER SYSTEM
+// MAIN PROCESSING LOOP - ZERO-COPY RX RING
 // =============================================================================
 void ModBeeIO::processIncoming() {
-    if (!_stream) {
+    if (!_transport) {
         return;
     }
     
-    // Step 1: Continuously fill primary buffer
+    // Step 1: Pull received bytes in chunks and feed them through the incremental frame parser
     bool dataReceived = false;
-    while (_stream->available() && _primaryRxPos < MODBEE_MAX_RX_BUFFER - 1) {
-        int incomingByte = _stream->read();
-        if (incomingByte == -1) break;
-        
-        uint8_t byte = (uint8_t)incomingByte;
+    bool rxError = false;
+    uint8_t chunk[MODBEE_RX_CHUNK_SIZE];
+    size_t chunkLen = 0;
+    size_t chunkPos = 0;
+    
+    for (;;) {
+        if (chunkPos == chunkLen) {
+            int ready = _transport->available();
+            if (ready <= 0) break;
+            
+            chunkLen = _transport->read(chunk, std::min((size_t)ready, sizeof(chunk)));
+            chunkPos = 0;
+            if (chunkLen == 0) break;
+            
+            _lastBusActivity = millis();
+            _stats.rxBytes += chunkLen;
+            dataReceived = true;
+        }
         
-        // SOF detection - always restart frame
-        if (byte == MODBEE_SOF) {
-            _primaryRxPos = 0;  // Reset to start new frame
-            //MBEE_DEBUG_IO("RX: SOF detected, starting new frame");
+        // Between frames, point the parser at free ring space (ring full: drain it first)
+        if (_rxParser.isIdle() && !attachRxSpace()) {
+            processQueuedFrames();
+            attachRxSpace();
         }
         
-        _primaryRxBuffer[_primaryRxPos++] = byte;
-        _lastBusActivity = millis();
-        dataReceived = true;
+        switch (_rxParser.feed(chunk[chunkPos++])) {
+            case ModBeeFrameParser::RX_FRAME_COMPLETE:
+                queueCompleteFrame();
+                break;
+            case ModBeeFrameParser::RX_CRC_ERROR:
+                incrementCrcError();
+                _protocol.reportError(MBEE_CRC_ERROR, "CRC verification failed");
+                rxError = true;
+                break;
+            case ModBeeFrameParser::RX_FRAMING_ERROR:
+                incrementFramingError();
+                rxError = true;
+                break;
+            case ModBeeFrameParser::RX_OVERFLOW:
+                incrementBufferOverflow();
+                rxError = true;
+                break;
+            case ModBeeFrameParser::RX_ABORTED:
+                _stats.framesAborted++;
+                rxError = true;
+                break;
+            default:
+                break;
+        }
     }
     
-    // Update availability flag
-    _rxAvailable = dataReceived; //(_stream->available() > 0);
+    // Update availability flag and the bus idle reference
+    _rxAvailable = dataReceived;
+    updateRxTiming(dataReceived, micros());
+    updateJoinWindowMonitor(dataReceived, rxError);
     
-    // Step 2: Extract complete frames from primary buffer (if any new data)
+    // Step 2: Process any queued complete frames. Only now do the timestamps
+    // belong to the newest of them (the ring may have been drained in step 1)
+    _rxTimingCurrent = true;
+    processQueuedFrames();
+    _rxTimingCurrent = false;
+}
+
+// =============================================================================
+// BUS TIMING
+// =============================================================================
+void ModBeeIO::updateRxTiming(bool dataReceived, uint32_t now) {
     if (dataReceived) {
-        extractCompleteFrames();
+        // Bytes after at least t3.5 of silence start a frame: keep the silence before it
+        // until the sender is known
+        uint32_t baudRate = getBaudRate();
+        int32_t silenceUs = getBusIdleUs(now);
+        if (baudRate != 0 && silenceUs >= (int32_t)(38500000UL / baudRate)) {
+            _frameSilenceUs = silenceUs;
+        }
+        
+        // Polled timestamp: the bytes landed some time since the previous poll
+        _lastRxActivityUs = now;
+        _lastRxReadUs = now;
+        if (!_exactRxTimestamps) {
+            addRxLatencySample(now - _lastPollUs);
+        }
     }
     
-    // Step 3: Process any queued complete frames
-    processQueuedFrames();
+    // The transport's line-idle time (RX idle interrupt) replaces the polled one
+    uint32_t idleUs;
+    if (_transport->getLastRxIdleUs(idleUs) && idleUs != _lastRxIdleUs) {
+        _exactRxTimestamps = true;
+        _lastRxIdleUs = idleUs;
+        _lastRxActivityUs = idleUs;
+        if ((int32_t)(_lastRxReadUs - idleUs) >= 0) {
+            addRxLatencySample(_lastRxReadUs - idleUs);
+        }
+    }
+    
+    // Keep both references within int32 range of now on a long-silent bus
+    const int32_t maxAgeUs = 0x40000000;
+    if ((int32_t)(now - _lastRxActivityUs) > maxAgeUs) {
+        _lastRxActivityUs = now - maxAgeUs;
+    }
+    if ((int32_t)(now - _lastTxEndUs) > maxAgeUs) {
+        _lastTxEndUs = now - maxAgeUs;
+    }
+    
+    _lastPollUs = now;
+}
+
+void ModBeeIO::addRxLatencySample(uint32_t sampleUs) {
+    int32_t sample = (int32_t)std::min(sampleUs, (uint32_t)MODBEE_MAX_INTERFRAME_GAP_US);
+    
+    if (_rxLatencyMeanUs == 0 && _rxLatencyDevUs == 0) {
+        _rxLatencyMeanUs = sample;
+        _rxLatencyDevUs = sample / 2;
+        return;
+    }
+    
+    // Mean gain 1/8, deviation gain 1/4 (TCP SRTT / RTTVAR)
+    int32_t error = sample - (int32_t)_rxLatencyMeanUs;
+    _rxLatencyMeanUs = (int32_t)_rxLatencyMeanUs + error / 8;
+    _rxLatencyDevUs = (int32_t)_rxLatencyDevUs + ((error < 0 ? -error : error) - (int32_t)_rxLatencyDevUs) / 4;
+}
+
+void ModBeeIO::addSilenceSample(uint32_t sampleUs) {
+    // A stall is at most the static token pass timeout, however long the bus was dead
+    uint32_t maxUs = (ModBeeAPI::TOKEN_RESPONSE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * 1000UL;
+    int32_t sample = (int32_t)std::min(sampleUs, maxUs);
+    
+    if (_silenceMeanUs == 0 && _silenceDevUs == 0) {
+        _silenceMeanUs = sample;
+        _silenceDevUs = sample / 2;
+        return;
+    }
+    
+    int32_t error = sample - (int32_t)_silenceMeanUs;
+    _silenceMeanUs = (int32_t)_silenceMeanUs + error / 8;
+    _silenceDevUs = (int32_t)_silenceDevUs + ((error < 0 ? -error : error) - (int32_t)_silenceDevUs) / 4;
+}
+
+void ModBeeIO::takeSilenceSample(uint8_t srcNodeID) {
+    // Only a hand-over answered by the node the token went to is a sample: the
+    // silence before a retry or a reclaim ended in a timeout (like Karn's rule
+    // for retransmitted segments) and would only stretch the limit further
+    if (_frameSilenceUs != 0 && srcNodeID == _protocol.getLastTokenTarget()) {
+        addSilenceSample(_frameSilenceUs);
+    }
+    _frameSilenceUs = 0;
+}
+
+uint32_t ModBeeIO::getSilenceLimitUs() const {
+    // Every node times the same hand-overs, so the whole ring agrees on this closely
+    if (_silenceMeanUs == 0 && _silenceDevUs == 0) {
+        return 0;
+    }
+    return _silenceMeanUs + 4 * _silenceDevUs;
+}
+
+int32_t ModBeeIO::getBusIdleUs(uint32_t now) const {
+    // Busy until both the last received byte and our own last byte are past
+    int32_t sinceRx = (int32_t)(now - _lastRxActivityUs);
+    int32_t sinceTx = (int32_t)(now - _lastTxEndUs);
+    return std::min(sinceRx, sinceTx);
+}
+
+uint32_t ModBeeIO::getBaudRate() const {
+    if (ModBeeAPI::MODBEE_BAUD_RATE != 0) {
+        return ModBeeAPI::MODBEE_BAUD_RATE;
+    }
+    return _transport ? _transport->getBaudRate() : 0;
+}
+
+uint32_t ModBeeIO::getAirTimeBytes(uint32_t durationUs) const {
+    uint32_t baudRate = getBaudRate();
+    if (baudRate == 0) {
+        // Unknown line speed: any remaining time allows any amount
+        return durationUs > 0 ? UINT32_MAX : 0;
+    }
+    uint64_t bytes = (uint64_t)durationUs * baudRate / (MODBEE_BITS_PER_BYTE * 1000000ULL);
+    return bytes < UINT32_MAX ? (uint32_t)bytes : UINT32_MAX;
+}
+
+uint32_t ModBeeIO::getAirTimeUs(uint32_t bytes) const {
+    uint32_t baudRate = getBaudRate();
+    if (baudRate == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)bytes * MODBEE_BITS_PER_BYTE * 1000000ULL / baudRate);
+}
+
+uint32_t ModBeeIO::getInterFrameGapUs() const {
+    // A fixed gap, when configured, wins
+    if (ModBeeAPI::MODBEE_INTERFRAME_GAP_US != 0) {
+        return ModBeeAPI::MODBEE_INTERFRAME_GAP_US;
+    }
+    
+    uint32_t baudRate = getBaudRate();
+    if (baudRate == 0) {
+        return MODBEE_DEFAULT_INTERFRAME_GAP_US;
+    }
+    
+    // Modbus t3.5 (3.5 characters of 11 bits). Instead of Modbus' fixed 1750 us
+    // above 19200 baud, add how late we may be seeing the line: mean + 4 deviations
+    uint32_t gapUs = 38500000UL / baudRate + _rxLatencyMeanUs + 4 * _rxLatencyDevUs;
+    return std::min(gapUs, (uint32_t)MODBEE_MAX_INTERFRAME_GAP_US);
+}
+
+// =============================================================================
+// JOIN WINDOW MONITOR
+// =============================================================================
+void ModBeeIO::beginJoinWindowMonitor(uint32_t startUs, uint32_t slotUs, uint8_t slots) {
+    _joinMonitorStartUs = startUs;
+    _joinMonitorSlotUs = slotUs;
+    _joinMonitorSlots = std::min(slots, (uint8_t)MODBEE_MAX_JOIN_SLOTS);
+    _joinSlotActivity = 0;
+    _joinSlotErrors = 0;
+}
+
+void ModBeeIO::updateJoinWindowMonitor(bool dataReceived, bool rxError) {
+    if (_joinMonitorSlots == 0 || !dataReceived || _joinMonitorSlotUs == 0) {
+        return;
+    }
+    
+    // Attribute what arrived to the slot the line went quiet in. Responses sit in
+    // the middle of their slot, so timestamp jitter below half a slot is harmless
+    int32_t offsetUs = (int32_t)(_lastRxActivityUs - _joinMonitorStartUs);
+    if (offsetUs < 0) {
+        return;
+    }
+    uint32_t slot = (uint32_t)offsetUs / _joinMonitorSlotUs;
+    if (slot >= _joinMonitorSlots) {
+        return;
+    }
+    
+    _joinSlotActivity |= 1UL << slot;
+    if (rxError) {
+        _joinSlotErrors |= 1UL << slot;
+    }
 }
 
 // =============================================================================
-// FRAME EXTRACTION FROM PRIMARY BUFFER
+// RX RING SPACE MANAGEMENT
 // =============================================================================
-void ModBeeIO::extractCompleteFrames() {
-    uint16_t searchPos = 0;
+bool ModBeeIO::attachRxSpace() {
+    uint16_t offset = 0;
+    uint16_t space = MODBEE_RX_RING_SIZE;
     
-    while (searchPos < _primaryRxPos) {
-        uint16_t frameStart, frameEnd;
+    if (_rxFrameCount == 0) {
+        // Ring empty: restart at the front
+        _rxRingHead = 0;
+    } else {
+        // Free space is [head, tail), or [head, end) and [0, tail) when wrapped
+        uint16_t tail = _rxFrames[_rxFrameFirst].offset;
         
-        if (findNextCompleteFrame(frameStart, frameEnd)) {
-            // Found a complete frame!
-            if (_frameQueue.size() < MAX_FRAME_QUEUE) {
-                CompleteFrame frame;
-                frame.length = frameEnd - frameStart;
-                
-                // Copy complete frame to queue
-                memcpy(frame.data, &_primaryRxBuffer[frameStart], frame.length);
-                _frameQueue.push_back(frame);
-                
-                //MBEE_DEBUG_IO("EXTRACTED: Complete frame queued (len:%d, queue:%d)", 
-                //    frame.length, _frameQueue.size());
-            } else {
-                incrementBufferOverflow();
+        if (_rxRingHead > tail) {
+            offset = _rxRingHead;
+            space = MODBEE_RX_RING_SIZE - _rxRingHead;
+            if (space < RX_FRAME_SLOT) {
+                offset = 0;
+                space = tail;
             }
-            
-            // Remove processed frame from primary buffer
-            shiftPrimaryBuffer(frameEnd);
-            searchPos = 0; // Start over after shift
+        } else if (_rxRingHead < tail) {
+            offset = _rxRingHead;
+            space = tail - _rxRingHead;
         } else {
-            break; // No more complete frames
+            space = 0; // Head caught up with tail: full
         }
     }
+    
+    // Only start a frame where the largest possible one fits
+    if (space < RX_FRAME_SLOT || _rxFrameCount >= MODBEE_MAX_FRAME_QUEUE) {
+        return false;
+    }
+    
+    _rxParser.attach(&_rxRing[offset], MODBEE_MAX_RX_BUFFER);
+    _rxParserOffset = offset;
+    return true;
 }
 
 // =============================================================================
-// FIND NEXT COMPLETE FRAME IN PRIMARY BUFFER
+// QUEUE A COMPLETE FRAME FROM THE PARSER
 // =============================================================================
-bool ModBeeIO::findNextCompleteFrame(uint16_t& frameStart, uint16_t& frameEnd) {
-    // Find SOF marker
-    frameStart = 0;
-    while (frameStart < _primaryRxPos && _primaryRxBuffer[frameStart] != MODBEE_SOF) {
-        frameStart++;
-    }
-    
-    if (frameStart >= _primaryRxPos) {
-        return false; // No SOF found
+void ModBeeIO::queueCompleteFrame() {
+    RxFrameDescriptor& frame = _rxFrames[(_rxFrameFirst + _rxFrameCount) % MODBEE_MAX_FRAME_QUEUE];
+    frame.offset = _rxParserOffset;
+    frame.length = _rxParser.getFrameLength();
+    frame.stuffed = _rxParser.isStuffed();
+    frame.wireLength = frame.length;
+    frame.delimiterCount = 0;
+    frame.delimiterOffset = 0;
+    
+    uint16_t used = frame.length;
+    
+    // Stuffed frames keep their delimiter positions right behind the frame (data 0x7C is not a boundary)
+    if (frame.stuffed) {
+        uint8_t count = _rxParser.getDelimiterCount();
+        uint16_t delimiterOffset = (frame.length + 1) & ~1; // uint16_t alignment
+        uint16_t delimiterBytes = count * sizeof(uint16_t);
+        
+        memcpy(&_rxRing[frame.offset + delimiterOffset], _rxParser.getDelimiters(), delimiterBytes);
+        frame.delimiterOffset = frame.offset + delimiterOffset;
+        frame.delimiterCount = count;
+        used = delimiterOffset + delimiterBytes;
+        
+        _stats.stuffedFramesReceived++;
+        _stats.rxEscapeBytes += _rxParser.getEscapeCount();
+        frame.wireLength += _rxParser.getEscapeCount();
     }
     
-    // Look for complete frame starting at frameStart
-    for (uint16_t testEnd = frameStart + MODBEE_MIN_FRAME_LEN; testEnd <= _primaryRxPos; testEnd++) {
-        // Test if we have a complete frame from frameStart to testEnd
-        if (ModBeeFrame::isValidFrame(&_primaryRxBuffer[frameStart], testEnd - frameStart)) {
-            frameEnd = testEnd;
-            return true;
-        }
+    // Next frame starts 4-byte aligned after this one
+    _rxRingHead = (frame.offset + used + 3) & ~3;
+    if (_rxRingHead > MODBEE_RX_RING_SIZE) {
+        _rxRingHead = MODBEE_RX_RING_SIZE;
     }
-    
-    return false; // Frame not complete yet
+    _rxFrameCount++;
 }
 
 // =============================================================================
 // PROCESS ALL QUEUED COMPLETE FRAMES
 // =============================================================================
 void ModBeeIO::processQueuedFrames() {
-    while (!_frameQueue.empty()) {
-        CompleteFrame frame = _frameQueue.front();
-        _frameQueue.pop_front();  // O(1) operation instead of O(n)!
+    while (_rxFrameCount > 0) {
+        const RxFrameDescriptor& frame = _rxFrames[_rxFrameFirst];
         
-        // Copy to processing buffer
-        memcpy(_processingBuffer, frame.data, frame.length);
+        // Process in place - no copy out of the ring
+        _processingBuffer = &_rxRing[frame.offset];
         _processingBufferLen = frame.length;
+        _processingStuffed = frame.stuffed;
+        _processingDelimiters = (const uint16_t*)&_rxRing[frame.delimiterOffset];
+        _processingDelimiterCount = frame.delimiterCount;
+        _processingWireLength = frame.wireLength;
         
-        // Process this complete frame safely
         processCompleteFrame();
         
-        //MBEE_DEBUG_IO("PROCESSED: Frame from queue (len:%d, remaining:%d)", 
-        //    frame.length, _frameQueue.size());
+        // Release the frame's ring space
+        _rxFrameFirst = (_rxFrameFirst + 1) % MODBEE_MAX_FRAME_QUEUE;
+        _rxFrameCount--;
     }
 }
 
-// =============================================================================
-// SHIFT PRIMARY BUFFER TO REMOVE PROCESSED DATA
-// =============================================================================
-void ModBeeIO::shiftPrimaryBuffer(uint16_t shiftAmount) {
-    if (shiftAmount >= _primaryRxPos) {
-        _primaryRxPos = 0; // Clear entire buffer
-        return;
-    }
-    
-    // Shift remaining data to front
-    memmove(_primaryRxBuffer, &_primaryRxBuffer[shiftAmount], _primaryRxPos - shiftAmount);
-    _primaryRxPos -= shiftAmount;
-}
-
 // =============================================================================
 // SAFE FRAME PROCESSING (ISOLATED PROCESSING BUFFER)
 // =============================================================================
 void ModBeeIO::processCompleteFrame() {
-    if (_processingBufferLen < MODBEE_MIN_FRAME_LEN) {
+    if (ModBeeFrame::isShortTokenFrame(_processingBuffer, _processingBufferLen)) {
+        processShortToken();
         return;
     }
     
-    // Verify CRC on isolated processing buffer
-    if (!ModBeeFrame::verifyCRC(_processingBuffer, _processingBufferLen)) {
-        incrementCrcError();
-        _protocol.reportError(MBEE_CRC_ERROR, "CRC verification failed");
+    if (_processingBufferLen < MODBEE_MIN_FRAME_LEN) {
         return;
     }
     
+    // CRC already verified byte-by-byte by the RX parser
     incrementFrameReceived();
     
     // Parse header from processing buffer
@@ -203,16 +460,43 @@ void ModBeeIO::processCompleteFrame() {
         return;
     }
     
-    // Update node seen
+    // Update node seen and the frame format it uses (drives stuffing, section format and sequence negotiation)
+    // Nodes sending compact sections understand stuffed frames as well
+    bool compact = ModBeeFrame::isCompactFrame(_processingBuffer, _processingBufferLen);
+    uint8_t tokenSequence = ModBeeFrame::getTokenSequence(_processingBuffer, _processingBufferLen);
+    takeSilenceSample(srcNodeID);
     _protocol.updateNodeSeen(srcNodeID);
+    _protocol.updateNodeStuffing(srcNodeID, _processingStuffed || compact);
+    _protocol.updateNodeSectionFormat(srcNodeID, compact);
+    _protocol.updateNodeTokenSequence(srcNodeID, tokenSequence);
+    _protocol.updateNodeWork(srcNodeID, true);
+    if (compact) {
+        _stats.compactFramesReceived++;
+    }
+    
+    // Join windows carry their own payload and no Modbus data or ring changes
+    if (removeNodeID == MODBEE_JOIN_WINDOW) {
+        uint8_t firstNodeID, lastNodeID, slots;
+        uint32_t slotUs;
+        if (ModBeeFrame::parseJoinWindow(_processingBuffer, _processingBufferLen, firstNodeID, lastNodeID, slots, slotUs)) {
+            _protocol.handleJoinWindow(srcNodeID, firstNodeID, lastNodeID, slots, slotUs);
+        } else {
+            incrementFramingError();
+        }
+        return;
+    }
     
     // PRIORITY 1: Process any Modbus data FIRST (time-critical for synchronized outputs)
     if (ModBeeFrame::hasModbusData(_processingBuffer, _processingBufferLen)) {
-        processModbusData(srcNodeID);
+        if (compact) {
+            processCompactSections(srcNodeID);
+        } else {
+            processModbusData(srcNodeID);
+        }
     }
     
     // PRIORITY 2: Handle control frame aspects (less time-critical)
-    handleControlFrame(srcNodeID, nextMasterID, addNodeID, removeNodeID);
+    handleControlFrame(srcNodeID, nextMasterID, addNodeID, removeNodeID, tokenSequence);
     
     /*
 
@@ -230,10 +514,28 @@ void ModBeeIO::processCompleteFrame() {
     */
 }
 
+void ModBeeIO::processShortToken() {
+    // The check byte also covers our token sequence: a pass of a reclaimed token fails it
+    uint8_t srcNodeID, nextMasterID;
+    uint8_t tokenSequence = _protocol.getTokenSequence();
+    if (!ModBeeFrame::parseShortToken(_processingBuffer, _processingBufferLen, tokenSequence, srcNodeID, nextMasterID)) {
+        incrementCrcError();
+        return;
+    }
+    
+    // Says nothing about the sender's frame formats, only that it had nothing to send
+    incrementFrameReceived();
+    _stats.shortTokensReceived++;
+    takeSilenceSample(srcNodeID);
+    _protocol.updateNodeSeen(srcNodeID);
+    _protocol.updateNodeWork(srcNodeID, false);
+    handleControlFrame(srcNodeID, nextMasterID, 0, 0, tokenSequence);
+}
+
 // =============================================================================
 // CONTROL FRAME HANDLING
 // =============================================================================
-void ModBeeIO::handleControlFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID) {
+void ModBeeIO::handleControlFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID, uint8_t tokenSequence) {
 
     // Check for join invitation (coordinator sending invitation)
     if (removeNodeID == MODBEE_JOIN_TOKEN && addNodeID != 0) {
@@ -247,14 +549,17 @@ void ModBeeIO::handleControlFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8
         _protocol.handleJoinResponse(addNodeID, srcNodeID);
     }       
     
-    // Check if token is being passed to us
-    if (nextMasterID == _protocol.getNodeID()) {
+    // Check if token is being passed to us (a pass of a token that was since reclaimed is ignored)
+    bool joinInvitation = (removeNodeID == MODBEE_JOIN_TOKEN);
+    if (nextMasterID != 0 && !_protocol.checkTokenSequence(tokenSequence)) {
+        MBEE_DEBUG_PROTOCOL("TOKEN: Stale pass from Node %d to Node %d (sequence %d)", srcNodeID, nextMasterID, tokenSequence);
+    } else if (nextMasterID == _protocol.getNodeID()) {
         //MBEE_DEBUG_PROTOCOL("TOKEN: Received from Node %d (state: %s)", srcNodeID, _protocol.getStateName(_protocol.getState()));
-        _protocol.handleTokenReceived(srcNodeID);
+        _protocol.handleTokenReceived(srcNodeID, nextMasterID, joinInvitation);
         _protocol.setTokenReceivedForUs();
     } else if (nextMasterID != 0) {
         //MBEE_DEBUG_PROTOCOL("TOKEN: Passed from Node %d to Node %d", srcNodeID, nextMasterID);
-        _protocol.handleTokenReceived(srcNodeID);
+        _protocol.handleTokenReceived(srcNodeID, nextMasterID, joinInvitation);
     }
     
     // Handle Node Adds - ONLY if it's a real join response (not invitation)
@@ -276,13 +581,17 @@ void ModBeeIO::handleControlFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8
 void ModBeeIO::processModbusData(uint8_t srcNodeID) {
     // Find Modbus sections in PROCESSING buffer
     std::vector<std::pair<uint16_t, uint16_t>> sections;
-    int sectionCount = ModBeeFrame::findModbusSections(_processingBuffer, _processingBufferLen, sections);
+    int sectionCount = _processingStuffed
+        ? ModBeeFrame::findModbusSections(_processingBuffer, _processingBufferLen, _processingDelimiters, _processingDelimiterCount, sections)
+        : ModBeeFrame::findModbusSections(_processingBuffer, _processingBufferLen, sections);
     
     if (sectionCount <= 0) {
         return;
     }
     
     // Process each section from processing buffer
+    _rxTransactionID = 0;
+    _rxApplyAtUs = 0;
     for (const auto& section : sections) {
         processModbusSection(_processingBuffer, section.first, section.second, srcNodeID);
     }
@@ -299,11 +608,21 @@ void ModBeeIO::processModbusSection(const uint8_t* buffer, uint16_t start, uint1
     uint8_t targetSlaveID = buffer[pos];
     pos++; // Move past the SlaveID byte
     
+    // Whoever a section is addressed to may owe a response: its turn is not skipped
+    _protocol.updateNodeWork(targetSlaveID, true);
+    
     //MBEE_DEBUG_IO("MODBUS: Processing section SlaveID:%d, Modbus data starts at pos %d, len:%d, srcNodeID:%d", 
     //    targetSlaveID, pos, end - pos, srcNodeID);
     
-    // Only process if this section is meant for us
-    if (targetSlaveID != _protocol.getNodeID()) {
+    // Multicast: the group byte follows, every member takes the section
+    bool multicast = (targetSlaveID == MODBEE_BROADCAST_ID);
+    if (multicast) {
+        if (pos >= end || !_protocol.isGroupMember(buffer[pos])) {
+            return;
+        }
+        pos++;
+    } else if (targetSlaveID != _protocol.getNodeID()) {
+        // Only process if this section is meant for us
         //MBEE_DEBUG_IO("MODBUS: Section not for us (SlaveID:%d), ignoring", targetSlaveID);
         return;
     }
@@ -314,6 +633,18 @@ void ModBeeIO::processModbusSection(const uint8_t* buffer, uint16_t start, uint1
         return;
     }
     
+    // Transaction and apply-at sections qualify the next section taken, and only that one
+    if (handleExtensionSection(&buffer[pos], modbusLen, multicast, srcNodeID)) {
+        return;
+    }
+    uint8_t transactionID = 0;
+    if (!multicast) {
+        transactionID = _rxTransactionID;
+        _rxTransactionID = 0;
+    }
+    uint32_t applyAtUs = _rxApplyAtUs;
+    _rxApplyAtUs = 0;
+    
     // Determine if this is a response by analyzing the frame structure
     bool isResponse = false;
     uint8_t functionCode = buffer[pos];
@@ -341,16 +672,31 @@ void ModBeeIO::processModbusSection(const uint8_t* buffer, uint16_t start, uint1
     bool parseSuccess = false;
     
     if (isResponse) {
+        // A multicast read response is a publication: only subscribers decode it
+        if (multicast && !_protocol.getCyclicData().isSubscribedTo(srcNodeID)) {
+            return;
+        }
         parseSuccess = ModbusFrame::parseModbusResponse(&buffer[pos], modbusLen, modbusFrame);
+        modbusFrame.transactionID = transactionID;
         if (parseSuccess) {
-            handleModbusResponse(modbusFrame, srcNodeID);
+            if (multicast) {
+                handlePublication(modbusFrame, srcNodeID);
+            } else {
+                handleModbusResponse(modbusFrame, srcNodeID);
+            }
         } else {
             MBEE_DEBUG_IO("MODBUS: Failed to parse response");
         }
     } else {
         parseSuccess = ModbusFrame::parseModbusRequest(&buffer[pos], modbusLen, modbusFrame);
+        modbusFrame.transactionID = transactionID;
+        modbusFrame.applyAtUs = applyAtUs;
         if (parseSuccess) {
-            handleModbusRequest(modbusFrame, srcNodeID);
+            if (multicast) {
+                handleMulticastWrite(modbusFrame, srcNodeID);
+            } else {
+                handleModbusRequest(modbusFrame, srcNodeID);
+            }
         } else {
             MBEE_DEBUG_IO("MODBUS: Failed to parse request");
         }
@@ -368,18 +714,155 @@ void ModBeeIO::processModbusSection(const uint8_t* buffer, uint16_t start, uint1
     }
 }
 
+void ModBeeIO::processCompactSections(uint8_t srcNodeID) {
+    // Single forward pass: every section states its length, sections for other nodes are skipped undecoded
+    uint16_t pos = ModBeeFrame::getPayloadOffset(_processingBuffer, _processingBufferLen);
+    uint16_t dataEnd = _processingBufferLen - 2; // Exclude CRC
+    _rxTransactionID = 0;
+    _rxApplyAtUs = 0;
+    
+    while (pos < dataEnd) {
+        uint8_t tag;
+        uint16_t valueStart, valueEnd;
+        pos = ModBeeFrame::nextCompactSection(_processingBuffer, pos, dataEnd, tag, valueStart, valueEnd);
+        if (pos == 0) {
+            _stats.compactSectionErrors++;
+            MBEE_DEBUG_IO("COMPACT: Malformed section length, rest of frame dropped");
+            return;
+        }
+        
+        _protocol.updateNodeWork(_processingBuffer[valueStart], true);
+        uint8_t group;
+        bool multicast = ModBeeFrame::getCompactGroup(_processingBuffer, valueStart, valueEnd, group);
+        if (multicast ? !_protocol.isGroupMember(group) : _processingBuffer[valueStart] != _protocol.getNodeID()) {
+            continue;
+        }
+        if (multicast && (tag & MODBEE_COMPACT_RESPONSE) && !_protocol.getCyclicData().isSubscribedTo(srcNodeID)) {
+            continue; // Publication nobody here subscribed to
+        }
+        
+        // Transaction, time and apply-at sections qualify the next section taken, and only that one
+        if (tag == MODBEE_COMPACT_EXTENSION) {
+            uint16_t pduStart = valueStart + 1 + multicast;
+            if (pduStart >= valueEnd ||
+                !handleExtensionSection(&_processingBuffer[pduStart], valueEnd - pduStart, multicast, srcNodeID)) {
+                _stats.compactSectionErrors++;
+            }
+            continue;
+        }
+        if (!multicast && tag == MODBEE_COMPACT_TRANSACTION) {
+            _rxTransactionID = (valueEnd - valueStart == 2) ? _processingBuffer[valueStart + 1] : 0;
+            continue;
+        }
+        uint8_t transactionID = 0;
+        if (!multicast) {
+            transactionID = _rxTransactionID;
+            _rxTransactionID = 0;
+        }
+        uint32_t applyAtUs = _rxApplyAtUs;
+        _rxApplyAtUs = 0;
+        
+        ModbusRequest modbusFrame;
+        if (!ModBeeFrame::decodeCompactSection(_processingBuffer, tag, valueStart, valueEnd, modbusFrame)) {
+            _stats.compactSectionErrors++;
+            MBEE_DEBUG_IO("COMPACT: Failed to decode section TAG:%02X", tag);
+            continue;
+        }
+        modbusFrame.transactionID = transactionID;
+        modbusFrame.applyAtUs = modbusFrame.isResponse ? 0 : applyAtUs;
+        
+        if (multicast && modbusFrame.isResponse) {
+            handlePublication(modbusFrame, srcNodeID);
+        } else if (multicast) {
+            handleMulticastWrite(modbusFrame, srcNodeID);
+        } else if (modbusFrame.isResponse) {
+            handleModbusResponse(modbusFrame, srcNodeID);
+        } else {
+            handleModbusRequest(modbusFrame, srcNodeID);
+        }
+    }
+}
+
+// =============================================================================
+// EXTENSION SECTIONS
+// =============================================================================
+bool ModBeeIO::handleExtensionSection(const uint8_t* pdu, uint16_t length, bool multicast, uint8_t srcNodeID) {
+    // [FC] [DATA] after the addressing; false if this is not one of ours
+    uint32_t timeUs;
+    switch (pdu[0]) {
+        case MODBEE_FC_TRANSACTION:
+            if (multicast || length != 2) {
+                return false;
+            }
+            _rxTransactionID = pdu[1];
+            return true;
+            
+        case MODBEE_FC_TIME_SYNC:
+            if (!multicast || length != 1 + MODBEE_TIME_FIELD_LEN || !ModBeeFrame::readTimeField(&pdu[1], timeUs)) {
+                return false;
+            }
+            takeTimeSample(srcNodeID, timeUs);
+            return true;
+            
+        case MODBEE_FC_APPLY_AT:
+            if (length != 1 + MODBEE_TIME_FIELD_LEN || !ModBeeFrame::readTimeField(&pdu[1], timeUs)) {
+                return false;
+            }
+            _rxApplyAtUs = (timeUs != 0) ? timeUs : 1; // 0 means on arrival
+            return true;
+            
+        default:
+            return false;
+    }
+}
+
+void ModBeeIO::takeTimeSample(uint8_t srcNodeID, uint32_t sentUs) {
+    // In the ring only the time master counts; outside it, whoever sends the time
+    if (_protocol.isTimeMaster() || (_protocol.isConnected() && srcNodeID != _protocol.getTimeMasterID())) {
+        return;
+    }
+    
+    // The last received byte is this frame's end only while nothing followed it
+    if (!_rxTimingCurrent || _rxFrameCount != 1 || !_rxParser.isIdle()) {
+        return;
+    }
+    
+    // Polled timestamps land on average half a poll interval after the line went quiet.
+    // The stamp was taken as the frame started: the master's clock read stamp plus
+    // air time when the last byte reached us (propagation is nanoseconds on RS-485)
+    uint32_t localUs = _lastRxActivityUs;
+    if (_exactRxTimestamps && localUs != _lastRxIdleUs) {
+        return; // The transport has not timed this frame's end yet
+    }
+    if (!_exactRxTimestamps) {
+        localUs -= _rxLatencyMeanUs / 2;
+    }
+    _protocol.getNetworkTime().addSample(sentUs + getAirTimeUs(_processingWireLength), localUs);
+}
+
 // =============================================================================
 // MODBUS REQUEST AND RESPONSE HANDLING
 // =============================================================================
 void ModBeeIO::handleModbusRequest(const ModbusRequest& request, uint8_t srcNodeID) {
     MBEE_DEBUG_MODBUS(MBEE_MODBUS_REQUEST, srcNodeID, request);
     
+    // A write with an apply-at time waits for it; nothing is answered either way
+    if (ModbusFrame::isWriteFunction(request.function) &&
+        _protocol.getNetworkTime().scheduleWrite(request, srcNodeID)) {
+        return;
+    }
+    
     // Process the request using ModbusHandler
     ModbusHandler handler(_protocol.getDataMap());
     ModbusRequest response;
     
     // Pass the sourceNodeID to the handler so it can be recorded for failsafe purposes
-    if (handler.processRequest(request, response, srcNodeID)) {
+    bool success = handler.processRequest(request, response, srcNodeID);
+    
+    // The response echoes the request's transaction ID, errors included
+    response.transactionID = request.transactionID;
+    
+    if (success) {
         // Only queue response if it's a read operation
         if (ModbusFrame::isReadFunction(request.function)) {
             PendingResponse pendingResponse;
@@ -410,6 +893,37 @@ void ModBeeIO::handleModbusRequest(const ModbusRequest& request, uint8_t srcNode
     }
 }
 
+void ModBeeIO::handleMulticastWrite(const ModbusRequest& request, uint8_t srcNodeID) {
+    // Only writes can be multicast: a read would draw a response from every member
+    if (request.isResponse || !ModbusFrame::isWriteFunction(request.function)) {
+        MBEE_DEBUG_IO("MULTICAST: Ignoring FC:%02X from Node:%d, only writes are multicast", request.function, srcNodeID);
+        return;
+    }
+    
+    MBEE_DEBUG_MODBUS(MBEE_MODBUS_REQUEST, srcNodeID, request);
+    
+    // Every member latches a scheduled write at the same network time
+    if (_protocol.getNetworkTime().scheduleWrite(request, srcNodeID)) {
+        _stats.multicastWritesApplied++;
+        return;
+    }
+    
+    ModbusHandler handler(_protocol.getDataMap());
+    ModbusRequest response;
+    if (handler.processRequest(request, response, srcNodeID)) {
+        _stats.multicastWritesApplied++;
+    } else {
+        MBEE_DEBUG_IO("MULTICAST: Write FC:%02X Addr:%d failed", request.function, request.startAddr);
+    }
+}
+
+void ModBeeIO::handlePublication(const ModbusRequest& response, uint8_t srcNodeID) {
+    // Subscribed variables are updated in place, nothing is queued or answered
+    if (_protocol.getCyclicData().applyPublication(response, srcNodeID) > 0) {
+        _stats.publicationsApplied++;
+    }
+}
+
 void ModBeeIO::handleModbusResponse(const ModbusRequest& response, uint8_t srcNodeID) {
     //MBEE_DEBUG_IO("RESPONSE: Processing FC:%02X from Node:%d addr:%d with %d bytes data", 
     //    response.function, srcNodeID, response.startAddr, response.data.size());
@@ -434,10 +948,11 @@ bool ModBeeIO::sendTokenFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t a
         return false;
     }
     
-    uint8_t buffer[MODBEE_MAX_TX_BUFFER];
+    uint8_t* buffer = _txBuffer;
     
     uint16_t frameLen = ModBeeFrame::buildControlFrame(
-        buffer, srcNodeID, nextMasterID, addNodeID, removeNodeID
+        buffer, srcNodeID, nextMasterID, addNodeID, removeNodeID,
+        _protocol.isByteStuffingActive(), _protocol.isCompactSectionsActive(), _protocol.getTokenSequence()
     );
     
     if (frameLen == 0) {
@@ -454,11 +969,27 @@ bool ModBeeIO::sendTokenFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t a
     return sent;
 }
 
+bool ModBeeIO::sendShortTokenFrame(uint8_t nextMasterID) {
+    if (!isTransmissionReady()) {
+        return false;
+    }
+    
+    uint16_t frameLen = ModBeeFrame::buildShortTokenFrame(_txBuffer, _protocol.getNodeID(), nextMasterID, _protocol.getTokenSequence());
+    bool sent = sendFrame(_txBuffer, frameLen);
+    if (sent) {
+        _stats.shortTokensSent++;
+    } else {
+        MBEE_DEBUG_IO("TOKEN: Short pass failed to Node %d", nextMasterID);
+    }
+    return sent;
+}
+
 bool ModBeeIO::sendConnectionFrame(uint8_t srcNodeID, uint8_t addNodeID) {
-    uint8_t buffer[MODBEE_MAX_TX_BUFFER];
+    uint8_t* buffer = _txBuffer;
     
     uint16_t frameLen = ModBeeFrame::buildControlFrame(
-        buffer, srcNodeID, 0, addNodeID, 0
+        buffer, srcNodeID, 0, addNodeID, 0,
+        _protocol.isByteStuffingActive(), _protocol.isCompactSectionsActive(), _protocol.getTokenSequence()
     );
     
     if (frameLen == 0) {
@@ -477,10 +1008,11 @@ bool ModBeeIO::sendConnectionFrame(uint8_t srcNodeID, uint8_t addNodeID) {
 }
 
 bool ModBeeIO::sendDisconnectionFrame(uint8_t srcNodeID, uint8_t removeNodeID) {
-    uint8_t buffer[MODBEE_MAX_TX_BUFFER];
+    uint8_t* buffer = _txBuffer;
     
     uint16_t frameLen = ModBeeFrame::buildControlFrame(
-        buffer, srcNodeID, 0, 0, removeNodeID
+        buffer, srcNodeID, 0, 0, removeNodeID,
+        _protocol.isByteStuffingActive(), _protocol.isCompactSectionsActive(), _protocol.getTokenSequence()
     );
     
     if (frameLen == 0) {
@@ -499,10 +1031,11 @@ bool ModBeeIO::sendDisconnectionFrame(uint8_t srcNodeID, uint8_t removeNodeID) {
 }
 
 bool ModBeeIO::sendJoinInvitationFrame(uint8_t srcNodeID, uint8_t invitedNodeID) {
-    uint8_t buffer[MODBEE_MAX_TX_BUFFER];
+    uint8_t* buffer = _txBuffer;
     
     uint16_t frameLen = ModBeeFrame::buildControlFrame(
-        buffer, srcNodeID, 0, invitedNodeID, MODBEE_JOIN_TOKEN
+        buffer, srcNodeID, 0, invitedNodeID, MODBEE_JOIN_TOKEN,
+        _protocol.isByteStuffingActive(), _protocol.isCompactSectionsActive(), _protocol.getTokenSequence()
     );
     
     if (frameLen == 0) {
@@ -520,10 +1053,11 @@ bool ModBeeIO::sendJoinInvitationFrame(uint8_t srcNodeID, uint8_t invitedNodeID)
 }
 
 bool ModBeeIO::sendJoinResponseFrame(uint8_t srcNodeID) {
-    uint8_t buffer[MODBEE_MAX_TX_BUFFER];
+    uint8_t* buffer = _txBuffer;
     
     uint16_t frameLen = ModBeeFrame::buildControlFrame(
-        buffer, srcNodeID, 0, srcNodeID, 0
+        buffer, srcNodeID, 0, srcNodeID, 0,
+        _protocol.isByteStuffingActive(), _protocol.isCompactSectionsActive(), _protocol.getTokenSequence()
     );
     
     if (frameLen == 0) {
@@ -540,150 +1074,302 @@ bool ModBeeIO::sendJoinResponseFrame(uint8_t srcNodeID) {
     return sent;
 }
 
-bool ModBeeIO::sendDataFrame(uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID) {
+bool ModBeeIO::sendJoinWindowFrame(uint8_t srcNodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint32_t slotUs) {
     if (!isTransmissionReady()) {
         return false;
     }
     
-    uint8_t* buffer = new uint8_t[MODBEE_MAX_TX_BUFFER];
-    if (!buffer) {
-        MBEE_DEBUG_IO("FRAME BUILD: Failed to allocate buffer");
-        return false;
-    }
-    
-    memset(buffer, 0xAA, MODBEE_MAX_TX_BUFFER);
-    
-    std::vector<PendingModbusOp> pendingOpsCopy;
-    std::vector<PendingResponse> pendingResponsesCopy;
-    
-    {
-        auto& pendingOps = _protocol.getOperations().getPendingOps();
-        auto& pendingResponses = _protocol.getOperations().getPendingResponses();
-        
-        pendingOpsCopy.reserve(pendingOps.size());
-        pendingResponsesCopy.reserve(pendingResponses.size());
-        
-        for (const auto& op : pendingOps) {
-            pendingOpsCopy.push_back(op);
-        }
-        
-        for (const auto& resp : pendingResponses) {
-            pendingResponsesCopy.push_back(resp);
-        }
-    }
-    
-    //MBEE_DEBUG_IO("FRAME BUILD: Starting with %d pending ops, %d pending responses", 
-    //    pendingOpsCopy.size(), pendingResponsesCopy.size());
+    uint8_t* buffer = _txBuffer;
     
-    std::vector<PendingModbusOp> allOperations;
-    allOperations.reserve(pendingOpsCopy.size() + pendingResponsesCopy.size());
+    uint16_t frameLen = ModBeeFrame::buildJoinWindowFrame(
+        buffer, srcNodeID, firstNodeID, lastNodeID, slots, slotUs,
+        _protocol.isByteStuffingActive(), _protocol.isCompactSectionsActive(), _protocol.getTokenSequence()
+    );
     
-    for (const auto& op : pendingOpsCopy) {
-        allOperations.push_back(op);
+    if (frameLen == 0) {
+        MBEE_DEBUG_IO("JOIN_WINDOW: Failed to build frame");
+        return false;
     }
     
-    for (const auto& resp : pendingResponsesCopy) {
-        PendingModbusOp responseOp;
-        responseOp.destNodeID = resp.destNodeID;
-        responseOp.sourceNodeID = resp.sourceNodeID;
-        responseOp.req = resp.response;
-        responseOp.timestamp = resp.timestamp;
-        responseOp.retryCount = 0;
-        responseOp.resultPtr = nullptr;
-        responseOp.isArray = false;
-        responseOp.arraySize = 0;
-        allOperations.push_back(responseOp);
+    bool sent = sendFrame(buffer, frameLen);
+    if (!sent) {
+        MBEE_DEBUG_IO("JOIN_WINDOW: Send failed for Nodes %d-%d", firstNodeID, lastNodeID);
     }
-    
-    uint16_t frameLen = 0;
-    uint16_t pos = 0;
-    
-    if (pos + 5 >= MODBEE_MAX_TX_BUFFER) {
-        delete[] buffer;
+    return sent;
+}
+
+bool ModBeeIO::sendDataFrame(uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID,
+                             uint32_t lowPriorityBudgetUs) {
+    if (!isTransmissionReady()) {
         return false;
     }
     
-    buffer[pos++] = MODBEE_SOF;
-    buffer[pos++] = _protocol.getNodeID();
-    buffer[pos++] = nextMasterID;
-    buffer[pos++] = addNodeID;
-    buffer[pos++] = removeNodeID;
+    // Low-priority sections share the token-hold budget; high-priority ops and
+    // responses to other masters always go out
+    uint32_t lowPriorityBudget = (lowPriorityBudgetUs == UINT32_MAX) ? UINT32_MAX : getAirTimeBytes(lowPriorityBudgetUs);
+    uint32_t lowPriorityBytes = 0;
+    bool budgetLimited = false;
+    
+    ModBeeOperations& operations = _protocol.getOperations();
+    auto pendingOps = operations.getPendingOps();
+    const auto& pendingResponses = operations.getPendingResponses();
+    
+    uint8_t* buffer = _txBuffer;
+    bool compact = _protocol.isCompactSectionsActive();
+    uint16_t pos = ModBeeFrame::writeHeader(buffer, _protocol.getNodeID(), nextMasterID, addNodeID, removeNodeID,
+                                            _protocol.isByteStuffingActive(), compact, _protocol.getTokenSequence());
+    
+    // Section delimiter positions (only these 0x7C bytes stay unescaped when stuffing)
+    uint16_t delimiters[MODBEE_MAX_FRAME_SECTIONS];
+    uint8_t delimiterCount = 0;
+    
+    // Sections are serialized straight from the queues; each one is size-checked
+    // before it is written, so a frame never has to be rolled back. Packing stops
+    // at the first entry that does not fit, which keeps the packed entries a
+    // prefix of each queue.
+    const uint16_t sectionLimit = MODBEE_MAX_TX_BUFFER - 2; // Room for the CRC
+    uint16_t opsPacked = 0;
+    uint16_t responsesPacked = 0;
+    uint16_t readsTagged = 0;
+    bool frameFull = false;
+    _txMulticastCount = 0;
+    
+    // The time master's clock leads the frame when it is due, so a full queue never
+    // crowds it out; the time itself is written once the frame is complete
+    ModBeeNetworkTime& networkTime = _protocol.getNetworkTime();
+    uint16_t timeSyncPos = 0;
+    if (_protocol.isTimeMaster() && networkTime.isBroadcastDue()) {
+        if (!compact) {
+            delimiters[delimiterCount++] = pos;
+        }
+        timeSyncPos = pos;
+        pos += ModBeeFrame::writeTimeSection(&buffer[pos], MODBEE_BROADCAST_ID, MODBEE_GROUP_ALL, MODBEE_FC_TIME_SYNC, 0, compact);
+    }
     
-    uint16_t operationsAdded = 0;
-    for (const auto& op : allOperations) {
-        if (pos + 20 > MODBEE_MAX_TX_BUFFER - 10) {
-            MBEE_DEBUG_IO("FRAME BUILD: Stopping - insufficient space at pos %d", pos);
-            break;
+    // Publications lead every data frame after it: they are read from the data map as the
+    // frame is built and sent as a read response to everyone (DEST 0, GROUP 0).
+    // They are never queued, so one that does not fit simply waits for our next turn
+    ModbusHandler handler(_protocol.getDataMap());
+    for (const auto& publication : _protocol.getCyclicData().getPublications()) {
+        ModbusRequest request;
+        request.function = publication.function;
+        request.startAddr = publication.startAddr;
+        request.quantity = publication.quantity;
+        handler.processRequest(request, _txPublication, _protocol.getNodeID());
+        if (_txPublication.function & 0x80) {
+            continue; // Range not (or no longer) in the data map
         }
         
-        uint16_t posBeforeSection = pos;
-        
-        buffer[pos++] = MODBEE_PACKET_DELIM;
-        buffer[pos++] = op.destNodeID;
-        
-        uint16_t modbusLen = 0;
-        if (op.req.isResponse) {
-            modbusLen = ModbusFrame::buildModbusResponse(&buffer[pos], op.req);
+        if (compact) {
+            uint16_t sectionLen = ModBeeFrame::getCompactResponseLength(_txPublication, true);
+            if (sectionLen == 0 || pos + sectionLen > sectionLimit) {
+                break;
+            }
+            pos += ModBeeFrame::writeCompactResponse(&buffer[pos], MODBEE_BROADCAST_ID, _txPublication);
         } else {
-            modbusLen = ModbusFrame::buildModbusRequest(&buffer[pos], &op);
+            uint16_t modbusLen = ModbusFrame::getResponseLength(_txPublication);
+            if (delimiterCount >= MODBEE_MAX_FRAME_SECTIONS || pos + 3 + modbusLen > sectionLimit) {
+                break;
+            }
+            delimiters[delimiterCount++] = pos;
+            buffer[pos++] = MODBEE_PACKET_DELIM;
+            buffer[pos++] = MODBEE_BROADCAST_ID;
+            buffer[pos++] = MODBEE_GROUP_ALL;
+            pos += ModbusFrame::buildModbusResponse(&buffer[pos], _txPublication);
+        }
+        _stats.publicationsSent++;
+    }
+    
+    for (auto& op : pendingOps) {
+        uint16_t modbusLen = ModbusFrame::getRequestLength(op);
+        if (op.priority == MBEE_PRIORITY_LOW && modbusLen > 0 && lowPriorityBytes >= lowPriorityBudget) {
+            // Like PROFIBUS, an op may start while budget remains and overrun it.
+            // High-priority ops queue first, so everything from here on waits
+            budgetLimited = true;
+            break;
+        }
+        uint16_t sectionStart = pos;
+        bool multicast = (op.destNodeID == MODBEE_BROADCAST_ID);
+        if (multicast && _txMulticastCount >= MODBEE_MAX_FRAME_SECTIONS) {
+            frameFull = true;
+            break;
         }
         
-        if (modbusLen == 0 || pos + modbusLen >= MODBEE_MAX_TX_BUFFER - 2) {
-            pos = posBeforeSection;
+        // Reads go out behind a transaction section so their response finds them in
+        // O(1); while the transaction table is full the rest of the queue waits
+        bool tagged = !multicast && modbusLen > 0 && ModbusFrame::isReadFunction(op.req.function);
+        if (tagged && operations.assignTransactionID(op, readsTagged) == 0) {
             break;
         }
+        uint16_t tagLen = tagged ? ModBeeFrame::getTransactionSectionLength(compact) : 0;
+        op.unbuildable = (modbusLen == 0);
         
-        pos += modbusLen;
-        operationsAdded++;
+        // Scheduled writes go out behind an apply-at section with the same addressing
+        bool scheduled = modbusLen > 0 && op.req.applyAtUs != 0 && ModbusFrame::isWriteFunction(op.req.function);
+        tagLen += scheduled ? ModBeeFrame::getTimeSectionLength(multicast) : 0;
         
-        if (pos >= MODBEE_MAX_TX_BUFFER) {
-            delete[] buffer;
-            return false;
+        if (compact && modbusLen > 0) {
+            // Compact: build the PDU aside and re-encode it, values are still read at send time
+            if (modbusLen > sizeof(_txPduBuffer)) {
+                frameFull = true;
+                break;
+            }
+            ModbusFrame::buildModbusRequest(_txPduBuffer, &op);
+            uint16_t sectionLen = ModBeeFrame::getCompactRequestLength(_txPduBuffer, modbusLen, multicast);
+            op.unbuildable = (sectionLen == 0);
+            if (!op.unbuildable) {
+                if (pos + tagLen + sectionLen > sectionLimit) {
+                    frameFull = true;
+                    break;
+                }
+                if (tagged) {
+                    pos += ModBeeFrame::writeTransactionSection(&buffer[pos], op.destNodeID, op.req.transactionID, true);
+                }
+                if (scheduled) {
+                    pos += ModBeeFrame::writeTimeSection(&buffer[pos], op.destNodeID, op.group, MODBEE_FC_APPLY_AT, op.req.applyAtUs, true);
+                }
+                pos += ModBeeFrame::writeCompactRequest(&buffer[pos], op.destNodeID, _txPduBuffer, modbusLen, op.group);
+                if (multicast) {
+                    recordOwnMulticast(op.group, _txPduBuffer, modbusLen, op.req.applyAtUs);
+                }
+            }
+        } else if (modbusLen > 0) {
+            if (delimiterCount + tagged + scheduled >= MODBEE_MAX_FRAME_SECTIONS || pos + tagLen + 2 + multicast + modbusLen > sectionLimit) {
+                frameFull = true;
+                break;
+            }
+            if (tagged) {
+                delimiters[delimiterCount++] = pos;
+                pos += ModBeeFrame::writeTransactionSection(&buffer[pos], op.destNodeID, op.req.transactionID, false);
+            }
+            if (scheduled) {
+                delimiters[delimiterCount++] = pos;
+                pos += ModBeeFrame::writeTimeSection(&buffer[pos], op.destNodeID, op.group, MODBEE_FC_APPLY_AT, op.req.applyAtUs, false);
+            }
+            delimiters[delimiterCount++] = pos;
+            buffer[pos++] = MODBEE_PACKET_DELIM;
+            buffer[pos++] = op.destNodeID;
+            if (multicast) {
+                buffer[pos++] = op.group;
+            }
+            uint16_t pduLen = ModbusFrame::buildModbusRequest(&buffer[pos], &op);
+            if (multicast) {
+                recordOwnMulticast(op.group, &buffer[pos], pduLen, op.req.applyAtUs);
+            }
+            pos += pduLen;
+        }
+        if (op.priority == MBEE_PRIORITY_LOW) {
+            lowPriorityBytes += pos - sectionStart;
+        }
+        
+        // Unbuildable operations come off with the packed ones, but were not sent:
+        // they fail, and a read never waits in the transaction table
+        opsPacked++;
+        if (op.unbuildable) {
+            op.req.transactionID = 0;
+        } else {
+            readsTagged += tagged;
         }
     }
     
-    if (pos + 2 > MODBEE_MAX_TX_BUFFER) {
-        delete[] buffer;
-        return false;
+    if (!frameFull) {
+        for (const auto& resp : pendingResponses) {
+            // A response to a tagged read carries its transaction ID back the same way
+            bool tagged = (resp.response.transactionID != 0);
+            uint16_t tagLen = tagged ? ModBeeFrame::getTransactionSectionLength(compact) : 0;
+            if (compact) {
+                uint16_t sectionLen = ModBeeFrame::getCompactResponseLength(resp.response);
+                if (sectionLen > 0) {
+                    if (pos + tagLen + sectionLen > sectionLimit) {
+                        break;
+                    }
+                    if (tagged) {
+                        pos += ModBeeFrame::writeTransactionSection(&buffer[pos], resp.destNodeID, resp.response.transactionID, true);
+                    }
+                    pos += ModBeeFrame::writeCompactResponse(&buffer[pos], resp.destNodeID, resp.response);
+                }
+                responsesPacked++;
+                continue;
+            }
+            
+            uint16_t modbusLen = ModbusFrame::getResponseLength(resp.response);
+            if (modbusLen > 0) {
+                if (delimiterCount + tagged >= MODBEE_MAX_FRAME_SECTIONS || pos + tagLen + 2 + modbusLen > sectionLimit) {
+                    break;
+                }
+                if (tagged) {
+                    delimiters[delimiterCount++] = pos;
+                    pos += ModBeeFrame::writeTransactionSection(&buffer[pos], resp.destNodeID, resp.response.transactionID, false);
+                }
+                delimiters[delimiterCount++] = pos;
+                buffer[pos++] = MODBEE_PACKET_DELIM;
+                buffer[pos++] = resp.destNodeID;
+                pos += ModbusFrame::buildModbusResponse(&buffer[pos], resp.response);
+            }
+            responsesPacked++; // Write acknowledgements have no section
+        }
     }
     
-    uint16_t crc = ModBeeFrame::calculateCRC(buffer, pos);
-    buffer[pos++] = (crc >> 8) & 0xFF;
-    buffer[pos++] = crc & 0xFF;
-    
-    frameLen = pos;
+    // Filled in last, as close to the first byte going out as the frame allows
+    if (timeSyncPos != 0) {
+        ModBeeFrame::writeTimeSection(&buffer[timeSyncPos], MODBEE_BROADCAST_ID, MODBEE_GROUP_ALL, MODBEE_FC_TIME_SYNC,
+                                      networkTime.now(), compact);
+    }
     
-    if (!ModBeeFrame::isValidFrame(buffer, frameLen)) {
-        //MBEE_DEBUG_IO("FRAME BUILD: Built frame failed validation!");
-        delete[] buffer;
+    uint16_t frameLen = ModBeeFrame::finalizeFrame(buffer, pos);
+    if (frameLen == 0) {
+        MBEE_DEBUG_IO("FRAME BUILD: Frame exceeds TX buffer (%d bytes)", pos);
         return false;
     }
     
-    bool sent = sendFrame(buffer, frameLen);
-    
-    delete[] buffer;
+    bool sent = sendFrame(buffer, frameLen, delimiters, delimiterCount);
     
     if (sent) {
-        //MBEE_DEBUG_IO("DATA FRAME: Sent with %d operations to Node %d", operationsAdded, nextMasterID);
+        //MBEE_DEBUG_IO("DATA FRAME: Sent with %d sections to Node %d", delimiterCount, nextMasterID);
         
-        for (const auto& op : pendingOpsCopy) {
-            _protocol.getOperations().removePendingOperation(op);
+        // Entries that did not fit stay queued for the next token
+        operations.removePackedEntries(opsPacked, responsesPacked);
+        applyOwnMulticasts();
+        if (budgetLimited) {
+            _stats.budgetLimitedFrames++;
         }
-        
-        for (const auto& resp : pendingResponsesCopy) {
-            _protocol.getOperations().removePendingResponse(resp.response);
+        if (timeSyncPos != 0) {
+            networkTime.broadcastSent();
         }
     }
     
     return sent;
 }
 
+void ModBeeIO::recordOwnMulticast(uint8_t group, const uint8_t* pdu, uint16_t pduLength, uint32_t applyAtUs) {
+    // Parsed from the PDU as packed, so the values are the ones on the wire. Slots
+    // are reused, and with them their data buffers
+    OwnMulticast& entry = _txMulticasts[_txMulticastCount];
+    if (ModbusFrame::parseModbusRequest(pdu, pduLength, entry.request)) {
+        entry.group = group;
+        entry.request.applyAtUs = applyAtUs;
+        _txMulticastCount++;
+    }
+}
+
+void ModBeeIO::applyOwnMulticasts() {
+    // The sender latches its own multicast writes once the frame is out, like every
+    // receiving member; a frame that was not sent leaves them queued, unapplied
+    for (uint8_t i = 0; i < _txMulticastCount; i++) {
+        _stats.multicastSectionsSent++;
+        if (_protocol.isGroupMember(_txMulticasts[i].group)) {
+            handleMulticastWrite(_txMulticasts[i].request, _protocol.getNodeID());
+        }
+    }
+    _txMulticastCount = 0;
+}
+
 bool ModBeeIO::sendMasterFrame(uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID) {
     return sendDataFrame(nextMasterID, addNodeID, removeNodeID);
 }
 
-bool ModBeeIO::sendFrame(const uint8_t* buffer, uint16_t length) {
-    if (!_stream || length == 0) {
+bool ModBeeIO::sendFrame(const uint8_t* buffer, uint16_t length, const uint16_t* delimiters, uint8_t delimiterCount) {
+    if (!_transport || length == 0) {
         return false;
     }
     
@@ -704,14 +1390,57 @@ bool ModBeeIO::sendFrame(const uint8_t* buffer, uint16_t length) {
         return false;
     }
     
-    size_t bytesWritten = _stream->write(buffer, length);
+    // Achieved gap: how long the line had been idle when we started
+    uint32_t startUs = micros();
+    int32_t idleUs = getBusIdleUs(startUs);
+    if (idleUs >= 0) {
+        if (_stats.txGapSamples == 0 || (uint32_t)idleUs < _stats.txGapMinUs) {
+            _stats.txGapMinUs = idleUs;
+        }
+        if ((uint32_t)idleUs > _stats.txGapMaxUs) {
+            _stats.txGapMaxUs = idleUs;
+        }
+        _stats.txGapSamples++;
+        _stats.txGapSumUs += idleUs;
+    }
+    
+    // Stuffed frames go out escaped, everything else as built
+    const uint8_t* wire = buffer;
+    uint16_t wireLength = length;
+    
+    if (ModBeeFrame::isStuffedFrame(buffer, length)) {
+        wireLength = ModBeeFrame::stuffFrame(buffer, length, delimiters, delimiterCount,
+                                             _txWireBuffer, sizeof(_txWireBuffer));
+        if (wireLength == 0) {
+            incrementBufferOverflow();
+            return false;
+        }
+        wire = _txWireBuffer;
+    }
+    
+    size_t bytesWritten = _transport->write(wire, wireLength);
+    
+    // The line stays busy until the last byte is out (write() may return before that)
+    uint32_t baudRate = getBaudRate();
+    uint32_t airUs = baudRate ? (uint32_t)((uint64_t)bytesWritten * MODBEE_BITS_PER_BYTE * 1000000ULL / baudRate) : 0;
+    uint32_t nowUs = micros();
+    _lastTxEndUs = ((int32_t)(startUs + airUs - nowUs) > 0) ? startUs + airUs : nowUs;
+    _stats.txBytes += bytesWritten;
     
-    if (bytesWritten == length) {
+    if (bytesWritten == wireLength) {
         incrementFrameSent();
+        if (ModBeeFrame::isCompactFrame(buffer, length)) {
+            _stats.compactFramesSent++;
+        }
+        if (wire != buffer) {
+            _stats.stuffedFramesSent++;
+            _stats.txStuffedBytes += length;
+            _stats.txEscapeBytes += wireLength - length;
+        }
         MBEE_DEBUG_FRAME(MBEE_FRAME_TX, buffer, length);
         return true;
     } else {
-        MBEE_DEBUG_IO("TX: Failed to send frame, only %d of %d bytes written", bytesWritten, length);
+        MBEE_DEBUG_IO("TX: Failed to send frame, only %d of %d bytes written", bytesWritten, wireLength);
         return false;
     }
 }
@@ -720,28 +1449,49 @@ bool ModBeeIO::sendFrame(const uint8_t* buffer, uint16_t length) {
 // TRANSMISSION UTILITIES
 // =============================================================================
 bool ModBeeIO::isTransmissionReady() {
-    if (!_stream) {
+    if (!_transport) {
         return false;
     }
     
-    unsigned long now = micros();  // Use microseconds for precision
-    unsigned long lastActivityMicros = _lastBusActivity * 1000;  // Convert to micros
-    return (now - lastActivityMicros >= ModBeeAPI::MODBEE_INTERFRAME_GAP_US);
+    // Wrap-safe microsecond comparison against the last RX or TX activity
+    if (getBusIdleUs(micros()) < (int32_t)getInterFrameGapUs()) {
+        _stats.txDeferrals++;
+        return false;
+    }
+    return true;
 }
 
 // =============================================================================
 // STATISTICS AND MONITORING
 // =============================================================================
 void ModBeeIO::resetStatistics() {
-    _stats.framesReceived = 0;
-    _stats.framesSent = 0;
-    _stats.crcErrors = 0;
-    _stats.framingErrors = 0;
-    _stats.bufferOverflows = 0;
+    _stats = ModBeeIOStats();
+    _statsStartMs = millis();
 }
 
 ModBeeIOStats ModBeeIO::getStatistics() {
-    return _stats;
+    ModBeeIOStats stats = _stats;
+    stats.interFrameGapUs = getInterFrameGapUs();
+    stats.rxLatencyMeanUs = _rxLatencyMeanUs;
+    stats.rxLatencyDevUs = _rxLatencyDevUs;
+    stats.silenceMeanUs = _silenceMeanUs;
+    stats.silenceDevUs = _silenceDevUs;
+    stats.windowMs = (uint32_t)(millis() - _statsStartMs);
+    
+    // Every byte on the line, ours and everyone else's, times the byte time
+    uint32_t baudRate = getBaudRate();
+    if (baudRate > 0 && stats.windowMs > 0) {
+        float busyMs = (float)(stats.rxBytes + stats.txBytes) * MODBEE_BITS_PER_BYTE * 1000.0f / baudRate;
+        stats.busUtilisation = std::min(busyMs / stats.windowMs, 1.0f);
+    }
+    return stats;
+}
+
+float ModBeeIOStats::getTxGapMeanUs() const {
+    if (txGapSamples == 0) {
+        return 0.0f;
+    }
+    return (float)txGapSumUs / txGapSamples;
 }
 
 void ModBeeIO::incrementFrameReceived() {
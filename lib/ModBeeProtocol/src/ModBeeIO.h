@@ -1,6 +1,5 @@
 #pragma once
 #include "ModBeeGlobal.h"
-#include <deque>
 
 // Forward declarations
 class ModBeeProtocol;
@@ -14,10 +13,56 @@ struct ModBeeIOStats {
     uint32_t crcErrors = 0;
     uint32_t framingErrors = 0;
     uint32_t bufferOverflows = 0;
+    uint32_t framesAborted = 0;         // Partial frames dropped by a mid-frame SOF
+    
+    // Byte stuffing overhead
+    uint32_t stuffedFramesSent = 0;
+    uint32_t stuffedFramesReceived = 0;
+    uint32_t txStuffedBytes = 0;        // Unstuffed size of stuffed frames sent
+    uint32_t txEscapeBytes = 0;         // Escape bytes added on TX
+    uint32_t rxEscapeBytes = 0;         // Escape bytes removed on RX
+    
+    // Compact (TLV) sections
+    uint32_t compactFramesSent = 0;
+    uint32_t compactFramesReceived = 0;
+    uint32_t compactSectionErrors = 0;  // Malformed compact sections dropped on RX
+    
+    // Short token passes
+    uint32_t shortTokensSent = 0;
+    uint32_t shortTokensReceived = 0;
+    
+    // Multicast writes
+    uint32_t multicastSectionsSent = 0;
+    uint32_t multicastWritesApplied = 0;  // Ours and received ones for a group we are in, scheduled ones when taken
+    
+    // Publish/subscribe
+    uint32_t publicationsSent = 0;
+    uint32_t publicationsApplied = 0;   // Received publications that updated a subscription
+    
+    // Bus timing (microseconds)
+    uint32_t interFrameGapUs = 0;       // Gap currently required before transmitting
+    uint32_t rxLatencyMeanUs = 0;       // Smoothed delay between the line going idle and us seeing it
+    uint32_t rxLatencyDevUs = 0;        // Smoothed deviation of that delay, the jitter the gap adapts to
+    uint32_t silenceMeanUs = 0;         // Smoothed silence before each frame, what token timeouts adapt to
+    uint32_t silenceDevUs = 0;
+    uint32_t txGapSamples = 0;
+    uint32_t txGapMinUs = 0;            // Achieved idle time before our transmissions
+    uint32_t txGapMaxUs = 0;
+    uint64_t txGapSumUs = 0;
+    uint32_t txDeferrals = 0;           // Transmissions refused because the gap had not elapsed
+    uint32_t budgetLimitedFrames = 0;   // Data frames that left low-priority ops for a later token
+    
+    // Bus utilisation (needs the baud rate)
+    uint32_t rxBytes = 0;
+    uint32_t txBytes = 0;
+    uint32_t windowMs = 0;              // Time since the statistics were reset
+    float busUtilisation = 0.0f;        // Share of windowMs the line carried data, 0..1
+    
+    float getTxGapMeanUs() const;
 };
 
 /**
- * ModBee IO Manager with Double-Buffer System
+ * ModBee IO Manager with zero-copy RX ring
  * Handles all protocol input/output operations safely
  */
 class ModBeeIO {
@@ -31,7 +76,7 @@ public:
     // =============================================================================
     // INITIALIZATION
     // =============================================================================
-    bool begin(Stream* serialStream);
+    bool begin(ModBeeTransport* transport);
     
     // =============================================================================
     // MAIN PROCESSING
@@ -42,20 +87,40 @@ public:
     // FRAME TRANSMISSION
     // =============================================================================
     bool sendTokenFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID);
+    bool sendShortTokenFrame(uint8_t nextMasterID);
     bool sendJoinInvitationFrame(uint8_t srcNodeID, uint8_t invitedNodeID);
     bool sendJoinResponseFrame(uint8_t srcNodeID);
+    bool sendJoinWindowFrame(uint8_t srcNodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint32_t slotUs);
     bool sendDisconnectionFrame(uint8_t srcNodeID, uint8_t removeNodeID);
-    bool sendDataFrame(uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID);
+    bool sendDataFrame(uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID,
+                       uint32_t lowPriorityBudgetUs = UINT32_MAX);
     bool sendConnectionFrame(uint8_t srcNodeID, uint8_t addNodeID);
     bool sendMasterFrame(uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID);
 
     // =============================================================================
     // STATUS AND MONITORING
     // =============================================================================
-    unsigned long getLastActivityTime() const { return _lastBusActivity; }
-    uint16_t getRxBufferLevel() { return _primaryRxPos; }
-    bool isCompleteFrame() { return !_frameQueue.empty(); }
-    bool isRxBufferEmpty() { return _primaryRxPos == 0; }
+    uint32_t getLastActivityTime() const { return _lastBusActivity; }
+    uint32_t getInterFrameGapUs() const;
+    uint32_t getBaudRate() const;
+    uint32_t getAirTimeBytes(uint32_t durationUs) const;
+    uint32_t getAirTimeUs(uint32_t bytes) const;
+    uint32_t getLastTxEndUs() const { return _lastTxEndUs; }
+    uint32_t getLastRxActivityUs() const { return _lastRxActivityUs; }
+    int32_t getBusIdleUs(uint32_t now) const;
+    uint32_t getSilenceLimitUs() const;
+    uint32_t getRxLatencyLimitUs() const { return _rxLatencyMeanUs + 4 * _rxLatencyDevUs; }
+    uint16_t getRxBufferLevel() { return _rxParser.getBufferedBytes(); }
+    bool isCompleteFrame() { return _rxFrameCount > 0; }
+    bool isRxBufferEmpty() { return _rxParser.isIdle(); }
+    
+    // =============================================================================
+    // JOIN WINDOW MONITOR
+    // =============================================================================
+    void beginJoinWindowMonitor(uint32_t startUs, uint32_t slotUs, uint8_t slots);
+    void endJoinWindowMonitor() { _joinMonitorSlots = 0; }
+    uint32_t getJoinWindowActivity() const { return _joinSlotActivity; }
+    uint32_t getJoinWindowErrors() const { return _joinSlotErrors; }
     
     // =============================================================================
     // STATISTICS
@@ -72,32 +137,98 @@ public:
     // PUBLIC BUFFER ACCESS FOR ACTIVITY DETECTION
     // =============================================================================
     bool _rxAvailable;
-    unsigned long _lastBusActivity;
+    uint32_t _lastBusActivity;
 
 private:
     ModBeeProtocol& _protocol;
-    Stream* _stream;
+    ModBeeTransport* _transport;
     
     // =============================================================================
-    // DOUBLE BUFFER SYSTEM FOR SAFE FRAME PROCESSING
+    // ZERO-COPY RX RING
     // =============================================================================
     
-    // Primary receive buffer (continuously filled)
-    uint8_t _primaryRxBuffer[MODBEE_MAX_RX_BUFFER];
-    uint16_t _primaryRxPos;
+    // Received frame location in the ring (frames are always contiguous)
+    struct RxFrameDescriptor {
+        uint16_t offset;                // Frame start in _rxRing
+        uint16_t length;                // Frame length (unstuffed)
+        uint16_t wireLength;            // Bytes it took on the wire, escapes included
+        uint16_t delimiterOffset;       // Stuffed frames: delimiter list start in _rxRing
+        uint8_t delimiterCount;         // Stuffed frames: number of section delimiters
+        bool stuffed;                   // Frame was byte-stuffed on the wire
+    };
+    
+    // The parser writes straight into the ring; frames are processed where they land
+    uint8_t _rxRing[MODBEE_RX_RING_SIZE] __attribute__((aligned(4)));
+    uint16_t _rxRingHead;               // Next free byte after the newest queued frame
+    ModBeeFrameParser _rxParser;
+    uint16_t _rxParserOffset;           // Ring offset the parser is writing to
+    
+    // Contiguous space reserved per frame: largest frame plus its delimiter list
+    static constexpr uint16_t RX_FRAME_SLOT = MODBEE_MAX_RX_BUFFER + MODBEE_MAX_FRAME_SECTIONS * sizeof(uint16_t);
     
-    // Processing buffer (contains complete frames for processing)
-    uint8_t _processingBuffer[MODBEE_MAX_RX_BUFFER];
+    RxFrameDescriptor _rxFrames[MODBEE_MAX_FRAME_QUEUE];
+    uint8_t _rxFrameFirst;              // Index of the oldest queued frame
+    uint8_t _rxFrameCount;
+    
+    // Frame currently being processed (points into the ring)
+    const uint8_t* _processingBuffer;
     uint16_t _processingBufferLen;
+    bool _processingStuffed;
+    const uint16_t* _processingDelimiters;
+    uint8_t _processingDelimiterCount;
+    uint16_t _processingWireLength;
+    uint8_t _rxTransactionID;           // From a transaction section, tags the next section for us
+    uint32_t _rxApplyAtUs;              // From an apply-at section, holds the next write we take
+    bool _rxTimingCurrent;              // The bus timestamps describe the newest queued frame
+    
+    // =============================================================================
+    // TX BUFFERS
+    // =============================================================================
+    
+    // Logical frame being built (control and data frames), written in a single pass
+    uint8_t _txBuffer[MODBEE_MAX_TX_BUFFER] __attribute__((aligned(4)));
+    
+    // Wire buffer for byte-stuffed transmission (worst case doubles the frame)
+    uint8_t _txWireBuffer[MODBEE_MAX_TX_BUFFER * 2];
+    
+    // One request PDU, re-encoded from here into a compact section
+    uint8_t _txPduBuffer[MODBEE_MAX_PDU_SIZE];
     
-    // Frame extraction queue
-    struct CompleteFrame {
-        uint8_t data[MODBEE_MAX_RX_BUFFER];
-        uint16_t length;
+    // Publication read back from the data map, kept so its data buffer is reused
+    ModbusRequest _txPublication;
+    
+    // Our own multicast writes in the frame being built, applied once it has gone out
+    struct OwnMulticast {
+        uint8_t group;
+        ModbusRequest request;
     };
+    OwnMulticast _txMulticasts[MODBEE_MAX_FRAME_SECTIONS];
+    uint8_t _txMulticastCount;
+    
+    // =============================================================================
+    // BUS TIMING
+    // =============================================================================
+    uint32_t _lastRxActivityUs;         // Last received byte, exact when the transport reports line idle
+    uint32_t _lastRxReadUs;             // Last read that returned bytes
+    uint32_t _lastRxIdleUs;             // Last line-idle time reported by the transport
+    uint32_t _lastTxEndUs;              // Expected end of our last transmission on the wire
+    uint32_t _lastPollUs;               // Previous processIncoming() call
+    bool _exactRxTimestamps;            // Transport reports line-idle times
+    uint32_t _rxLatencyMeanUs;          // Smoothed like TCP SRTT/RTTVAR (gains 1/8 and 1/4)
+    uint32_t _rxLatencyDevUs;
+    uint32_t _silenceMeanUs;            // Silence before each received frame, smoothed the same way
+    uint32_t _silenceDevUs;
+    uint32_t _frameSilenceUs;           // Silence before the frame being received, 0 if none
+    uint32_t _statsStartMs;
     
-    std::deque<CompleteFrame> _frameQueue;
-    static constexpr uint8_t MAX_FRAME_QUEUE = 5;
+    // =============================================================================
+    // JOIN WINDOW MONITOR
+    // =============================================================================
+    uint32_t _joinMonitorStartUs;       // End of our join window frame on the wire
+    uint32_t _joinMonitorSlotUs;
+    uint8_t _joinMonitorSlots;          // 0 while no window is open
+    uint32_t _joinSlotActivity;         // Bit k: bytes arrived during slot k
+    uint32_t _joinSlotErrors;           // Bit k: a corrupted frame ended during slot k
     
     // =============================================================================
     // STATISTICS
@@ -105,30 +236,42 @@ private:
     ModBeeIOStats _stats;
     
     // =============================================================================
-    // DOUBLE BUFFER METHODS
+    // RX RING METHODS
     // =============================================================================
-    void extractCompleteFrames();
-    bool findNextCompleteFrame(uint16_t& frameStart, uint16_t& frameEnd);
+    bool attachRxSpace();
+    void queueCompleteFrame();
     void processQueuedFrames();
-    void shiftPrimaryBuffer(uint16_t shiftAmount);
     
     // =============================================================================
     // FRAME PROCESSING
     // =============================================================================
     void processCompleteFrame();
-    void handleControlFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID);
+    void processShortToken();
+    void handleControlFrame(uint8_t srcNodeID, uint8_t nextMasterID, uint8_t addNodeID, uint8_t removeNodeID, uint8_t tokenSequence);
     void processModbusData(uint8_t srcNodeID);
     void processModbusSection(const uint8_t* buffer, uint16_t start, uint16_t end, uint8_t srcNodeID);
+    void processCompactSections(uint8_t srcNodeID);
+    bool handleExtensionSection(const uint8_t* pdu, uint16_t length, bool multicast, uint8_t srcNodeID);
+    void takeTimeSample(uint8_t srcNodeID, uint32_t sentUs);
     void handleModbusRequest(const ModbusRequest& request, uint8_t srcNodeID);
+    void handleMulticastWrite(const ModbusRequest& request, uint8_t srcNodeID);
+    void handlePublication(const ModbusRequest& response, uint8_t srcNodeID);
     void handleModbusResponse(const ModbusRequest& response, uint8_t srcNodeID);
     
     // =============================================================================
     // TRANSMISSION UTILITIES
     // =============================================================================
-    bool sendFrame(const uint8_t* buffer, uint16_t length);
+    bool sendFrame(const uint8_t* buffer, uint16_t length, const uint16_t* delimiters = nullptr, uint8_t delimiterCount = 0);
+    void recordOwnMulticast(uint8_t group, const uint8_t* pdu, uint16_t pduLength, uint32_t applyAtUs);
+    void applyOwnMulticasts();
     bool isTransmissionReady();
+    void updateRxTiming(bool dataReceived, uint32_t now);
+    void addRxLatencySample(uint32_t sampleUs);
+    void addSilenceSample(uint32_t sampleUs);
+    void takeSilenceSample(uint8_t srcNodeID);
+    void updateJoinWindowMonitor(bool dataReceived, bool rxError);
 
 public:
     // Add this method for collision detection
-    bool hasQueuedFrames() const { return !_frameQueue.empty(); }
+    bool hasQueuedFrames() const { return _rxFrameCount > 0; }
 };
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// LOOPBACK BUS
+// =============================================================================
+LoopbackBus::LoopbackBus()
+    : _endpointCount(0), _writes(0), _bytesWritten(0), _bytesDelivered(0), _bytesDropped(0) {
+    memset(_endpoints, 0, sizeof(_endpoints));
+}
+
+bool LoopbackBus::attach(LoopbackBusTransport* endpoint) {
+    if (!endpoint || _endpointCount >= MODBEE_LOOPBACK_MAX_ENDPOINTS) {
+        return false;
+    }
+    for (uint16_t i = 0; i < _endpointCount; i++) {
+        if (_endpoints[i] == endpoint) {
+            return true;
+        }
+    }
+    _endpoints[_endpointCount++] = endpoint;
+    return true;
+}
+
+void LoopbackBus::detach(LoopbackBusTransport* endpoint) {
+    for (uint16_t i = 0; i < _endpointCount; i++) {
+        if (_endpoints[i] == endpoint) {
+            _endpoints[i] = _endpoints[--_endpointCount];
+            _endpoints[_endpointCount] = nullptr;
+            return;
+        }
+    }
+}
+
+size_t LoopbackBus::broadcast(const LoopbackBusTransport* sender, const uint8_t* buffer, size_t size) {
+    _writes.fetch_add(1, std::memory_order_relaxed);
+    _bytesWritten.fetch_add(size, std::memory_order_relaxed);
+
+    for (uint16_t i = 0; i < _endpointCount; i++) {
+        LoopbackBusTransport* endpoint = _endpoints[i];
+        if (endpoint == sender) {
+            continue; // Half duplex: a node does not hear itself
+        }
+        size_t accepted = endpoint->deliver(buffer, size);
+        _bytesDelivered.fetch_add(accepted, std::memory_order_relaxed);
+        _bytesDropped.fetch_add(size - accepted, std::memory_order_relaxed);
+    }
+
+    return size;
+}
+
+LoopbackBusStats LoopbackBus::getStatistics() const {
+    LoopbackBusStats stats;
+    stats.writes = _writes.load(std::memory_order_relaxed);
+    stats.bytesWritten = _bytesWritten.load(std::memory_order_relaxed);
+    stats.bytesDelivered = _bytesDelivered.load(std::memory_order_relaxed);
+    stats.bytesDropped = _bytesDropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void LoopbackBus::resetStatistics() {
+    _writes.store(0, std::memory_order_relaxed);
+    _bytesWritten.store(0, std::memory_order_relaxed);
+    _bytesDelivered.store(0, std::memory_order_relaxed);
+    _bytesDropped.store(0, std::memory_order_relaxed);
+}
+
+// =============================================================================
+// CONSTRUCTOR AND SETUP
+// =============================================================================
+LoopbackBusTransport::LoopbackBusTransport(LoopbackBus& bus)
+    : _bus(bus), _attached(false), _reserved(0), _tail(0), _published(0) {
+    for (uint32_t i = 0; i < MODBEE_LOOPBACK_RING_SIZE; i++) {
+        _chunkLength[i] = 0;
+        _chunkCommitted[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LoopbackBusTransport::~LoopbackBusTransport() {
+    if (_attached) {
+        _bus.detach(this);
+    }
+}
+
+bool LoopbackBusTransport::begin() {
+    if (!_attached) {
+        _attached = _bus.attach(this);
+    }
+    return _attached;
+}
+
+// =============================================================================
+// RECEIVE SIDE (single reader)
+// =============================================================================
+uint32_t LoopbackBusTransport::collectCommitted() {
+    // Move past every chunk whose writer has finished, in reservation order
+    while (_published != _reserved.load(std::memory_order_acquire)) {
+        uint32_t index = _published & RING_MASK;
+        if (_chunkCommitted[index].load(std::memory_order_acquire) != _published + 1) {
+            break;
+        }
+        _published += _chunkLength[index];
+    }
+    return _published;
+}
+
+int LoopbackBusTransport::available() {
+    return (int)(collectCommitted() - _tail.load(std::memory_order_relaxed));
+}
+
+int LoopbackBusTransport::read() {
+    uint8_t byte;
+    return read(&byte, 1) == 1 ? byte : -1;
+}
+
+size_t LoopbackBusTransport::read(uint8_t* buffer, size_t length) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t ready = collectCommitted() - tail;
+    uint32_t count = (uint32_t)std::min((size_t)ready, length);
+
+    // At most two copies: up to the end of the ring, then from its start
+    uint32_t start = tail & RING_MASK;
+    uint32_t first = std::min(count, (uint32_t)MODBEE_LOOPBACK_RING_SIZE - start);
+    memcpy(buffer, &_ring[start], first);
+    memcpy(buffer + first, _ring, count - first);
+
+    _tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+// =============================================================================
+// TRANSMIT SIDE (any writer)
+// =============================================================================
+size_t LoopbackBusTransport::write(const uint8_t* buffer, size_t size) {
+    if (!_attached) {
+        return 0;
+    }
+    return _bus.broadcast(this, buffer, size);
+}
+
+size_t LoopbackBusTransport::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+size_t LoopbackBusTransport::deliver(const uint8_t* buffer, size_t size) {
+    // Reserve space; a write that does not fit is truncated like an RX overrun
+    uint32_t start = _reserved.load(std::memory_order_relaxed);
+    uint32_t count;
+    do {
+        uint32_t space = MODBEE_LOOPBACK_RING_SIZE - (start - _tail.load(std::memory_order_acquire));
+        count = (uint32_t)std::min((size_t)space, size);
+        if (count == 0) {
+            return 0;
+        }
+    } while (!_reserved.compare_exchange_weak(start, start + count, std::memory_order_relaxed));
+
+    uint32_t offset = start & RING_MASK;
+    uint32_t first = std::min(count, (uint32_t)MODBEE_LOOPBACK_RING_SIZE - offset);
+    memcpy(&_ring[offset], buffer, first);
+    memcpy(_ring, buffer + first, count - first);
+
+    // The reader takes chunks in reservation order, so it never sees a gap
+    _chunkLength[offset] = (uint16_t)count;
+    _chunkCommitted[offset].store(start + 1, std::memory_order_release);
+
+    return count;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// LOOPBACK BUS CONFIGURATION
+// =============================================================================
+#ifndef MODBEE_LOOPBACK_RING_SIZE
+#define MODBEE_LOOPBACK_RING_SIZE     2048    // Per-endpoint RX ring, must be a power of two
+#endif
+
+#ifndef MODBEE_LOOPBACK_MAX_ENDPOINTS
+#define MODBEE_LOOPBACK_MAX_ENDPOINTS 256
+#endif
+
+class LoopbackBusTransport;
+
+// =============================================================================
+// STATISTICS STRUCTURE
+// =============================================================================
+struct LoopbackBusStats {
+    uint32_t writes = 0;
+    uint32_t bytesWritten = 0;
+    uint32_t bytesDelivered = 0;
+    uint32_t bytesDropped = 0;          // Receiver ring full
+};
+
+/**
+ * In-memory shared bus joining any number of LoopbackBusTransport endpoints
+ * Like an RS485 line, every byte written by one endpoint is received by all
+ * others (never by the writer). Lets several protocol instances run in one
+ * process for benchmarking and profiling without hardware.
+ */
+class LoopbackBus {
+public:
+    LoopbackBus();
+
+    bool attach(LoopbackBusTransport* endpoint);
+    void detach(LoopbackBusTransport* endpoint);
+    uint16_t getEndpointCount() const { return _endpointCount; }
+
+    size_t broadcast(const LoopbackBusTransport* sender, const uint8_t* buffer, size_t size);
+
+    LoopbackBusStats getStatistics() const;
+    void resetStatistics();
+
+private:
+    LoopbackBusTransport* _endpoints[MODBEE_LOOPBACK_MAX_ENDPOINTS];
+    uint16_t _endpointCount;
+
+    // Counted by every writer's thread, so kept apart from the LoopbackBusStats snapshot
+    std::atomic<uint32_t> _writes;
+    std::atomic<uint32_t> _bytesWritten;
+    std::atomic<uint32_t> _bytesDelivered;
+    std::atomic<uint32_t> _bytesDropped;
+};
+
+/**
+ * One node's connection to a LoopbackBus
+ * Each endpoint owns a lock-free RX ring: any number of writers reserve space
+ * with a compare-and-swap, copy their bytes and mark the chunk committed,
+ * never waiting for each other. The owning node is the single reader: it takes
+ * committed chunks in reservation order and stops at the first one still being
+ * written, so a preempted writer only holds back the bytes behind its own.
+ * Attach all endpoints before the nodes start running.
+ */
+class LoopbackBusTransport : public ModBeeTransport {
+public:
+    // =============================================================================
+    // CONSTRUCTOR AND SETUP
+    // =============================================================================
+    explicit LoopbackBusTransport(LoopbackBus& bus);
+    ~LoopbackBusTransport();
+
+    bool begin() override;
+
+    // =============================================================================
+    // TRANSPORT INTERFACE
+    // =============================================================================
+    int available() override;
+    int read() override;
+    size_t read(uint8_t* buffer, size_t length) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    size_t write(uint8_t data) override;
+    void flush() override {}
+    bool isConnected() const override { return _attached; }
+
+    // Called by the bus for every other endpoint's write; returns bytes accepted
+    size_t deliver(const uint8_t* buffer, size_t size);
+
+private:
+    static constexpr uint32_t RING_MASK = MODBEE_LOOPBACK_RING_SIZE - 1;
+    static_assert((MODBEE_LOOPBACK_RING_SIZE & RING_MASK) == 0, "MODBEE_LOOPBACK_RING_SIZE must be a power of two");
+    static_assert(MODBEE_LOOPBACK_RING_SIZE < 65536, "Chunk lengths are stored in 16 bits");
+
+    LoopbackBus& _bus;
+    bool _attached;
+
+    uint8_t _ring[MODBEE_LOOPBACK_RING_SIZE];
+    // Indexed by a chunk's first position: its length, and that position + 1 once
+    // the bytes are in (an older lap's marker never matches)
+    uint16_t _chunkLength[MODBEE_LOOPBACK_RING_SIZE];
+    std::atomic<uint32_t> _chunkCommitted[MODBEE_LOOPBACK_RING_SIZE];
+    std::atomic<uint32_t> _reserved;    // Writers: next free position
+    std::atomic<uint32_t> _tail;        // Reader: next byte to read
+    uint32_t _published;                // Reader: end of the committed chunks taken so far
+
+    uint32_t collectCommitted();
+};
@@ -0,0 +1,159 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// CONSTRUCTOR
+// =============================================================================
+ModBeeNetworkTime::ModBeeNetworkTime()
+    : _offsetUs(0),
+      _driftPpb(0),
+      _sampleUs(0),
+      _sampled(false),
+      _heldOver(false),
+      _reference(false),
+      _broadcastSent(false),
+      _lastBroadcastMs(0) {
+}
+
+// =============================================================================
+// NETWORK TIME
+// =============================================================================
+void ModBeeNetworkTime::addSample(uint32_t networkUs, uint32_t localUs) {
+    if (_reference) {
+        return;
+    }
+
+    // Wrap-safe: both clocks run modulo 2^32
+    uint32_t ourUs = toNetworkTime(localUs);
+    int32_t errorUs = (int32_t)(networkUs - ourUs);
+    uint32_t elapsedUs = localUs - _sampleUs;
+    _stats.samples++;
+    _stats.lastErrorUs = errorUs;
+
+    if (!_sampled || errorUs > MODBEE_TIME_STEP_US || errorUs < -MODBEE_TIME_STEP_US) {
+        // First sample or a new master: jump there and learn its rate afresh
+        _offsetUs = (int32_t)(networkUs - localUs);
+        _driftPpb = 0;
+        _sampleUs = localUs;
+        _sampled = true;
+        _heldOver = false;
+        _stats.steps++;
+        return;
+    }
+
+    // Slew: half the error per sample halves the timestamp jitter passed on, and
+    // a quarter of the error as a rate takes out steady crystal drift over a
+    // few samples. The rate is clamped well past any crystal's tolerance. After a
+    // holdover the error built up over more than elapsedUs, so it trims no rate
+    _offsetUs = (int32_t)(ourUs + (uint32_t)(errorUs / 2) - localUs);
+    _sampleUs = localUs;
+    bool heldOver = _heldOver;
+    _heldOver = false;
+    if (elapsedUs > 0 && !heldOver) {
+        int64_t driftPpb = _driftPpb + (int64_t)errorUs * 1000000000LL / elapsedUs / 4;
+        _driftPpb = (int32_t)std::max<int64_t>(-MODBEE_TIME_MAX_DRIFT_PPB,
+                                               std::min<int64_t>(MODBEE_TIME_MAX_DRIFT_PPB, driftPpb));
+    }
+}
+
+void ModBeeNetworkTime::holdOver(uint32_t localUs) {
+    // The drift term is timed from _sampleUs in 32 bits. While samples stop, it
+    // is folded into the offset long before micros() could wrap past the sample,
+    // so the clock goes on at the last learned rate
+    if ((uint32_t)(localUs - _sampleUs) < MODBEE_TIME_HOLDOVER_US) {
+        return;
+    }
+    _offsetUs = (int32_t)(toNetworkTime(localUs) - localUs);
+    _sampleUs = localUs;
+    _heldOver = true;
+}
+
+uint32_t ModBeeNetworkTime::toNetworkTime(uint32_t localUs) const {
+    // Drift accumulated since the last sample or fold, negative for earlier timestamps
+    int64_t driftUs = (int64_t)(int32_t)(localUs - _sampleUs) * _driftPpb / 1000000000LL;
+    return localUs + (uint32_t)_offsetUs + (uint32_t)(int32_t)driftUs;
+}
+
+void ModBeeNetworkTime::reset() {
+    _offsetUs = 0;
+    _driftPpb = 0;
+    _sampleUs = 0;
+    _sampled = false;
+    _heldOver = false;
+    _broadcastSent = false;
+    _scheduledWrites.clear();
+}
+
+// =============================================================================
+// TIME MASTER BROADCASTS
+// =============================================================================
+bool ModBeeNetworkTime::isBroadcastDue() const {
+    if (ModBeeAPI::MODBEE_TIME_SYNC_INTERVAL_MS == 0) {
+        return false;
+    }
+    return !_broadcastSent || (uint32_t)(millis() - _lastBroadcastMs) >= ModBeeAPI::MODBEE_TIME_SYNC_INTERVAL_MS;
+}
+
+void ModBeeNetworkTime::broadcastSent() {
+    _broadcastSent = true;
+    _lastBroadcastMs = millis();
+    _stats.broadcasts++;
+}
+
+// =============================================================================
+// SCHEDULED WRITES
+// =============================================================================
+bool ModBeeNetworkTime::scheduleWrite(const ModbusRequest& request, uint8_t srcNodeID) {
+    if (request.applyAtUs == 0) {
+        return false;
+    }
+
+    // Without a clock, for a time already past or with the table full, late beats never
+    if (!isSynced() || (int32_t)(request.applyAtUs - now()) <= 0 ||
+        _scheduledWrites.size() >= MODBEE_MAX_SCHEDULED_WRITES) {
+        _stats.lateWrites++;
+        return false;
+    }
+
+    _scheduledWrites.push_back({request, srcNodeID});
+    _stats.scheduledWrites++;
+    return true;
+}
+
+uint16_t ModBeeNetworkTime::applyDueWrites(ModbusDataMap& dataMap) {
+    if (_scheduledWrites.empty()) {
+        return 0;
+    }
+
+    // A handful of entries at most: a linear scan beats keeping them sorted.
+    // Writes due in the same pass apply in the order they arrived
+    uint32_t nowUs = now();
+    uint16_t applied = 0;
+    ModbusHandler handler(dataMap);
+    ModbusRequest response;
+    for (auto it = _scheduledWrites.begin(); it != _scheduledWrites.end();) {
+        if ((int32_t)(nowUs - it->request.applyAtUs) < 0) {
+            ++it;
+            continue;
+        }
+        handler.processRequest(it->request, response, it->srcNodeID);
+        it = _scheduledWrites.erase(it);
+        applied++;
+    }
+    return applied;
+}
+
+// =============================================================================
+// STATISTICS
+// =============================================================================
+ModBeeTimeStats ModBeeNetworkTime::getStatistics() const {
+    ModBeeTimeStats stats = _stats;
+    stats.synced = isSynced();
+    stats.reference = _reference;
+    stats.offsetUs = _offsetUs;
+    stats.driftPpb = _driftPpb;
+    return stats;
+}
+
+void ModBeeNetworkTime::resetStatistics() {
+    _stats = ModBeeTimeStats();
+}
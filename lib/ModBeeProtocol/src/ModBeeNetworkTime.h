@@ -0,0 +1,87 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// STATISTICS STRUCTURE
+// =============================================================================
+struct ModBeeTimeStats {
+    bool synced = false;                // Following the time master, or being it
+    bool reference = false;             // We are the time master
+    int32_t offsetUs = 0;               // Network time minus micros() at the last sample
+    int32_t driftPpb = 0;               // Our crystal's rate error against the time master's
+    uint32_t samples = 0;               // Time sections taken from the time master
+    uint32_t steps = 0;                 // Samples that moved the clock in one jump
+    int32_t lastErrorUs = 0;            // Network time in the last sample minus ours
+    uint32_t broadcasts = 0;            // Time sections we sent as the time master
+    uint32_t scheduledWrites = 0;       // Writes held for their network time
+    uint32_t lateWrites = 0;            // Writes applied on arrival: time already past, no clock or no room
+};
+
+/**
+ * Network time base and writes scheduled against it
+ * The time master (the lowest node in the ring) sends its network time in a
+ * time section of a data frame every MODBEE_TIME_SYNC_INTERVAL_MS. Receivers
+ * add the frame's air time to it and compare it with their own clock at the
+ * frame's end: large errors step the offset, small ones are slewed out over a
+ * few samples so network time never jumps back under a scheduled write, and
+ * also trim a rate estimate so crystal drift does not pile up between them. The
+ * master sends its own network time, offset included, so the time base stays
+ * continuous when a lower node takes over.
+ */
+class ModBeeNetworkTime {
+public:
+    // =============================================================================
+    // CONSTRUCTOR
+    // =============================================================================
+    ModBeeNetworkTime();
+
+    // =============================================================================
+    // NETWORK TIME
+    // =============================================================================
+    uint32_t now() const { return toNetworkTime(micros()); }
+    bool isSynced() const { return _reference || _sampled; }
+    void setReference(bool reference) { _reference = reference; }
+    void addSample(uint32_t networkUs, uint32_t localUs);
+    void holdOver(uint32_t localUs);    // Call every loop: keeps the drift correction going between samples
+    void reset();
+
+    // =============================================================================
+    // TIME MASTER BROADCASTS
+    // =============================================================================
+    bool isBroadcastDue() const;
+    void broadcastSent();
+
+    // =============================================================================
+    // SCHEDULED WRITES
+    // =============================================================================
+    // False when the write should be applied now: no clock, its time has passed or no room
+    bool scheduleWrite(const ModbusRequest& request, uint8_t srcNodeID);
+    uint16_t applyDueWrites(ModbusDataMap& dataMap);
+    void clearScheduledWrites() { _scheduledWrites.clear(); }
+    uint16_t getScheduledWriteCount() const { return _scheduledWrites.size(); }
+
+    // =============================================================================
+    // STATISTICS
+    // =============================================================================
+    ModBeeTimeStats getStatistics() const;
+    void resetStatistics();
+
+private:
+    struct ScheduledWrite {
+        ModbusRequest request;
+        uint8_t srcNodeID;              // Recorded for failsafe purposes like any other write
+    };
+
+    int32_t _offsetUs;                  // Network time minus micros() at _sampleUs, modulo 2^32
+    int32_t _driftPpb;                  // Added to the offset per micros() since _sampleUs
+    uint32_t _sampleUs;                 // micros() of the last sample, or of the last holdover fold
+    bool _sampled;                      // At least one sample since reset()
+    bool _heldOver;                     // Folded since the last sample: the next one learns no rate
+    bool _reference;                    // We are the time master: never sampled
+    bool _broadcastSent;                // _lastBroadcastMs is valid
+    uint32_t _lastBroadcastMs;
+    std::vector<ScheduledWrite> _scheduledWrites;
+    ModBeeTimeStats _stats;
+
+    uint32_t toNetworkTime(uint32_t localUs) const;
+};
@@ -0,0 +1,85 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// MEMBERSHIP
+// =============================================================================
+void ModBeeNodeSet::clear() {
+    memset(_words, 0, sizeof(_words));
+    _count = 0;
+}
+
+bool ModBeeNodeSet::insert(uint8_t nodeID) {
+    uint32_t& word = _words[nodeID >> 5];
+    if (word & mask(nodeID)) {
+        return false;
+    }
+    word |= mask(nodeID);
+    _count++;
+    return true;
+}
+
+bool ModBeeNodeSet::erase(uint8_t nodeID) {
+    uint32_t& word = _words[nodeID >> 5];
+    if (!(word & mask(nodeID))) {
+        return false;
+    }
+    word &= ~mask(nodeID);
+    _count--;
+    return true;
+}
+
+// =============================================================================
+// ORDERED QUERIES
+// =============================================================================
+uint8_t ModBeeNodeSet::next(uint8_t nodeID) const {
+    if (nodeID == 255) {
+        return 0;
+    }
+
+    // Drop the bits up to and including nodeID in its word, then scan forward
+    uint16_t start = nodeID + 1;
+    uint8_t index = start >> 5;
+    uint32_t word = _words[index] & (0xFFFFFFFFUL >> (start & 31));
+
+    while (true) {
+        if (word) {
+            return (uint8_t)((index << 5) + __builtin_clz(word));
+        }
+        if (++index >= MODBEE_NODE_SET_WORDS) {
+            return 0;
+        }
+        word = _words[index];
+    }
+}
+
+uint8_t ModBeeNodeSet::successor(uint8_t nodeID) const {
+    uint8_t nextID = next(nodeID);
+    return nextID != 0 ? nextID : first();
+}
+
+bool ModBeeNodeSet::hasMemberBelow(uint8_t nodeID) const {
+    uint8_t lowest = first();
+    return lowest != 0 && lowest < nodeID;
+}
+
+uint16_t ModBeeNodeSet::countBelow(uint8_t nodeID) const {
+    uint8_t index = nodeID >> 5;
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < index; i++) {
+        total += __builtin_popcount(_words[i]);
+    }
+    
+    // Lower IDs in nodeID's own word are the bits above its bit. Node 0 is not
+    // counted, like first() / next() never report it
+    total += __builtin_popcount(_words[index] & ~(0xFFFFFFFFUL >> (nodeID & 31)));
+    return total - ((_words[0] & mask(0)) && nodeID != 0);
+}
+
+bool ModBeeNodeSet::intersects(const ModBeeNodeSet& other) const {
+    for (uint8_t i = 0; i < MODBEE_NODE_SET_WORDS; i++) {
+        if (_words[i] & other._words[i]) {
+            return true;
+        }
+    }
+    return false;
+}
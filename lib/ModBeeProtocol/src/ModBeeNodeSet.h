@@ -0,0 +1,43 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+#define MODBEE_NODE_SET_WORDS    8       // 256 node IDs, 32 per word
+
+/**
+ * Fixed-size set of node IDs (0-255) as a 256-bit bitmap
+ * Node n lives in word n / 32 at bit (31 - n % 32), most significant first,
+ * so the next member above any ID is one count-leading-zeros per word (a
+ * single NSAU instruction on the ESP32's Xtensa core, which has no CTZ).
+ * Lookups, inserts and removals are O(1); successor and lowest-member queries
+ * touch at most 8 words. Node 0 is never reported by first() / next().
+ */
+class ModBeeNodeSet {
+public:
+    ModBeeNodeSet() { clear(); }
+
+    // =============================================================================
+    // MEMBERSHIP
+    // =============================================================================
+    void clear();
+    bool insert(uint8_t nodeID);        // True if the node was not a member yet
+    bool erase(uint8_t nodeID);         // True if the node was a member
+    bool contains(uint8_t nodeID) const { return (_words[nodeID >> 5] & mask(nodeID)) != 0; }
+    uint16_t count() const { return _count; }
+    bool empty() const { return _count == 0; }
+
+    // =============================================================================
+    // ORDERED QUERIES
+    // =============================================================================
+    uint8_t first() const { return next(0); }         // Lowest member above 0, 0 if none
+    uint8_t next(uint8_t nodeID) const;                // Lowest member above nodeID, 0 if none
+    uint8_t successor(uint8_t nodeID) const;           // Ring order: next(), wrapping to first()
+    bool hasMemberBelow(uint8_t nodeID) const;         // Any member in 1..nodeID-1
+    uint16_t countBelow(uint8_t nodeID) const;         // Members in 1..nodeID-1
+    bool intersects(const ModBeeNodeSet& other) const;
+
+private:
+    static uint32_t mask(uint8_t nodeID) { return 0x80000000UL >> (nodeID & 31); }
+
+    uint32_t _words[MODBEE_NODE_SET_WORDS];
+    uint16_t _count;
+};
@@ -0,0 +1,144 @@
+#include "ModBeeGlobal.h"
+
+static_assert(MODBEE_MAX_PENDING_OPS < MODBEE_OP_NONE, "Operation slots are indexed by uint8_t");
+
+// =============================================================================
+// QUEUE MANAGEMENT
+// =============================================================================
+PendingModbusOp* ModBeeOpPool::insert(const PendingModbusOp& op) {
+    if (_free == MODBEE_OP_NONE) {
+        return nullptr;
+    }
+    uint8_t slot = _free;
+    _free = _next[slot];
+
+    // Copy-assigning reuses the capacity the slot's data buffer kept when freed
+    _ops[slot] = op;
+    _count++;
+
+    // High-priority operations queue behind the last high-priority one, so a
+    // budget-limited data frame still packs a prefix of the queue
+    if (op.priority == MBEE_PRIORITY_HIGH) {
+        linkAfter(slot, _lastHigh);
+        _lastHigh = slot;
+    } else {
+        linkAfter(slot, _tail);
+    }
+
+    uint8_t nodeID = op.destNodeID;
+    _nodeNext[slot] = MODBEE_OP_NONE;
+    _nodePrev[slot] = _nodeTail[nodeID];
+    if (_nodeTail[nodeID] != MODBEE_OP_NONE) {
+        _nodeNext[_nodeTail[nodeID]] = slot;
+    } else {
+        _nodeHead[nodeID] = slot;
+    }
+    _nodeTail[nodeID] = slot;
+    _timers.arm(slot, op.timestamp);
+    return &_ops[slot];
+}
+
+void ModBeeOpPool::remove(PendingModbusOp& op) {
+    uint8_t slot = slotOf(op);
+    unlink(slot);
+
+    uint8_t nodeID = op.destNodeID;
+    if (_nodePrev[slot] != MODBEE_OP_NONE) {
+        _nodeNext[_nodePrev[slot]] = _nodeNext[slot];
+    } else {
+        _nodeHead[nodeID] = _nodeNext[slot];
+    }
+    if (_nodeNext[slot] != MODBEE_OP_NONE) {
+        _nodePrev[_nodeNext[slot]] = _nodePrev[slot];
+    } else {
+        _nodeTail[nodeID] = _nodePrev[slot];
+    }
+    _timers.disarm(slot);
+
+    // Drop what the operation owns but keep the buffer's capacity
+    op.req.data.clear();
+    op.onComplete = nullptr;
+    op.resultPtr = nullptr;
+
+    _next[slot] = _free;
+    _free = slot;
+    _count--;
+}
+
+ModBeeOpPool::iterator ModBeeOpPool::erase(iterator it) {
+    uint8_t next = it._links[it._slot];
+    remove(*it);
+    it._slot = next;
+    return it;
+}
+
+void ModBeeOpPool::moveToFront(PendingModbusOp& op) {
+    uint8_t slot = slotOf(op);
+    unlink(slot);
+    if (op.priority == MBEE_PRIORITY_HIGH) {
+        linkAfter(slot, MODBEE_OP_NONE);
+        if (_lastHigh == MODBEE_OP_NONE) {
+            _lastHigh = slot;
+        }
+    } else {
+        linkAfter(slot, _lastHigh);
+    }
+}
+
+void ModBeeOpPool::rearm(PendingModbusOp& op, uint32_t timestamp) {
+    op.timestamp = timestamp;
+    _timers.rearm(slotOf(op), timestamp);
+}
+
+void ModBeeOpPool::clear() {
+    for (uint8_t i = 0; i < MODBEE_MAX_PENDING_OPS; i++) {
+        _ops[i] = PendingModbusOp();
+        _next[i] = (i + 1 < MODBEE_MAX_PENDING_OPS) ? i + 1 : MODBEE_OP_NONE;
+    }
+    memset(_nodeHead, MODBEE_OP_NONE, sizeof(_nodeHead));
+    memset(_nodeTail, MODBEE_OP_NONE, sizeof(_nodeTail));
+    _head = MODBEE_OP_NONE;
+    _tail = MODBEE_OP_NONE;
+    _lastHigh = MODBEE_OP_NONE;
+    _timers.clear();
+    _free = 0;
+    _count = 0;
+}
+
+// =============================================================================
+// SEND QUEUE LINKS
+// =============================================================================
+void ModBeeOpPool::linkAfter(uint8_t slot, uint8_t after) {
+    // after == MODBEE_OP_NONE links the slot at the head
+    uint8_t next = (after == MODBEE_OP_NONE) ? _head : _next[after];
+    _prev[slot] = after;
+    _next[slot] = next;
+    if (after != MODBEE_OP_NONE) {
+        _next[after] = slot;
+    } else {
+        _head = slot;
+    }
+    if (next != MODBEE_OP_NONE) {
+        _prev[next] = slot;
+    } else {
+        _tail = slot;
+    }
+}
+
+void ModBeeOpPool::unlink(uint8_t slot) {
+    // High-priority operations are a prefix of the queue, so the one before the
+    // last of them is high priority too
+    if (slot == _lastHigh) {
+        _lastHigh = _prev[slot];
+    }
+    if (_prev[slot] != MODBEE_OP_NONE) {
+        _next[_prev[slot]] = _next[slot];
+    } else {
+        _head = _next[slot];
+    }
+    if (_next[slot] != MODBEE_OP_NONE) {
+        _prev[_next[slot]] = _prev[slot];
+    } else {
+        _tail = _prev[slot];
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+/**
+ * Fixed-capacity pool of queued operations
+ * Operations live in a static slab of MODBEE_MAX_PENDING_OPS slots, threaded on
+ * intrusive index lists: the send queue (high priority first, FIFO within each
+ * class), one FIFO per destination node and a free list. A timer queue keeps
+ * them in timestamp order, which is the order they time out in. Inserting,
+ * removing and moving an operation is O(1), per-node walks touch only that
+ * node's operations, and a freed slot keeps its data buffer for the next one.
+ * The slab itself never allocates; an operation still does when its data or
+ * merged reads outgrow what the slot held before, or its completion's captures
+ * do not fit inline in std::function.
+ * Pointers to operations stay valid until they are removed.
+ */
+class ModBeeOpPool {
+public:
+    // Walks one of the slot lists; erase() hands back the iterator after the erased slot
+    template<typename Op>
+    class Iterator {
+    public:
+        Iterator(Op* ops, const uint8_t* links, uint8_t slot) : _ops(ops), _links(links), _slot(slot) {}
+        Op& operator*() const { return _ops[_slot]; }
+        Op* operator->() const { return &_ops[_slot]; }
+        Iterator& operator++() { _slot = _links[_slot]; return *this; }
+        bool operator==(const Iterator& other) const { return _slot == other._slot; }
+        bool operator!=(const Iterator& other) const { return _slot != other._slot; }
+
+    private:
+        friend class ModBeeOpPool;
+        Op* _ops;
+        const uint8_t* _links;
+        uint8_t _slot;
+    };
+
+    template<typename Op>
+    class Range {
+    public:
+        Range(Op* ops, const uint8_t* links, uint8_t first) : _ops(ops), _links(links), _first(first) {}
+        Iterator<Op> begin() const { return Iterator<Op>(_ops, _links, _first); }
+        Iterator<Op> end() const { return Iterator<Op>(_ops, _links, MODBEE_OP_NONE); }
+        bool empty() const { return _first == MODBEE_OP_NONE; }
+
+    private:
+        Op* _ops;
+        const uint8_t* _links;
+        uint8_t _first;
+    };
+
+    typedef Iterator<PendingModbusOp> iterator;
+    typedef Iterator<const PendingModbusOp> const_iterator;
+
+    // =============================================================================
+    // CONSTRUCTOR
+    // =============================================================================
+    ModBeeOpPool() { clear(); }
+
+    // =============================================================================
+    // QUEUE MANAGEMENT
+    // =============================================================================
+    PendingModbusOp* insert(const PendingModbusOp& op);     // nullptr when full
+    void remove(PendingModbusOp& op);
+    iterator erase(iterator it);                            // Next in the same list
+    void moveToFront(PendingModbusOp& op);                  // Front of its priority class
+    void rearm(PendingModbusOp& op, uint32_t timestamp);   // Restarts its timeout
+    void clear();
+
+    // =============================================================================
+    // ITERATION
+    // =============================================================================
+    // Send order: high-priority operations first, each class in arrival order
+    Range<PendingModbusOp> all() { return Range<PendingModbusOp>(_ops, _next, _head); }
+    Range<const PendingModbusOp> all() const { return Range<const PendingModbusOp>(_ops, _next, _head); }
+    // Operations for one destination (MODBEE_BROADCAST_ID: multicast writes) in arrival order
+    Range<PendingModbusOp> forNode(uint8_t nodeID) { return Range<PendingModbusOp>(_ops, _nodeNext, _nodeHead[nodeID]); }
+    Range<const PendingModbusOp> forNode(uint8_t nodeID) const { return Range<const PendingModbusOp>(_ops, _nodeNext, _nodeHead[nodeID]); }
+    PendingModbusOp* front() { return _head == MODBEE_OP_NONE ? nullptr : &_ops[_head]; }
+    // Oldest timestamp first: the order operations time out in
+    Range<PendingModbusOp> byAge() { return Range<PendingModbusOp>(_ops, _timers.links(), _timers.front()); }
+    PendingModbusOp* oldest() { return _timers.front() == MODBEE_OP_NONE ? nullptr : &_ops[_timers.front()]; }
+    bool expired(uint32_t now, unsigned long timeout) const { return _timers.expired(now, timeout); }
+
+    // =============================================================================
+    // STATUS
+    // =============================================================================
+    uint16_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+    bool full() const { return _free == MODBEE_OP_NONE; }
+    bool hasNode(uint8_t nodeID) const { return _nodeHead[nodeID] != MODBEE_OP_NONE; }
+
+private:
+    PendingModbusOp _ops[MODBEE_MAX_PENDING_OPS];
+    uint8_t _next[MODBEE_MAX_PENDING_OPS];      // Send queue, or free list for free slots
+    uint8_t _prev[MODBEE_MAX_PENDING_OPS];
+    uint8_t _nodeNext[MODBEE_MAX_PENDING_OPS];
+    uint8_t _nodePrev[MODBEE_MAX_PENDING_OPS];
+    uint8_t _nodeHead[256];
+    uint8_t _nodeTail[256];
+    ModBeeTimerQueue<MODBEE_MAX_PENDING_OPS> _timers;
+    uint8_t _head;
+    uint8_t _tail;
+    uint8_t _lastHigh;                  // Last high-priority operation in the send queue
+    uint8_t _free;
+    uint16_t _count;
+
+    uint8_t slotOf(const PendingModbusOp& op) const { return &op - _ops; }
+    void linkAfter(uint8_t slot, uint8_t after);
+    void unlink(uint8_t slot);
+};
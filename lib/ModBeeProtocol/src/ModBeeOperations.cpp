@@ -3,14 +3,22 @@
 // =============================================================================
 // CONSTRUCTOR AND DESTRUCTOR
 // =============================================================================
-ModBeeOperations::ModBeeOperations() {
+ModBeeOperations::ModBeeOperations()
+    : _nextTransactionID(0),
+      _lateResponses(0),
+      _mergedReads(0),
+      _mergedWrites(0),
+      _bytesSaved(0) {
     // Constructor - initialize empty containers
     _pendingOps.clear();
     _pendingResponses.clear();
+    clearTransactions();
 }
 
 ModBeeOperations::~ModBeeOperations() {
-    // Destructor - clear all containers
+    // Destructor - clear all containers. Completions are not run from here: their
+    // callbacks may call back into the half-destroyed protocol, so owners cancel
+    // and dispatch first (see ModBeeAPI::end())
     clearPendingOperations();
     clearPendingResponses();
 }
@@ -18,29 +26,63 @@ ModBeeOperations::~ModBeeOperations() {
 // =============================================================================
 // OPERATION MANAGEMENT
 // =============================================================================
-void ModBeeOperations::addPendingOperation(const PendingModbusOp& op, ModBeeProtocol& protocol) {
+bool ModBeeOperations::addPendingOperation(const PendingModbusOp& op, ModBeeProtocol& protocol) {
     // Check if we already have too many pending operations
-    if (_pendingOps.size() >= MODBEE_MAX_PENDING_OPS) {
+    if (_pendingOps.full()) {
         protocol.reportError(MBEE_BUFFER_OVERFLOW, "Too many pending operations");
-        return;
+        return false;
     }
     
-    // Check for EXACT duplicate - don't refresh timestamp
-    for (const auto& existingOp : _pendingOps) {
-        if (existingOp.destNodeID == op.destNodeID &&
-            existingOp.req.function == op.req.function &&
-            existingOp.req.startAddr == op.req.startAddr &&
-            existingOp.req.quantity == op.req.quantity) {
-            // Don't refresh - just reject duplicate
-            return;
+    bool read = ModbusFrame::isReadFunction(op.req.function);
+    
+    // Check for EXACT duplicate - don't refresh timestamp. Reads already sent are
+    // not in the queue, so a new read of the same range pipelines behind them. A
+    // write of the same variable is covered by the queued one, which reads it at send time.
+    // One with a completion merges instead, so the caller still hears back
+    if ((read || op.resultPtr) && !hasCompletion(op) && isQueued(op)) {
+        // Don't refresh - just reject duplicate
+        return true;
+    }
+    
+    // A read next to a queued one widens it; a write to registers a queued write
+    // covers replaces its values there. A widened read may now touch another one
+    if (mergeOperation(op)) {
+        if (read) {
+            optimizeOperations();
         }
+        return true;
     }
     
-    // Add operation
-    _pendingOps.push_back(op);
+    _pendingOps.insert(op);
     
     MBEE_DEBUG_OPERATIONS("ADDED: Op %d/%d - Node:%d FC:%02X Addr:%d Qty:%d", 
         _pendingOps.size(), MODBEE_MAX_PENDING_OPS, op.destNodeID, op.req.function, op.req.startAddr, op.req.quantity);
+    return true;
+}
+
+bool ModBeeOperations::isQueued(const PendingModbusOp& op) const {
+    // Operations on one range with different variables, and writes scheduled
+    // for different times, are separate operations
+    for (const auto& existingOp : _pendingOps.forNode(op.destNodeID)) {
+        if (existingOp.group != op.group || existingOp.req.function != op.req.function) {
+            continue;
+        }
+        if (existingOp.req.startAddr == op.req.startAddr &&
+            existingOp.req.quantity == op.req.quantity &&
+            existingOp.req.applyAtUs == op.req.applyAtUs &&
+            existingOp.resultPtr == op.resultPtr) {
+            return true;
+        }
+        
+        // A read merged into a wider one is still queued under its own range
+        for (const auto& target : existingOp.mergedReads) {
+            if (target.startAddr == op.req.startAddr && target.quantity == op.req.quantity &&
+                target.resultPtr == op.resultPtr) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
 void ModBeeOperations::addPendingResponse(const PendingResponse& response) {
@@ -63,46 +105,70 @@ void ModBeeOperations::addPendingResponse(const PendingResponse& response) {
 // CLEANUP AND MAINTENANCE
 // =============================================================================
 void ModBeeOperations::cleanupTimedOutOperations(ModBeeProtocol& protocol) {
-    unsigned long now = millis();
+    uint32_t now = millis();
     int removedOps = 0;
     int retriedOps = 0;
     int removedResponses = 0;
     
-    // Clean up timed out operations
-    for (auto it = _pendingOps.begin(); it != _pendingOps.end();) {
-        if (now - it->timestamp > (ModBeeAPI::MODBEE_OPERATION_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES) {
-            // Check if we should retry
-            if (it->retryCount < ModBeeAPI::MODBEE_MAX_RETRIES) {
-                // Retry the operation
-                it->timestamp = now;
-                it->retryCount++;
-                retriedOps++;
-                MBEE_DEBUG_OPERATIONS("RETRY: Node:%d FC:%02X Addr:%d (attempt %d/%d)", 
-                    it->destNodeID, it->req.function, it->req.startAddr, it->retryCount, ModBeeAPI::MODBEE_MAX_RETRIES);
-                ++it;
-            } else {
-                // Max retries reached, remove operation
-                MBEE_DEBUG_OPERATIONS("TIMEOUT: Removing Node:%d FC:%02X Addr:%d after %d retries", 
-                    it->destNodeID, it->req.function, it->req.startAddr, it->retryCount);
-                it = _pendingOps.erase(it);
-                removedOps++;
-            }
+    unsigned long opTimeout = protocol.getAdaptiveTimeout(
+        (ModBeeAPI::MODBEE_OPERATION_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES, MODBEE_OP_TIMEOUT_ROTATIONS);
+    unsigned long responseTimeout = protocol.getAdaptiveTimeout(
+        (ModBeeAPI::MODBEE_RESPONSE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES, MODBEE_OP_TIMEOUT_ROTATIONS);
+    
+    // Each queue is in timeout order, so only entries that expired are touched.
+    // A queued operation that times out is retried in place: its timeout restarts
+    // and it goes to the back of the timer queue
+    while (_pendingOps.expired(now, opTimeout)) {
+        PendingModbusOp* op = _pendingOps.oldest();
+        if (op->retryCount < ModBeeAPI::MODBEE_MAX_RETRIES) {
+            op->retryCount++;
+            _pendingOps.rearm(*op, now);
+            retriedOps++;
+            MBEE_DEBUG_OPERATIONS("RETRY: Node:%d FC:%02X Addr:%d (attempt %d/%d)", 
+                op->destNodeID, op->req.function, op->req.startAddr, op->retryCount, ModBeeAPI::MODBEE_MAX_RETRIES);
         } else {
-            ++it;
+            MBEE_DEBUG_OPERATIONS("TIMEOUT: Removing Node:%d FC:%02X Addr:%d after %d retries", 
+                op->destNodeID, op->req.function, op->req.startAddr, op->retryCount);
+            finishOperation(*op, MBEE_REQUEST_TIMEOUT);
+            _pendingOps.remove(*op);
+            removedOps++;
         }
     }
     
-    // Clean up timed out responses
-    for (auto it = _pendingResponses.begin(); it != _pendingResponses.end();) {
-        if (now - it->timestamp > (ModBeeAPI::MODBEE_RESPONSE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES) {
-            MBEE_DEBUG_OPERATIONS("RESPONSE TIMEOUT: Removing FC:%02X Addr:%d", 
-                it->response.function, it->response.startAddr);
-            it = _pendingResponses.erase(it);
-            removedResponses++;
+    // Reads in flight are retried from the queue under a new transaction ID, so a
+    // late response to the old one can no longer complete them
+    while (_transactionTimers.expired(now, opTimeout)) {
+        PendingModbusOp& op = _transactions[_transactionTimers.front()];
+        if (op.retryCount < ModBeeAPI::MODBEE_MAX_RETRIES && canAddOperation()) {
+            PendingModbusOp retry = op;
+            retry.req.transactionID = 0;
+            retry.timestamp = now;
+            retry.retryCount++;
+            if ((hasCompletion(retry) || !isQueued(retry)) && !mergeOperation(retry)) {
+                _pendingOps.insert(retry);
+            }
+            retriedOps++;
+            MBEE_DEBUG_OPERATIONS("RETRY: Node:%d FC:%02X Addr:%d TID:%d unanswered (attempt %d/%d)", 
+                op.destNodeID, op.req.function, op.req.startAddr, op.req.transactionID, retry.retryCount, ModBeeAPI::MODBEE_MAX_RETRIES);
         } else {
-            ++it;
+            MBEE_DEBUG_OPERATIONS("TIMEOUT: Dropping Node:%d FC:%02X Addr:%d TID:%d after %d retries", 
+                op.destNodeID, op.req.function, op.req.startAddr, op.req.transactionID, op.retryCount);
+            finishOperation(op, MBEE_REQUEST_TIMEOUT);
+            removedOps++;
         }
+        endTransaction(op);
+    }
+    
+    // Responses are queued as they are built and sent from the front, so the
+    // timed out ones are a prefix
+    auto expired = _pendingResponses.begin();
+    while (expired != _pendingResponses.end() && now - expired->timestamp > responseTimeout) {
+        MBEE_DEBUG_OPERATIONS("RESPONSE TIMEOUT: Removing FC:%02X Addr:%d", 
+            expired->response.function, expired->response.startAddr);
+        ++expired;
+        removedResponses++;
     }
+    _pendingResponses.erase(_pendingResponses.begin(), expired);
     
     if (removedOps > 0 || retriedOps > 0 || removedResponses > 0) {
         MBEE_DEBUG_OPERATIONS("CLEANUP: Removed:%d ops, %d responses; Retried:%d", 
@@ -111,8 +177,17 @@ void ModBeeOperations::cleanupTimedOutOperations(ModBeeProtocol& protocol) {
 }
 
 void ModBeeOperations::clearPendingOperations() {
-    int count = _pendingOps.size();
+    int count = _pendingOps.size() + getTransactionCount();
+    for (auto& op : _pendingOps.all()) {
+        finishOperation(op, MBEE_REQUEST_CANCELLED);
+    }
+    for (auto& op : _transactions) {
+        if (op.req.transactionID != 0) {
+            finishOperation(op, MBEE_REQUEST_CANCELLED);
+        }
+    }
     _pendingOps.clear();
+    clearTransactions();
     if (count > 0) {
         MBEE_DEBUG_OPERATIONS("CLEARED: %d pending operations", count);
     }
@@ -129,14 +204,6 @@ void ModBeeOperations::clearPendingResponses() {
 // =============================================================================
 // ACCESSOR METHODS
 // =============================================================================
-std::vector<PendingModbusOp>& ModBeeOperations::getPendingOps() {
-    return _pendingOps;
-}
-
-const std::vector<PendingModbusOp>& ModBeeOperations::getPendingOps() const {
-    return _pendingOps;
-}
-
 std::vector<PendingResponse>& ModBeeOperations::getPendingResponses() {
     return _pendingResponses;
 }
@@ -165,24 +232,7 @@ bool ModBeeOperations::hasPendingResponses() const {
 // NODE-SPECIFIC OPERATIONS
 // =============================================================================
 bool ModBeeOperations::hasOperationsForNode(uint8_t nodeID) const {
-    for (const auto& op : _pendingOps) {
-        if (op.destNodeID == nodeID) {
-            return true;
-        }
-    }
-    return false;
-}
-
-std::vector<PendingModbusOp> ModBeeOperations::getOperationsForNode(uint8_t nodeID) const {
-    std::vector<PendingModbusOp> nodeOps;
-    
-    for (const auto& op : _pendingOps) {
-        if (op.destNodeID == nodeID) {
-            nodeOps.push_back(op);
-        }
-    }
-    
-    return nodeOps;
+    return _pendingOps.hasNode(nodeID);
 }
 
 std::vector<PendingResponse> ModBeeOperations::getResponsesForNode(uint8_t nodeID) const {
@@ -195,10 +245,17 @@ std::vector<PendingResponse> ModBeeOperations::getResponsesForNode(uint8_t nodeI
 
 void ModBeeOperations::clearNodeOperations(uint8_t nodeID) {
     // Remove all operations for a specific node
-    _pendingOps.erase(
-        std::remove_if(_pendingOps.begin(), _pendingOps.end(),
-            [nodeID](const PendingModbusOp& op) { return op.destNodeID == nodeID; }),
-        _pendingOps.end());
+    auto nodeOps = _pendingOps.forNode(nodeID);
+    for (auto it = nodeOps.begin(); it != nodeOps.end();) {
+        finishOperation(*it, MBEE_REQUEST_CANCELLED);
+        it = _pendingOps.erase(it);
+    }
+    for (auto& op : _transactions) {
+        if (op.req.transactionID != 0 && op.destNodeID == nodeID) {
+            finishOperation(op, MBEE_REQUEST_CANCELLED);
+            endTransaction(op);
+        }
+    }
     
     MBEE_DEBUG_OPERATIONS("CLEARED: All operations for Node %d", nodeID);
 }
@@ -207,107 +264,281 @@ void ModBeeOperations::applyFailsafeForNode(uint8_t nodeID) {
     MBEE_DEBUG_OPERATIONS("APPLYING FAILSAFE: Resetting variables for lost Node %d", nodeID);
     int cleared_vars = 0;
 
-    // Iterate through all pending operations. We use a classic for loop with an iterator
+    // Walk the lost node's operations. We use a classic for loop with an iterator
     // because we might remove elements, which would invalidate a range-based for loop.
-    for (auto it = _pendingOps.begin(); it != _pendingOps.end(); /* no increment here */) {
-        // Check if the operation is for the lost node and has a result pointer
-        if (it->destNodeID == nodeID && it->resultPtr != nullptr) {
-            // Determine the data type from the function code and reset the variable(s)
-            switch (it->req.function) {
-                case MB_FC_READ_COILS:
-                case MB_FC_READ_DISCRETE_INPUTS: {
-                    bool* values = static_cast<bool*>(it->resultPtr);
-                    for (uint16_t i = 0; i < it->req.quantity; ++i) {
-                        values[i] = false;
-                    }
-                    break;
-                }
-                case MB_FC_READ_HOLDING_REGISTERS:
-                case MB_FC_READ_INPUT_REGISTERS: {
-                    int16_t* values = static_cast<int16_t*>(it->resultPtr);
-                    for (uint16_t i = 0; i < it->req.quantity; ++i) {
-                        values[i] = 0;
-                    }
-                    break;
-                }
-                default:
-                    // This operation is not a read operation with a result pointer,
-                    // so we don't need to do anything for failsafe.
-                    break;
-            }
+    auto nodeOps = _pendingOps.forNode(nodeID);
+    for (auto it = nodeOps.begin(); it != nodeOps.end(); /* no increment here */) {
+        // Check if the operation has a result pointer
+        if (it->resultPtr != nullptr || !it->mergedReads.empty()) {
+            resetResultVariables(*it);
             cleared_vars++;
             // Remove the operation now that it's handled
+            finishOperation(*it, MBEE_REQUEST_CANCELLED);
             it = _pendingOps.erase(it);
         } else {
-            // Not for the target node or no result pointer, just move to the next operation
+            // No result pointer, just move to the next operation
             ++it;
         }
     }
+    
+    // Reads already sent to the lost node will not be answered either
+    for (auto& op : _transactions) {
+        if (op.req.transactionID != 0 && op.destNodeID == nodeID) {
+            if (op.resultPtr != nullptr || !op.mergedReads.empty()) {
+                resetResultVariables(op);
+                cleared_vars++;
+            }
+            finishOperation(op, MBEE_REQUEST_CANCELLED);
+            endTransaction(op);
+        }
+    }
 
     if (cleared_vars > 0) {
         MBEE_DEBUG_OPERATIONS("FAILSAFE APPLIED: Cleared %d variables and removed operations for Node %d", cleared_vars, nodeID);
     }
 }
 
+void ModBeeOperations::detachReads(uint8_t nodeID, uint8_t function, uint16_t startAddr, const void* resultPtr) {
+    // The caller's variables are going away. Their reads complete as cancelled now;
+    // a queued read left with no caller is dropped, one in flight still takes its
+    // response, but writes it nowhere
+    auto nodeOps = _pendingOps.forNode(nodeID);
+    for (auto it = nodeOps.begin(); it != nodeOps.end();) {
+        if (detachRead(*it, function, startAddr, resultPtr) && !it->resultPtr && it->mergedReads.empty()) {
+            finishOperation(*it, MBEE_REQUEST_CANCELLED);
+            it = _pendingOps.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto& op : _transactions) {
+        if (op.req.transactionID != 0 && op.destNodeID == nodeID) {
+            detachRead(op, function, startAddr, resultPtr);
+        }
+    }
+}
+
+bool ModBeeOperations::detachRead(PendingModbusOp& op, uint8_t function, uint16_t startAddr, const void* resultPtr) {
+    if (op.req.function != function) {
+        return false;
+    }
+    if (op.mergedReads.empty()) {
+        if (op.resultPtr != resultPtr || op.req.startAddr != startAddr) {
+            return false;
+        }
+        op.resultPtr = nullptr;
+        if (op.onComplete) {
+            _completions.push_back({std::move(op.onComplete), MBEE_REQUEST_CANCELLED, 0});
+            op.onComplete = nullptr;
+        }
+        return true;
+    }
+    
+    // A merged read keeps answering its other callers
+    bool detached = false;
+    for (auto it = op.mergedReads.begin(); it != op.mergedReads.end();) {
+        if (it->resultPtr == resultPtr && it->startAddr == startAddr) {
+            if (it->onComplete) {
+                _completions.push_back({std::move(it->onComplete), MBEE_REQUEST_CANCELLED, 0});
+            }
+            it = op.mergedReads.erase(it);
+            detached = true;
+        } else {
+            ++it;
+        }
+    }
+    return detached;
+}
+
+void ModBeeOperations::resetResultVariables(const PendingModbusOp& op) {
+    // A merged read resets every caller's variables over its own range
+    if (!op.mergedReads.empty()) {
+        for (const auto& target : op.mergedReads) {
+            resetValues(op.req.function, target.resultPtr, target.quantity);
+        }
+        return;
+    }
+    resetValues(op.req.function, op.resultPtr, op.req.quantity);
+}
+
+void ModBeeOperations::resetValues(uint8_t function, void* resultPtr, uint16_t quantity) {
+    if (!resultPtr) {
+        return;
+    }
+    
+    // Determine the data type from the function code and reset the variable(s)
+    switch (function) {
+        case MB_FC_READ_COILS:
+        case MB_FC_READ_DISCRETE_INPUTS: {
+            bool* values = static_cast<bool*>(resultPtr);
+            for (uint16_t i = 0; i < quantity; ++i) {
+                values[i] = false;
+            }
+            break;
+        }
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_READ_INPUT_REGISTERS: {
+            int16_t* values = static_cast<int16_t*>(resultPtr);
+            for (uint16_t i = 0; i < quantity; ++i) {
+                values[i] = 0;
+            }
+            break;
+        }
+        default:
+            // This operation is not a read operation with a result pointer,
+            // so we don't need to do anything for failsafe.
+            break;
+    }
+}
+
 // =============================================================================
 // OPERATION OPTIMIZATION AND PRIORITIZATION
 // =============================================================================
 void ModBeeOperations::prioritizeOperation(const PendingModbusOp& op) {
-    // Find the operation and move it to the front
-    for (auto it = _pendingOps.begin(); it != _pendingOps.end(); ++it) {
-        if (it->destNodeID == op.destNodeID && 
-            it->req.function == op.req.function && 
-            it->req.startAddr == op.req.startAddr) {
-            // Move to front
-            PendingModbusOp priorityOp = *it;
-            _pendingOps.erase(it);
-            _pendingOps.insert(_pendingOps.begin(), priorityOp);
+    // Find the operation and move it to the front of its priority class
+    for (auto& existingOp : _pendingOps.forNode(op.destNodeID)) {
+        if (existingOp.req.function == op.req.function && 
+            existingOp.req.startAddr == op.req.startAddr) {
+            _pendingOps.moveToFront(existingOp);
             break;
         }
     }
 }
 
-void ModBeeOperations::optimizeOperations() {
-    if (_pendingOps.empty()) {
-        return;
+bool ModBeeOperations::mergeOperation(const PendingModbusOp& op, const PendingModbusOp* before) {
+    // before: only operations queued ahead of it are considered (nullptr: the whole queue)
+    bool read = ModbusFrame::isReadFunction(op.req.function);
+    if (!read && !ModbusFrame::isWriteFunction(op.req.function)) {
+        return false;
     }
     
-    // Group operations by destination node
-    std::map<uint8_t, std::vector<PendingModbusOp*>> nodeGroups;
+    // Walk the destination's operations in arrival order for the last one this
+    // one may fold into. Nothing moves ahead of a write to the same registers:
+    // a read would see the old value, a write would be overwritten by the older one
+    ModBeeRegisterType type = ModbusFrame::getRegisterType(op.req.function);
+    uint32_t start = op.req.startAddr;
+    uint32_t end = start + std::max<uint16_t>(op.req.quantity, 1);
+    PendingModbusOp* target = nullptr;
+    for (auto& queued : _pendingOps.forNode(op.destNodeID)) {
+        if (&queued == before) {
+            break;
+        }
+        if (queued.group != op.group || ModbusFrame::getRegisterType(queued.req.function) != type) {
+            continue;
+        }
+        bool queuedWrite = ModbusFrame::isWriteFunction(queued.req.function);
+        bool overlaps = queued.req.startAddr < end &&
+                        start < (uint32_t)queued.req.startAddr + std::max<uint16_t>(queued.req.quantity, 1);
+        if (read) {
+            if (queuedWrite && overlaps) {
+                target = nullptr;
+            } else if (!queuedWrite && queued.priority == op.priority &&
+                       ModbusFrame::canCombineRequests(queued.req, op.req)) {
+                target = &queued;
+            }
+        } else if (overlaps) {
+            target = &queued;
+        }
+    }
+    if (!target) {
+        return false;
+    }
     
-    for (auto& op : _pendingOps) {
-        nodeGroups[op.destNodeID].push_back(&op);
+    if (read) {
+        absorbRead(*target, op);
+        _mergedReads++;
+    } else {
+        // Writes fold only into a write sent with them, in the same class and at the same time
+        if (!ModbusFrame::isWriteFunction(target->req.function) || target->priority != op.priority ||
+            target->req.applyAtUs != op.req.applyAtUs) {
+            return false;
+        }
+        if (target->req.function == op.req.function && target->req.startAddr == op.req.startAddr &&
+            target->req.quantity == op.req.quantity) {
+            // The same write again: the later values win, copied or read at send time
+            target->req.data = op.req.data;
+            target->resultPtr = op.resultPtr;
+            target->isArray = op.isArray;
+            target->arraySize = op.arraySize;
+        } else if (target->resultPtr || op.resultPtr || !ModbusFrame::mergeWriteRequest(target->req, op.req)) {
+            return false; // Values read at send time have nothing to patch
+        }
+        chainCompletion(target->onComplete, op.onComplete);
+        _mergedWrites++;
     }
     
-    // Optimize each node's operations
-    for (auto& nodeGroup : nodeGroups) {
-        // Sort by address for potential combining
-        auto& ops = nodeGroup.second;
-        std::sort(ops.begin(), ops.end(), 
-            [](const PendingModbusOp* a, const PendingModbusOp* b) {
-                if (a->req.function != b->req.function) {
-                    return a->req.function < b->req.function;
-                }
-                return a->req.startAddr < b->req.startAddr;
-            });
-        
-        // TODO: Implement operation combining logic
+    // What the operation's own delimited section would have taken
+    bool multicast = (op.destNodeID == MODBEE_BROADCAST_ID);
+    _bytesSaved += 2 + multicast + ModbusFrame::getRequestLength(op) +
+                   (read ? ModBeeFrame::getTransactionSectionLength(false) : 0) +
+                   (op.req.applyAtUs ? ModBeeFrame::getTimeSectionLength(multicast) : 0);
+    
+    MBEE_DEBUG_OPERATIONS("MERGED: Node:%d FC:%02X Addr:%d Qty:%d into Addr:%d Qty:%d", 
+        op.destNodeID, op.req.function, op.req.startAddr, op.req.quantity, target->req.startAddr, target->req.quantity);
+    return true;
+}
+
+void ModBeeOperations::absorbRead(PendingModbusOp& target, const PendingModbusOp& op) {
+    // The first merge moves the target's own variable into its list of callers
+    if (target.mergedReads.empty()) {
+        target.mergedReads.push_back({target.req.startAddr, target.req.quantity, target.resultPtr, std::move(target.onComplete)});
+        target.resultPtr = nullptr;
+        target.onComplete = nullptr;
+    }
+    if (op.mergedReads.empty()) {
+        target.mergedReads.push_back({op.req.startAddr, op.req.quantity, op.resultPtr, op.onComplete});
+    } else {
+        target.mergedReads.insert(target.mergedReads.end(), op.mergedReads.begin(), op.mergedReads.end());
     }
     
-    // Remove combined operations (marked with nodeID = 0)
-    _pendingOps.erase(
-        std::remove_if(_pendingOps.begin(), _pendingOps.end(),
-            [](const PendingModbusOp& op) { return op.destNodeID == 0; }),
-        _pendingOps.end());
+    ModbusRequest combined = ModbusFrame::combineRequests(target.req, op.req);
+    target.req.startAddr = combined.startAddr;
+    target.req.quantity = combined.quantity;
+    target.isArray = true;
+    target.arraySize = combined.quantity;
 }
 
-void ModBeeOperations::retryFailedOperations() {
-    unsigned long now = millis();
+bool ModBeeOperations::hasCompletion(const PendingModbusOp& op) {
+    if (op.onComplete) {
+        return true;
+    }
+    for (const auto& target : op.mergedReads) {
+        if (target.onComplete) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModBeeOperations::chainCompletion(ModBeeCompletion& first, const ModBeeCompletion& second) {
+    // A write folded into another completes when that one is sent
+    if (!second) {
+        return;
+    }
+    if (!first) {
+        first = second;
+        return;
+    }
+    ModBeeCompletion earlier = std::move(first);
+    first = [earlier, second](ModBeeRequestState state, uint8_t exceptionCode) {
+        earlier(state, exceptionCode);
+        second(state, exceptionCode);
+    };
+}
+
+void ModBeeOperations::optimizeOperations() {
+    if (_pendingOps.empty()) {
+        return;
+    }
     
-    // Reset timestamp for operations that should be retried
-    for (auto& op : _pendingOps) {
-        if (op.retryCount > 0 && (now - op.timestamp) > (ModBeeAPI::MODBEE_RETRY_DELAY_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES) {
-            op.timestamp = now;
+    // Fold every operation into an earlier one for the same node where allowed,
+    // which catches reads that only touch once a third one has widened them
+    auto pendingOps = _pendingOps.all();
+    for (auto it = pendingOps.begin(); it != pendingOps.end();) {
+        if (mergeOperation(*it, &*it)) {
+            it = _pendingOps.erase(it);
+        } else {
+            ++it;
         }
     }
 }
@@ -318,13 +549,17 @@ void ModBeeOperations::retryFailedOperations() {
 void ModBeeOperations::getStatistics(OperationStats& stats) const {
     stats.pendingOperations = _pendingOps.size();
     stats.pendingResponses = _pendingResponses.size();
-    stats.pendingReads = 0;  // Always 0 since we removed pending reads
+    stats.pendingReads = getTransactionCount();
+    stats.lateResponses = _lateResponses;
+    stats.mergedReads = _mergedReads;
+    stats.mergedWrites = _mergedWrites;
+    stats.bytesSaved = _bytesSaved;
     
     // Count operations by type
     stats.readOperations = 0;
     stats.writeOperations = 0;
     
-    for (const auto& op : _pendingOps) {
+    for (const auto& op : _pendingOps.all()) {
         if (ModbusFrame::isReadFunction(op.req.function)) {
             stats.readOperations++;
         } else if (ModbusFrame::isWriteFunction(op.req.function)) {
@@ -334,7 +569,7 @@ void ModBeeOperations::getStatistics(OperationStats& stats) const {
     
     // Count retry operations
     stats.retryOperations = 0;
-    for (const auto& op : _pendingOps) {
+    for (const auto& op : _pendingOps.all()) {
         if (op.retryCount > 0) {
             stats.retryOperations++;
         }
@@ -350,19 +585,15 @@ void ModBeeOperations::debugPrintOperations(ModBeeProtocol& protocol) const {
 // =============================================================================
 // CAPACITY MANAGEMENT
 // =============================================================================
-void ModBeeOperations::reserveCapacity(uint16_t opCount, uint16_t responseCount) {
-    // Reserve capacity to avoid frequent reallocations
-    if (opCount > 0) {
-        _pendingOps.reserve(opCount);
-    }
-    
+void ModBeeOperations::reserveCapacity(uint16_t responseCount) {
+    // Operations live in a fixed pool; only the response queue can grow
     if (responseCount > 0) {
         _pendingResponses.reserve(responseCount);
     }
 }
 
 bool ModBeeOperations::canAddOperation() const {
-    return _pendingOps.size() < MODBEE_MAX_PENDING_OPS;
+    return !_pendingOps.full();
 }
 
 bool ModBeeOperations::canAddResponse() const {
@@ -380,36 +611,18 @@ uint16_t ModBeeOperations::getAvailableResponseSlots() const {
 // =============================================================================
 // OPERATION PROCESSING
 // =============================================================================
-void ModBeeOperations::processPendingOperations(ModBeeProtocol& protocol) {
-    // This method is called to check if any operations need processing
-    // The actual sending is done when the protocol has the token
-    
-    // Check for operations that need retry
-    unsigned long now = millis();
-    int readyOps = 0;
-    
-    for (auto& op : _pendingOps) {
-        if (isOperationReady(op)) {
-            readyOps++;
-        }
-    }
-    
-    if (readyOps > 0) {
-        // Operations are ready for processing
-    }
-}
-
 void ModBeeOperations::clearPendingOps() {
     clearPendingOperations();
 }
 
 void ModBeeOperations::removePendingOperation(const PendingModbusOp& op) {
-    for (auto it = _pendingOps.begin(); it != _pendingOps.end(); ++it) {
-        if (it->destNodeID == op.destNodeID && 
-            it->req.function == op.req.function && 
-            it->req.startAddr == op.req.startAddr &&
-            it->req.quantity == op.req.quantity) {
-            _pendingOps.erase(it);
+    for (auto& existingOp : _pendingOps.forNode(op.destNodeID)) {
+        if (existingOp.group == op.group &&
+            existingOp.req.function == op.req.function && 
+            existingOp.req.startAddr == op.req.startAddr &&
+            existingOp.req.quantity == op.req.quantity) {
+            finishOperation(existingOp, MBEE_REQUEST_CANCELLED);
+            _pendingOps.remove(existingOp);
             MBEE_DEBUG_OPERATIONS("REMOVED: Op Node:%d FC:%02X Addr:%d", 
                 op.destNodeID, op.req.function, op.req.startAddr);
             break;
@@ -429,22 +642,127 @@ void ModBeeOperations::removePendingResponse(const ModbusRequest& response) {
     }
 }
 
-bool ModBeeOperations::isOperationReady(const PendingModbusOp& op) const {
-    unsigned long now = millis();
+void ModBeeOperations::removePackedEntries(uint16_t opCount, uint16_t responseCount) {
+    // Data frames pack a prefix of each queue: packed operations come off the
+    // front of the pool one by one, responses in one range erase
+    opCount = std::min(opCount, _pendingOps.size());
+    responseCount = std::min(responseCount, (uint16_t)_pendingResponses.size());
     
-    // Check if operation has completely timed out
-    if (op.retryCount >= ModBeeAPI::MODBEE_MAX_RETRIES) {
-        return false; // Too many retries
+    // Reads tagged while packing now wait for their response in the transaction
+    // table. Writes are not answered: once sent they are done
+    for (uint16_t i = 0; i < opCount; i++) {
+        PendingModbusOp* op = _pendingOps.front();
+        if (op->unbuildable) {
+            MBEE_DEBUG_OPERATIONS("FAILED: Op Node:%d FC:%02X Addr:%d has no encoding",
+                op->destNodeID, op->req.function, op->req.startAddr);
+            finishOperation(*op, MBEE_REQUEST_FAILED);
+        } else if (op->req.transactionID != 0) {
+            beginTransaction(*op);
+        } else {
+            finishOperation(*op, MBEE_REQUEST_DONE);
+        }
+        _pendingOps.remove(*op);
     }
     
-    // For first attempt
-    if (op.retryCount == 0) {
-        return true; // Always ready for first send
+    _pendingResponses.erase(_pendingResponses.begin(), _pendingResponses.begin() + responseCount);
+    
+    if (opCount > 0 || responseCount > 0) {
+        MBEE_DEBUG_OPERATIONS("REMOVED: %d ops, %d responses sent in data frame", opCount, responseCount);
+    }
+}
+
+// =============================================================================
+// TRANSACTIONS
+// =============================================================================
+uint8_t ModBeeOperations::assignTransactionID(PendingModbusOp& op, uint16_t reserved) {
+    // reserved: reads already tagged for the frame being built, not yet in the table
+    op.req.transactionID = 0;
+    if (reserved >= _freeTransactionCount) {
+        return 0;
     }
     
-    // For retries, check if enough time has passed
-    unsigned long timeSinceLastAttempt = now - op.timestamp;
-    return timeSinceLastAttempt >= (ModBeeAPI::MODBEE_RETRY_DELAY_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES;
+    // IDs are handed out in turn so each is reused as late as possible. Framing
+    // bytes are skipped, which lets plain frames carry the ID unescaped
+    do {
+        _nextTransactionID++;
+    } while (_nextTransactionID == 0 || _transactionSlots[_nextTransactionID] != 0 ||
+             _nextTransactionID == MODBEE_SOF || _nextTransactionID == MODBEE_PACKET_DELIM ||
+             _nextTransactionID == MODBEE_ESCAPE);
+    
+    op.req.transactionID = _nextTransactionID;
+    return _nextTransactionID;
+}
+
+uint16_t ModBeeOperations::getTransactionCount() const {
+    return MODBEE_MAX_TRANSACTIONS - _freeTransactionCount;
+}
+
+void ModBeeOperations::beginTransaction(PendingModbusOp& op) {
+    // The packed entry is erased right after, so its contents can be moved
+    if (_freeTransactionCount == 0 || _transactionSlots[op.req.transactionID] != 0) {
+        return;
+    }
+    uint8_t slot = _freeTransactionSlots[--_freeTransactionCount];
+    _transactions[slot] = std::move(op);
+    _transactions[slot].timestamp = millis();
+    _transactionSlots[_transactions[slot].req.transactionID] = slot + 1;
+    _transactionTimers.arm(slot, _transactions[slot].timestamp);
+}
+
+void ModBeeOperations::endTransaction(PendingModbusOp& op) {
+    uint8_t transactionID = op.req.transactionID;
+    if (transactionID == 0 || _transactionSlots[transactionID] == 0) {
+        return;
+    }
+    uint8_t slot = _transactionSlots[transactionID] - 1;
+    _freeTransactionSlots[_freeTransactionCount++] = slot;
+    _transactionSlots[transactionID] = 0;
+    _transactionTimers.disarm(slot);
+    op = PendingModbusOp();
+}
+
+void ModBeeOperations::clearTransactions() {
+    for (uint8_t i = 0; i < MODBEE_MAX_TRANSACTIONS; i++) {
+        _transactions[i] = PendingModbusOp();
+        _freeTransactionSlots[i] = MODBEE_MAX_TRANSACTIONS - 1 - i;
+    }
+    _freeTransactionCount = MODBEE_MAX_TRANSACTIONS;
+    memset(_transactionSlots, 0, sizeof(_transactionSlots));
+    _transactionTimers.clear();
+}
+
+// =============================================================================
+// COMPLETIONS
+// =============================================================================
+void ModBeeOperations::finishOperation(PendingModbusOp& op, ModBeeRequestState state, uint8_t exceptionCode) {
+    // Every caller a merged read answers hears the same outcome
+    if (op.onComplete) {
+        _completions.push_back({std::move(op.onComplete), state, exceptionCode});
+        op.onComplete = nullptr;
+    }
+    for (auto& target : op.mergedReads) {
+        if (target.onComplete) {
+            _completions.push_back({std::move(target.onComplete), state, exceptionCode});
+            target.onComplete = nullptr;
+        }
+    }
+}
+
+void ModBeeOperations::dispatchCompletions() {
+    // Swapped out first: a callback may start the next request. The buffer comes
+    // back afterwards unless callbacks finished more, so it is not reallocated per batch
+    if (_completions.empty()) {
+        return;
+    }
+    std::vector<FinishedOperation> completions;
+    completions.swap(_completions);
+    for (auto& finished : completions) {
+        finished.onComplete(finished.state, finished.exceptionCode);
+    }
+    if (_completions.empty()) {
+        completions.clear();
+        _completions.swap(completions);
+    }
 }
 
 // =============================================================================
@@ -454,42 +772,83 @@ bool ModBeeOperations::matchAndFulfillResponse(const ModbusRequest& response, ui
     // Find matching pending request
     PendingModbusOp* matchingOp = findMatchingRequest(srcNodeID, response);
     
-    if (matchingOp) {
+    if (!matchingOp) {
+        _lateResponses++;
+        return false;
+    }
+    
+    // An exception response ends the transaction but leaves the variable alone
+    bool exception = (response.function & 0x80) != 0;
+    if (!exception) {
         // Write response data directly to user's variable
         writeResponseToVariable(*matchingOp, response);
-        
-        // Call completion callback if provided
-        if (matchingOp->onComplete) {
-            matchingOp->onComplete();
-        }
-        
-        // Remove the fulfilled operation
-        removePendingOperation(*matchingOp);
-        
-        MBEE_DEBUG_OPERATIONS("FULFILLED: Direct response for Node:%d FC:%02X Addr:%d", 
-            srcNodeID, response.function, response.startAddr);
-        return true;
     }
     
-    return false;
+    if (exception) {
+        finishOperation(*matchingOp, MBEE_REQUEST_EXCEPTION,
+                        response.data.empty() ? MB_EX_SLAVE_DEVICE_FAILURE : response.data[0]);
+    } else {
+        finishOperation(*matchingOp, MBEE_REQUEST_DONE);
+    }
+    endTransaction(*matchingOp);
+    
+    MBEE_DEBUG_OPERATIONS("FULFILLED: Direct response for Node:%d FC:%02X Addr:%d TID:%d", 
+        srcNodeID, response.function, response.startAddr, response.transactionID);
+    return true;
 }
 
 PendingModbusOp* ModBeeOperations::findMatchingRequest(uint8_t srcNodeID, const ModbusRequest& response) {
-    uint8_t baseFunction = response.function & 0x7F; // Remove error bit
+    // Tagged responses index the transaction table directly. An ID that is no
+    // longer in flight belongs to a read that completed or was retried already
+    if (response.transactionID != 0) {
+        uint8_t slot = _transactionSlots[response.transactionID];
+        if (slot != 0 && matchesResponse(_transactions[slot - 1], srcNodeID, response)) {
+            return &_transactions[slot - 1];
+        }
+        return nullptr;
+    }
     
-    for (auto& op : _pendingOps) {
-        if (op.destNodeID == srcNodeID &&
-            op.req.function == baseFunction &&
-            op.req.startAddr == response.startAddr &&
-            op.req.quantity == response.quantity) {
-            return &op;
+    // Responders without transaction sections answer in request order, so the
+    // oldest read of the range is the one answered. Their exceptions carry no
+    // range and cannot be matched
+    if (response.function & 0x80) {
+        return nullptr;
+    }
+    
+    PendingModbusOp* oldest = nullptr;
+    for (auto& op : _transactions) {
+        if (op.req.transactionID != 0 && matchesResponse(op, srcNodeID, response) &&
+            (!oldest || (int32_t)(op.timestamp - oldest->timestamp) < 0)) {
+            oldest = &op;
         }
     }
+    return oldest;
+}
+
+bool ModBeeOperations::matchesResponse(const PendingModbusOp& op, uint8_t srcNodeID, const ModbusRequest& response) {
+    uint8_t baseFunction = response.function & 0x7F; // Remove error bit
+    if (op.destNodeID != srcNodeID || op.req.function != baseFunction) {
+        return false;
+    }
+    if (response.function & 0x80) {
+        return true;
+    }
+    if (op.req.startAddr != response.startAddr) {
+        return false;
+    }
     
-    return nullptr;
+    // Bit responses only give the quantity to a whole byte
+    if (baseFunction == MB_FC_READ_COILS || baseFunction == MB_FC_READ_DISCRETE_INPUTS) {
+        return ModbusFrame::getBitPackedBytes(op.req.quantity) == ModbusFrame::getBitPackedBytes(response.quantity);
+    }
+    return op.req.quantity == response.quantity;
 }
 
 void ModBeeOperations::writeResponseToVariable(const PendingModbusOp& op, const ModbusRequest& response) {
+    if (!op.mergedReads.empty()) {
+        writeMergedReads(op, response);
+        return;
+    }
     if (!op.resultPtr) {
         return; // No variable to write to
     }
@@ -575,4 +934,35 @@ bool ModBeeOperations::extractRegisterData(const ModbusRequest& response, int16_
     }
     
     return true;
-}
\ No newline at end of file
+}
+
+void ModBeeOperations::writeMergedReads(const PendingModbusOp& op, const ModbusRequest& response) {
+    // Response data is [BYTE COUNT] [DATA] for the merged range; each caller gets its share
+    if (response.data.empty()) {
+        return;
+    }
+    const uint8_t* data = &response.data[1];
+    uint16_t dataLength = std::min((size_t)response.data[0], response.data.size() - 1);
+    bool bits = (op.req.function == MB_FC_READ_COILS || op.req.function == MB_FC_READ_DISCRETE_INPUTS);
+    
+    for (const auto& target : op.mergedReads) {
+        if (!target.resultPtr) {
+            continue;
+        }
+        uint16_t first = target.startAddr - op.req.startAddr;
+        for (uint16_t i = 0; i < target.quantity; i++) {
+            uint16_t index = first + i;
+            if (bits) {
+                if ((index >> 3) >= dataLength) {
+                    break;
+                }
+                static_cast<bool*>(target.resultPtr)[i] = (data[index >> 3] >> (index & 7)) & 0x01;
+            } else {
+                if (index * 2 + 1 >= dataLength) {
+                    break;
+                }
+                static_cast<int16_t*>(target.resultPtr)[i] = (int16_t)((data[index * 2] << 8) | data[index * 2 + 1]);
+            }
+        }
+    }
+}
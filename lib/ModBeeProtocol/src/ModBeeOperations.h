@@ -16,20 +16,23 @@ public:
     // =============================================================================
     // OPERATION MANAGEMENT
     // =============================================================================
-    void addPendingOperation(const PendingModbusOp& op, ModBeeProtocol& protocol);
+    bool addPendingOperation(const PendingModbusOp& op, ModBeeProtocol& protocol);   // False when the queue is full
     void addPendingResponse(const PendingResponse& response);
     void removePendingOperation(const PendingModbusOp& op);
     void removePendingResponse(const ModbusRequest& response);
+    void removePackedEntries(uint16_t opCount, uint16_t responseCount);
     void clearPendingOperations();
     void clearPendingResponses();
     void clearNodeOperations(uint8_t nodeID);
     void applyFailsafeForNode(uint8_t nodeID);
+    void detachReads(uint8_t nodeID, uint8_t function, uint16_t startAddr, const void* resultPtr);
     
     // =============================================================================
     // ACCESS METHODS
     // =============================================================================
-    std::vector<PendingModbusOp>& getPendingOps();
-    const std::vector<PendingModbusOp>& getPendingOps() const;
+    // Send order: high-priority operations first, then in arrival order
+    ModBeeOpPool::Range<PendingModbusOp> getPendingOps() { return _pendingOps.all(); }
+    ModBeeOpPool::Range<const PendingModbusOp> getPendingOps() const { return _pendingOps.all(); }
     std::vector<PendingResponse>& getPendingResponses();
     const std::vector<PendingResponse>& getPendingResponses() const;
     
@@ -46,21 +49,19 @@ public:
     // NODE-SPECIFIC QUERIES
     // =============================================================================
     bool hasOperationsForNode(uint8_t nodeID) const;
-    std::vector<PendingModbusOp> getOperationsForNode(uint8_t nodeID) const;
+    ModBeeOpPool::Range<const PendingModbusOp> getOperationsForNode(uint8_t nodeID) const { return _pendingOps.forNode(nodeID); }
     std::vector<PendingResponse> getResponsesForNode(uint8_t nodeID) const;
     
     // =============================================================================
     // OPERATION OPTIMIZATION AND PRIORITIZATION
     // =============================================================================
     void prioritizeOperation(const PendingModbusOp& op);
+    bool mergeOperation(const PendingModbusOp& op, const PendingModbusOp* before = nullptr);
     void optimizeOperations();
-    void retryFailedOperations();
-    bool isOperationReady(const PendingModbusOp& op) const;
     
     // =============================================================================
     // PROCESSING AND CLEANUP
     // =============================================================================
-    void processPendingOperations(ModBeeProtocol& protocol);
     void cleanupTimedOutOperations(ModBeeProtocol& protocol);
     void debugPrintOperations(ModBeeProtocol& protocol) const;
     
@@ -72,12 +73,24 @@ public:
     // =============================================================================
     // CAPACITY MANAGEMENT
     // =============================================================================
-    void reserveCapacity(uint16_t opCount, uint16_t responseCount);
+    void reserveCapacity(uint16_t responseCount);
     bool canAddOperation() const;
     bool canAddResponse() const;
     uint16_t getAvailableOpSlots() const;
     uint16_t getAvailableResponseSlots() const;
 
+    // =============================================================================
+    // TRANSACTIONS
+    // =============================================================================
+    uint8_t assignTransactionID(PendingModbusOp& op, uint16_t reserved);
+    uint16_t getTransactionCount() const;
+
+    // =============================================================================
+    // COMPLETIONS
+    // =============================================================================
+    // Runs the callbacks of operations that finished since the last call
+    void dispatchCompletions();
+
     // =============================================================================
     // DIRECT RESPONSE MATCHING AND FULFILLMENT
     // =============================================================================
@@ -86,15 +99,51 @@ public:
     PendingModbusOp* findMatchingRequest(uint8_t srcNodeID, const ModbusRequest& response);
 
 private:
+    struct FinishedOperation {
+        ModBeeCompletion onComplete;
+        ModBeeRequestState state;
+        uint8_t exceptionCode;
+    };
+
     // =============================================================================
     // OPERATION STORAGE
     // =============================================================================
-    std::vector<PendingModbusOp> _pendingOps;
+    ModBeeOpPool _pendingOps;
     std::vector<PendingResponse> _pendingResponses;
+    
+    // Reads sent and awaiting their response, addressed by transaction ID in O(1)
+    PendingModbusOp _transactions[MODBEE_MAX_TRANSACTIONS];
+    uint8_t _transactionSlots[256];     // Transaction ID -> slot + 1, 0 = not in flight
+    uint8_t _freeTransactionSlots[MODBEE_MAX_TRANSACTIONS];
+    uint8_t _freeTransactionCount;
+    ModBeeTimerQueue<MODBEE_MAX_TRANSACTIONS> _transactionTimers;   // Slots in flight, oldest first
+    uint8_t _nextTransactionID;
+    uint32_t _lateResponses;
+    uint32_t _mergedReads;
+    uint32_t _mergedWrites;
+    uint32_t _bytesSaved;
+    std::vector<FinishedOperation> _completions;    // Held until dispatchCompletions()
+    
+    // =============================================================================
+    // TRANSACTION HELPERS
+    // =============================================================================
+    void beginTransaction(PendingModbusOp& op);
+    void endTransaction(PendingModbusOp& op);
+    void clearTransactions();
+    bool isQueued(const PendingModbusOp& op) const;
+    static bool matchesResponse(const PendingModbusOp& op, uint8_t srcNodeID, const ModbusRequest& response);
+    static void resetResultVariables(const PendingModbusOp& op);
+    static void resetValues(uint8_t function, void* values, uint16_t quantity);
+    static void absorbRead(PendingModbusOp& target, const PendingModbusOp& op);
+    static bool hasCompletion(const PendingModbusOp& op);
+    bool detachRead(PendingModbusOp& op, uint8_t function, uint16_t startAddr, const void* resultPtr);
+    static void chainCompletion(ModBeeCompletion& first, const ModBeeCompletion& second);
+    void finishOperation(PendingModbusOp& op, ModBeeRequestState state, uint8_t exceptionCode = 0);
 
     // =============================================================================
     // HELPER METHODS FOR DIRECT RESPONSE
     // =============================================================================
     bool extractCoilData(const ModbusRequest& response, bool* values, uint16_t maxValues);
     bool extractRegisterData(const ModbusRequest& response, int16_t* values, uint16_t maxValues);
+    void writeMergedReads(const PendingModbusOp& op, const ModbusRequest& response);
 };
\ No newline at end of file
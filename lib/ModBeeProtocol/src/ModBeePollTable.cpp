@@ -0,0 +1,273 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// CONSTRUCTOR AND DESTRUCTOR
+// =============================================================================
+ModBeePollTable::ModBeePollTable()
+    : _nextID(0),
+      _lastHolds(0),
+      _nextDueMs(0) {
+}
+
+ModBeePollTable::~ModBeePollTable() {
+    clear();
+}
+
+// =============================================================================
+// POINTS
+// =============================================================================
+bool ModBeePollTable::addPoint(uint8_t nodeID, uint8_t function, uint16_t startAddr, uint16_t quantity, void* values,
+                               unsigned long periodMs, ModBeePriority priority) {
+    ModbusRequest request;
+    request.function = function;
+    request.startAddr = startAddr;
+    request.quantity = quantity;
+    if (nodeID == MODBEE_BROADCAST_ID || !values || periodMs == 0 ||
+        !ModbusFrame::isReadFunction(function) || !ModbusFrame::validateRequest(request)) {
+        return false;
+    }
+
+    // Polling a range again rebinds it. The owner detaches a read still outstanding
+    // from the old variables (ModBeeAPI does), or it completes into them
+    for (auto& point : _points) {
+        if (point.nodeID == nodeID && point.function == function && point.startAddr == startAddr) {
+            point.quantity = quantity;
+            point.values = values;
+            point.periodMs = periodMs;
+            point.priority = priority;
+            return true;
+        }
+    }
+
+    if (_points.size() >= MODBEE_MAX_POLL_POINTS) {
+        return false;
+    }
+
+    // Golden-ratio phases: each new point lands in the largest gap the earlier
+    // ones left, so a table filled at start-up does not fall due all at once
+    uint32_t now = millis();
+    uint32_t phase = (_nextID * 40503u) & 0xFFFF;
+
+    ModBeePollPoint point;
+    point.id = _nextID++;
+    point.nodeID = nodeID;
+    point.function = function;
+    point.startAddr = startAddr;
+    point.quantity = quantity;
+    point.values = values;
+    point.periodMs = periodMs;
+    point.nextDueMs = now + (uint32_t)(((uint64_t)periodMs * phase) >> 16);
+    point.priority = priority;
+    point.outstanding = false;
+
+    if (_points.empty() || (int32_t)(point.nextDueMs - _nextDueMs) < 0) {
+        _nextDueMs = point.nextDueMs;
+    }
+    _points.push_back(point);
+    return true;
+}
+
+bool ModBeePollTable::removePoint(uint8_t nodeID, uint8_t function, uint16_t startAddr) {
+    for (auto it = _points.begin(); it != _points.end(); ++it) {
+        if (it->nodeID == nodeID && it->function == function && it->startAddr == startAddr) {
+            _points.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModBeePollTable::clear() {
+    _points.clear();
+    _due.clear();
+    _early.clear();
+    _batch.clear();
+}
+
+const ModBeePollPoint* ModBeePollTable::findPoint(uint8_t nodeID, uint8_t function, uint16_t startAddr) const {
+    for (const auto& point : _points) {
+        if (point.nodeID == nodeID && point.function == function && point.startAddr == startAddr) {
+            return &point;
+        }
+    }
+    return nullptr;
+}
+
+ModBeePollPoint* ModBeePollTable::findByID(uint32_t id) {
+    auto it = std::lower_bound(_points.begin(), _points.end(), id,
+                               [](const ModBeePollPoint& point, uint32_t value) { return point.id < value; });
+    return (it != _points.end() && it->id == id) ? &*it : nullptr;
+}
+
+// =============================================================================
+// SCHEDULING
+// =============================================================================
+uint16_t ModBeePollTable::service(uint32_t now, uint32_t tokenHolds, bool queueDrained, const Issuer& issue) {
+    // At most one walk per token hold, and only once something has fallen due
+    if (_points.empty() || tokenHolds == _lastHolds || (int32_t)(now - _nextDueMs) < 0) {
+        return 0;
+    }
+    _lastHolds = tokenHolds;
+    if (!queueDrained) {
+        _stats.skippedHolds++;
+        return 0;
+    }
+
+    uint32_t nextDue = now + INT32_MAX;
+    auto earliest = [&nextDue](uint32_t dueMs) {
+        if ((int32_t)(dueMs - nextDue) < 0) {
+            nextDue = dueMs;
+        }
+    };
+
+    _due.clear();
+    _early.clear();
+    for (uint16_t i = 0; i < _points.size(); i++) {
+        ModBeePollPoint& point = _points[i];
+        if ((int32_t)(now - point.nextDueMs) < 0) {
+            if (!point.outstanding && point.nextDueMs - now <= point.periodMs / 2) {
+                _early.push_back(i);
+            }
+            earliest(point.nextDueMs);
+            continue;
+        }
+        if (point.outstanding) {
+            // The node has not answered the last read yet: skip a period rather than double up
+            advance(point, now);
+            _stats.overruns++;
+            earliest(point.nextDueMs);
+            continue;
+        }
+        _due.push_back(i);
+    }
+
+    // Most overdue first, up to the byte budget. A range that touches one already
+    // admitted merges into its read and costs nothing more
+    std::sort(_due.begin(), _due.end(), [this](uint16_t a, uint16_t b) {
+        return (int32_t)(_points[a].nextDueMs - _points[b].nextDueMs) < 0;
+    });
+
+    uint32_t budget = ModBeeAPI::MODBEE_POLL_BYTES_PER_HOLD;
+    uint32_t bytes = 0;
+    _batch.clear();
+    for (uint16_t index : _due) {
+        const ModBeePollPoint& point = _points[index];
+        uint16_t cost = getRequestCost();
+        for (uint16_t admitted : _batch) {
+            if (touches(point, _points[admitted])) {
+                cost = 0;
+                break;
+            }
+        }
+        if (budget != 0 && cost > 0 && !_batch.empty() && bytes + cost > budget) {
+            _stats.deferred++;
+            nextDue = now;
+            continue;
+        }
+        bytes += cost;
+        _batch.push_back(index);
+    }
+
+    // Points in the second half of their period ride along with a read they touch.
+    // They take its phase from then on, so a block polled one register at a time
+    // comes together into one read after the first period
+    std::sort(_early.begin(), _early.end(), [this](uint16_t a, uint16_t b) {
+        return _points[a].startAddr < _points[b].startAddr;
+    });
+    for (uint16_t index : _early) {
+        for (uint16_t admitted : _batch) {
+            if (touches(_points[index], _points[admitted])) {
+                _batch.push_back(index);
+                break;
+            }
+        }
+    }
+
+    // Queued grouped by node and address, so neighbouring ranges meet in the merge
+    std::sort(_batch.begin(), _batch.end(), [this](uint16_t a, uint16_t b) {
+        const ModBeePollPoint& x = _points[a];
+        const ModBeePollPoint& y = _points[b];
+        if (x.nodeID != y.nodeID) return x.nodeID < y.nodeID;
+        if (x.function != y.function) return x.function < y.function;
+        return x.startAddr < y.startAddr;
+    });
+
+    uint16_t queued = 0;
+    for (uint16_t index : _batch) {
+        ModBeePollPoint& point = _points[index];
+        uint32_t id = point.id;
+        ModBeeRequestState state = issue(point, [this, id](ModBeeRequestState result, uint8_t) {
+            complete(id, result);
+        });
+        if ((int32_t)(now - point.nextDueMs) < 0) {
+            point.nextDueMs = now + point.periodMs;
+        } else {
+            advance(point, now);
+        }
+        earliest(point.nextDueMs);
+
+        if (state == MBEE_REQUEST_PENDING) {
+            point.outstanding = true;
+            queued++;
+        } else if (state != MBEE_REQUEST_DONE) {
+            // Node gone or queue full: try again next period
+            _stats.failures++;
+        }
+    }
+
+    _stats.polls += queued;
+    if (queued > 0) {
+        _stats.batches++;
+    }
+    _nextDueMs = nextDue;
+    return queued;
+}
+
+void ModBeePollTable::complete(uint32_t id, ModBeeRequestState state) {
+    ModBeePollPoint* point = findByID(id);
+    if (!point) {
+        return; // Removed while its read was out
+    }
+    point->outstanding = false;
+    if (state != MBEE_REQUEST_DONE) {
+        _stats.failures++;
+    }
+}
+
+void ModBeePollTable::advance(ModBeePollPoint& point, uint32_t now) {
+    // Keep the phase, but a point a whole period behind restarts from now
+    // instead of catching up with a burst of reads
+    point.nextDueMs += point.periodMs;
+    if ((int32_t)(now - point.nextDueMs) >= 0) {
+        point.nextDueMs = now + point.periodMs;
+    }
+}
+
+uint16_t ModBeePollTable::getRequestCost() {
+    // A tagged read in plain sections, the larger encoding: transaction section,
+    // then [DELIM] [DEST] [FC] [ADDR] [QTY]
+    return ModBeeFrame::getTransactionSectionLength(false) + 2 + 5;
+}
+
+bool ModBeePollTable::touches(const ModBeePollPoint& a, const ModBeePollPoint& b) {
+    return a.nodeID == b.nodeID && a.function == b.function &&
+           a.startAddr <= (uint32_t)b.startAddr + b.quantity &&
+           b.startAddr <= (uint32_t)a.startAddr + a.quantity;
+}
+
+// =============================================================================
+// STATISTICS
+// =============================================================================
+ModBeePollStats ModBeePollTable::getStatistics() const {
+    ModBeePollStats stats = _stats;
+    stats.points = _points.size();
+    stats.outstanding = 0;
+    for (const auto& point : _points) {
+        stats.outstanding += point.outstanding;
+    }
+    return stats;
+}
+
+void ModBeePollTable::resetStatistics() {
+    _stats = ModBeePollStats();
+}
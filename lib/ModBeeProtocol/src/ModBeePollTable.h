@@ -0,0 +1,80 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// STATISTICS STRUCTURE
+// =============================================================================
+struct ModBeePollStats {
+    uint16_t points = 0;                // Entries in the table
+    uint16_t outstanding = 0;           // Points with a read queued or awaiting its response
+    uint32_t polls = 0;                 // Reads queued for due points
+    uint32_t batches = 0;               // Token holds a batch of reads was queued behind
+    uint32_t skippedHolds = 0;          // Holds that left operations queued: no batch behind them
+    uint32_t deferred = 0;              // Due points left for a later hold by MODBEE_POLL_BYTES_PER_HOLD
+    uint32_t overruns = 0;              // Periods skipped because the last read was still outstanding
+    uint32_t failures = 0;              // Reads not queued, or ended by an exception, timeout or cancel
+};
+
+/**
+ * Polling table: remote ranges read on a period
+ * Points are not read the moment they fall due. The table is walked once per
+ * token hold, after the data frame has gone out: the due points, most overdue
+ * first, are admitted until MODBEE_POLL_BYTES_PER_HOLD of request sections is
+ * reached and queued sorted by node, function and address, so ranges that touch
+ * merge into one read and each node answers them in one response. The batch
+ * rides in our next data frame. A hold that left operations queued (frame full
+ * or rotation budget spent) gets no batch, so polls never pile up behind a
+ * late token. First due times are spread over each period so points added
+ * together do not fall due together.
+ */
+class ModBeePollTable {
+public:
+    // Queues a read for the point, returns what readHreg_impl() and friends return
+    typedef std::function<ModBeeRequestState(const ModBeePollPoint& point, ModBeeCompletion onComplete)> Issuer;
+
+    // =============================================================================
+    // CONSTRUCTOR AND DESTRUCTOR
+    // =============================================================================
+    ModBeePollTable();
+    ~ModBeePollTable();
+
+    // =============================================================================
+    // POINTS
+    // =============================================================================
+    bool addPoint(uint8_t nodeID, uint8_t function, uint16_t startAddr, uint16_t quantity, void* values,
+                  unsigned long periodMs, ModBeePriority priority);
+    bool removePoint(uint8_t nodeID, uint8_t function, uint16_t startAddr);
+    void clear();
+    const ModBeePollPoint* findPoint(uint8_t nodeID, uint8_t function, uint16_t startAddr) const;
+    uint16_t size() const { return _points.size(); }
+    bool empty() const { return _points.empty(); }
+
+    // =============================================================================
+    // SCHEDULING
+    // =============================================================================
+    // Call every loop: queues one batch per token hold, returns the reads queued.
+    // queueDrained tells whether the last hold sent every queued operation
+    uint16_t service(uint32_t now, uint32_t tokenHolds, bool queueDrained, const Issuer& issue);
+
+    // =============================================================================
+    // STATISTICS
+    // =============================================================================
+    ModBeePollStats getStatistics() const;
+    void resetStatistics();
+
+private:
+    std::vector<ModBeePollPoint> _points;   // In id order, for lookups from completions
+    std::vector<uint16_t> _due;             // Scratch: indexes of due points
+    std::vector<uint16_t> _early;           // Scratch: indexes of points in the second half of their period
+    std::vector<uint16_t> _batch;           // Scratch: indexes admitted this hold
+    uint32_t _nextID;
+    uint32_t _lastHolds;                    // Token holds seen at the last walk
+    uint32_t _nextDueMs;                    // No point is due before this
+    ModBeePollStats _stats;
+
+    void complete(uint32_t id, ModBeeRequestState state);
+    ModBeePollPoint* findByID(uint32_t id);
+    static void advance(ModBeePollPoint& point, uint32_t now);
+    static uint16_t getRequestCost();
+    static bool touches(const ModBeePollPoint& a, const ModBeePollPoint& b);
+};
@@ -6,16 +6,27 @@
 ModBeeProtocol::ModBeeProtocol() 
     : _nodeID(0), 
       _state(MBEE_DISCONNECTED),
-      _knownNodeCount(0),
       _packetHandler(nullptr),
       _errorHandler(nullptr),
       _io(nullptr),
       _lastTokenSeen(0),
       _lastTimeAsMaster(0),
+      _tokenSequence(0),
+      _lastTokenTo(0),
+      _lastTokenInvitation(false),
+      _sequenceAnnounced(false),
       _tokenReceivedForUs(false),     
       _tokenConfirmed(false),         
       _tokenRetryNode(0),
       _tokenRetryCount(0),
+      _tokenHeld(false),
+      _tokenHoldRecorded(false),
+      _tokenRotationValid(false),
+      _tokenArrivalUs(0),
+      _tokenRotationUs(0),
+      _rotationEstimateValid(false),
+      _rotationMeanUs(0),
+      _rotationDevUs(0),
       _isCoordinator(false),
       _currentJoinNodeID(1),
       _lastJoinInvitation(0),
@@ -23,27 +34,36 @@ ModBeeProtocol::ModBeeProtocol()
       _invitedNodeID(0),
       _buildingNetwork(false),
       _networkBuildStart(0),
+      _joinRangeCount(0),
+      _joinWindowOpen(false),
+      _joinWindowEndUs(0),
+      _joinWindowHeard(0),
       _lastJoinManagement(0),
       _waitingForInvitation(false),
       _joinWaitStart(0),
       _invitationReceived(false),
       _invitationFromNode(0),
+      _joinSlotPending(false),
+      _joinSlotDueUs(0),
+      _awaitingFirstToken(false),
       _randomInitialListenTime(0),
       _initialListenTimeSet(false),
       _networkActivityDetected(false),
       _firstActivityTime(0),
       _stateEntryTime(0),
+      _lastJoinInvitationSent(false),
+      _waitingForJoinResponse(false),
+      _joinResponseStartTime(0),
       _joinResponseReceived(false),
-      _lastInvitedNodeID(0)
+      _lastInvitedNodeID(0),
+      _joinResponseWaitStart(0),
+      _lastNodeTimeoutCheck(0)
 {
-    // Initialize known nodes array
-    for (int i = 0; i < ModBeeAPI::MODBEE_MAX_NODES; i++) {
-        _knownNodes[i] = 0;
-    }
-    
     // Initialize last node seen array
     for (int i = 0; i < 256; i++) {
         _lastNodeSeen[i] = 0;
+        _idleSkips[i] = 0;
+        _idleStreak[i] = 0;
     }
 }
 
@@ -66,16 +86,16 @@ void ModBeeProtocol::reportError(ModBeeError error, const char* msg) {
 // =============================================================================
 // INITIALIZATION
 // =============================================================================
-void ModBeeProtocol::begin(uint8_t nodeID, Stream* serialPort) {
+void ModBeeProtocol::begin(uint8_t nodeID, ModBeeTransport* transport) {
     _nodeID = nodeID;
 
     // Add ourselves to known nodes
-    _knownNodes[0] = _nodeID;
-    _knownNodeCount = 1;
+    _knownNodes.clear();
+    _knownNodes.insert(_nodeID);
     _lastNodeSeen[_nodeID] = millis();
     
     // Properly initialize timing variables
-    unsigned long now = millis();
+    uint32_t now = millis();
     _lastNodeSeen[_nodeID] = now;
     _lastTokenSeen = now;         
     _lastTimeAsMaster = now;
@@ -85,7 +105,7 @@ void ModBeeProtocol::begin(uint8_t nodeID, Stream* serialPort) {
         _io = new ModBeeIO(*this);
     }
     
-    if (!_io->begin(serialPort)) {
+    if (!_io->begin(transport)) {
         reportError(MBEE_UNKNOWN_ERROR, "Failed to initialize IO");
         return;
     }
@@ -93,6 +113,7 @@ void ModBeeProtocol::begin(uint8_t nodeID, Stream* serialPort) {
     // Clear all pending operations
     _operations.clearPendingOperations();
     _operations.clearPendingResponses();
+    _networkTime.reset();
     
     reportError(MBEE_STATE_CHANGE, "Protocol started");
 }
@@ -105,13 +126,13 @@ unsigned long ModBeeProtocol::getNetworkBuildTimeout() {
 }
 
 unsigned long ModBeeProtocol::getJoinWaitTimeout() {
-    return ModBeeAPI::MODBEE_MAX_NODES * (ModBeeAPI::MODBEE_INTERFRAME_GAP_US / 1000) * 1.5;
+    return ModBeeAPI::MODBEE_MAX_NODES * ((_io->getInterFrameGapUs() + 999) / 1000) * 1.5;
 }
 
 unsigned long ModBeeProtocol::getRandomInitialListen() {
     if (!_initialListenTimeSet) {
         unsigned long baseTime = ModBeeAPI::INITIAL_LISTEN_PERIOD_MS;
-        unsigned long nodeOffset = (_nodeID % 10) * 100; // 100ms separation between nodes
+        unsigned long nodeOffset = (_nodeID - 1) * MODBEE_LISTEN_STEP_MS; // Lowest ID claims the bus first
         _randomInitialListenTime = baseTime + nodeOffset;
         _initialListenTimeSet = true;
     }
@@ -126,21 +147,27 @@ void ModBeeProtocol::loop() {
         return;
     }
     
-    static unsigned long lastNodeTimeoutCheck = 0;
-    unsigned long now = millis();
+    uint32_t now = millis();
     
     // Always process incoming data first - CRITICAL for activity detection
     _io->processIncoming();
     
-    // Process pending operations
-    _operations.processPendingOperations(*this);
+    // Scheduled writes go in as soon as the network time reaches them
+    _networkTime.setReference(isTimeMaster());
+    _networkTime.holdOver(micros());
+    _networkTime.applyDueWrites(_dataMap);
+    
+    // Retry or drop operations and responses that timed out
     _operations.cleanupTimedOutOperations(*this);
     
+    // Completion callbacks run here, outside the queue walks, so they may queue more
+    _operations.dispatchCompletions();
+    
     // Only check timeouts for connected states, not during join process
     if (_state == MBEE_IDLE || _state == MBEE_HAVE_TOKEN || _state == MBEE_PASSING_TOKEN) {
-        if (now - lastNodeTimeoutCheck >= (ModBeeAPI::NODE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES) {
+        if (now - _lastNodeTimeoutCheck >= getAdaptiveTimeout((ModBeeAPI::NODE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES, MODBEE_NODE_TIMEOUT_ROTATIONS)) {
             checkNodeTimeouts();
-            lastNodeTimeoutCheck = now;
+            _lastNodeTimeoutCheck = now;
         }
     }
     
@@ -157,7 +184,7 @@ void ModBeeProtocol::loop() {
                 
                 // Calculate listen time: base time + node offset
                 unsigned long listenTime = getRandomInitialListen();
-                unsigned long elapsed = now - _stateEntryTime;
+                uint32_t elapsed = now - _stateEntryTime;
                 
                 if (elapsed >= listenTime) {
                     // Timeout reached - become coordinator
@@ -187,6 +214,16 @@ void ModBeeProtocol::loop() {
                     break;
                 }
                 
+                // Join windows: whole ID ranges answer at once in contention slots
+                if (useJoinWindows()) {
+                    if (processSlottedBuild()) {
+                        MBEE_DEBUG_PROTOCOL("COORDINATOR: Join windows complete, starting token ring");
+                        completeNetworkBuilding();
+                        transitionToState(MBEE_HAVE_TOKEN);
+                    }
+                    break;
+                }
+                
                 // Send join invitations every
                 if (shouldSendJoinInvitation()) {
                     uint8_t nextNode = getNextJoinInvitation();
@@ -233,10 +270,18 @@ void ModBeeProtocol::loop() {
             
         case MBEE_CONNECTING:
             {
-                // Send connection response immediately using the correct frame function
+                // A join window answer waits for our slot, an invitation is answered immediately
+                if (_joinSlotPending && (int32_t)(micros() - _joinSlotDueUs) < 0) {
+                    break;
+                }
+                
                 bool sent = _io->sendJoinResponseFrame(_nodeID);
                 if (sent) {
                     MBEE_DEBUG_PROTOCOL("STATE: CONNECTING -> IDLE (join response sent)");
+                    if (_joinSlotPending) {
+                        _joinSlotPending = false;
+                        _awaitingFirstToken = true;
+                    }
                     resetJoiningState();
                     transitionToState(MBEE_IDLE);
                 } else {
@@ -261,7 +306,7 @@ void ModBeeProtocol::loop() {
         case MBEE_IDLE:
             {   
                 // If we've become the only node, restart network building
-                if (_knownNodeCount <= 1) {
+                if (_knownNodes.count() <= 1) {
                     MBEE_DEBUG_PROTOCOL("IDLE: Network lost, returning to MBEE_WAITING_FOR_JOIN_INVITATION");
                     transitionToState(MBEE_WAITING_FOR_JOIN_INVITATION);
                 }
@@ -286,7 +331,7 @@ void ModBeeProtocol::loop() {
                 
                 // If waiting for join response, check timeout
                 if (_waitingForJoinResponse) {
-                    unsigned long joinResponseWaitTime = now - _joinResponseStartTime;
+                    uint32_t joinResponseWaitTime = now - _joinResponseStartTime;
                     if (joinResponseWaitTime >= ModBeeAPI::MODBEE_JOIN_RESPONSE_TIMEOUT) {
                         MBEE_DEBUG_PROTOCOL("IDLE: Join response timeout (%lu ms), proceeding with token", joinResponseWaitTime);
                         _waitingForJoinResponse = false;
@@ -308,17 +353,21 @@ void ModBeeProtocol::loop() {
                     break;
                 }
                 
-                // Token reclaim timeout - only lowest node can reclaim
-                unsigned long timeSinceEnteringIdle = now - _stateEntryTime;
-                if (timeSinceEnteringIdle > (ModBeeAPI::MODBEE_TOKEN_RECLAIM_TIMEOUT + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES) {
-                    if (isLowestNodeID()) {
-                        MBEE_DEBUG_PROTOCOL("TOKEN: Reclaimed as lowest node (idle timeout:%lu ms)", timeSinceEnteringIdle);
-                        transitionToState(MBEE_HAVE_TOKEN);
-                    } else {
-                        MBEE_DEBUG_PROTOCOL("TOKEN: Reclaim failed, not lowest node returning to MBEE_WAITING_FOR_JOIN_INVITATION");
-                        transitionToState(MBEE_WAITING_FOR_JOIN_INVITATION);
-                        _stateEntryTime = now; // Reset timer
-                    }
+                // Token lost: the bus stayed silent past our turn in the reclaim order.
+                // The first reclaimer's frame resets everyone else's silence. Should the
+                // next in order fire before hearing it, the rank in the step keeps the two
+                // sequences apart, so the newer token wins and the other is dropped
+                int32_t silenceUs = _io->getBusIdleUs(micros());
+                if (silenceUs > (int32_t)getReclaimSilenceUs()) {
+                    uint8_t step = 1 + getReclaimRank() % (MODBEE_TOKEN_SEQ_MAX / 2);
+                    _tokenSequence = (_tokenSequence + step - 1) % MODBEE_TOKEN_SEQ_MAX + 1;
+                    _sequenceAnnounced = false;
+                    _idleNodes.clear();         // Whoever lost the token may be why: visit everyone again
+                    _tokenStats.reclaims++;
+                    MBEE_DEBUG_PROTOCOL("TOKEN: Reclaimed after %ld us of silence (rank %d, sequence %d)",
+                        (long)silenceUs, getReclaimRank(), _tokenSequence);
+                    reportError(MBEE_TOKEN_RECLAIM, "Token reclaimed");
+                    transitionToState(MBEE_HAVE_TOKEN);
                     break;
                 }
             }
@@ -329,6 +378,8 @@ void ModBeeProtocol::loop() {
                 // Handle pending responses and requests
                 bool hasPendingResponses = (_operations.getPendingResponseCount() > 0);
                 bool hasPendingOps = (_operations.getPendingOpCount() > 0);
+                bool hasPublications = _cyclicData.hasPublications();  // Never idle: they go out every turn
+                bool timeSyncDue = isTimeMaster() && _networkTime.isBroadcastDue();
                 
                 bool tokenSent = false;
                 uint8_t nextNodeID = getNextNodeID();
@@ -339,12 +390,18 @@ void ModBeeProtocol::loop() {
                 }
                 
                 // Send appropriate frame type
-                if (hasPendingResponses || hasPendingOps) {
+                bool shortToken = false;
+                if (hasPendingResponses || hasPendingOps || hasPublications || timeSyncDue) {
+                    uint32_t budgetUs = getTokenHoldBudgetUs();
                     if (joinInviteNodeID > 0) {
-                        tokenSent = _io->sendDataFrame(nextNodeID, joinInviteNodeID, MODBEE_JOIN_TOKEN);
+                        tokenSent = _io->sendDataFrame(nextNodeID, joinInviteNodeID, MODBEE_JOIN_TOKEN, budgetUs);
                     } else {
-                        tokenSent = _io->sendDataFrame(nextNodeID, 0, 0);
+                        tokenSent = _io->sendDataFrame(nextNodeID, 0, 0, budgetUs);
                     }
+                } else if (joinInviteNodeID == 0 && _tokenRetryCount == 0 && _sequenceAnnounced && isShortTokenActive()) {
+                    // Nothing to send: 5 bytes. Retries go out in full in case the receiver lost the sequence
+                    tokenSent = _io->sendShortTokenFrame(nextNodeID);
+                    shortToken = true;
                 } else {
                     if (joinInviteNodeID > 0) {
                         tokenSent = _io->sendTokenFrame(_nodeID, nextNodeID, joinInviteNodeID, MODBEE_JOIN_TOKEN);
@@ -355,6 +412,15 @@ void ModBeeProtocol::loop() {
                 
                 if (tokenSent) {
                     _tokenRetryNode = nextNodeID;
+                    _lastTokenTo = nextNodeID;
+                    _lastTokenInvitation = (joinInviteNodeID > 0);
+                    if (shortToken) {
+                        _tokenStats.shortTokens++;
+                    } else {
+                        _sequenceAnnounced = true;
+                    }
+                    countIdleSkips(_nodeID, nextNodeID);
+                    recordTokenHold();
                     
                     if (joinInviteNodeID > 0) {
                         incrementJoinCycle();
@@ -369,7 +435,7 @@ void ModBeeProtocol::loop() {
             {
 
                 // If we've become the only node, restart network building
-                if (_knownNodeCount <= 1) {
+                if (_knownNodes.count() <= 1) {
                     MBEE_DEBUG_PROTOCOL("PASSING_TOKEN: Network lost, returning to MBEE_WAITING_FOR_JOIN_INVITATION");
                     transitionToState(MBEE_WAITING_FOR_JOIN_INVITATION);
                     break;
@@ -383,8 +449,8 @@ void ModBeeProtocol::loop() {
                     break;
                 }
                 
-                // Token passing timeout
-                if (now - _stateEntryTime > ModBeeAPI::TOKEN_RESPONSE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT + (ModBeeAPI::MODBEE_INTERFRAME_GAP_US / 1000)) {
+                // Token passing timeout: the successor has stayed silent since our pass
+                if (_io->getBusIdleUs(micros()) > (int32_t)getTokenPassTimeoutUs()) {
                     _tokenRetryCount++;
                     
                     if (_tokenRetryCount < ModBeeAPI::MODBEE_MAX_RETRIES) {
@@ -408,8 +474,11 @@ void ModBeeProtocol::loop() {
                             if (tokenSent) {
                                 MBEE_DEBUG_PROTOCOL("TOKEN: Removed Node %d, passed to new Node %d. Waiting for confirmation.", removedNode, nextNodeID);
                                 _tokenRetryNode = nextNodeID; // Update who we are waiting for
+                                _lastTokenTo = nextNodeID;
+                                _lastTokenInvitation = false;
+                                _sequenceAnnounced = true;
+                                countIdleSkips(_nodeID, nextNodeID);
                                 _tokenRetryCount = 0;
-                                _stateEntryTime = millis();   // Reset timeout for the new pass
                                 // Stay in MBEE_PASSING_TOKEN to wait for confirmation
                             } 
                             else {
@@ -439,6 +508,23 @@ void ModBeeProtocol::transitionToState(ModBeeProtocolState newState) {
         _state = newState;
         _stateEntryTime = millis();
         
+        // A hold spans HAVE_TOKEN and the PASSING_TOKEN retries back into it
+        if (newState != MBEE_HAVE_TOKEN && newState != MBEE_PASSING_TOKEN) {
+            _tokenHeld = false;
+        }
+        if (newState != MBEE_IDLE && newState != MBEE_HAVE_TOKEN && newState != MBEE_PASSING_TOKEN) {
+            _tokenRotationValid = false;
+            _rotationEstimateValid = false;
+        }
+        
+        // A join window answer is only pending in CONNECTING and only repeated until the ring runs
+        if (newState != MBEE_CONNECTING) {
+            _joinSlotPending = false;
+        }
+        if (newState != MBEE_CONNECTING && newState != MBEE_IDLE) {
+            _awaitingFirstToken = false;
+        }
+        
         MBEE_DEBUG_PROTOCOL("STATE CHANGE: %s -> %s", 
             getStateName(oldState), getStateName(newState));
         
@@ -466,6 +552,9 @@ void ModBeeProtocol::transitionToState(ModBeeProtocolState newState) {
                 if (!_isCoordinator) {
                     _isCoordinator = isLowestNodeID();
                 }
+                if (!_tokenHeld) {
+                    startTokenHold();
+                }
                 break;
                 
             default:
@@ -480,6 +569,15 @@ void ModBeeProtocol::startNetworkBuilding() {
     _buildingNetwork = true;
     _networkBuildStart = millis();
     _currentJoinNodeID = 1; 
+    
+    // Joining nodes take the ring's token sequence from our frames
+    if (_tokenSequence == 0) {
+        _tokenSequence = 1;
+    }
+    
+    if (useJoinWindows()) {
+        pushJoinRange(1, ModBeeAPI::MODBEE_MAX_NODES, ModBeeAPI::MODBEE_JOIN_SLOTS);
+    }
 
     MBEE_DEBUG_PROTOCOL("COORDINATOR: Starting network building from Node 1 to %d", ModBeeAPI::MODBEE_MAX_NODES);
 }
@@ -488,7 +586,7 @@ void ModBeeProtocol::completeNetworkBuilding() {
     _buildingNetwork = false;
     _isCoordinator = true; // Remain coordinator for ongoing join management
     
-    MBEE_DEBUG_PROTOCOL("COORDINATOR: Network building complete, %d nodes in network", _knownNodeCount);
+    MBEE_DEBUG_PROTOCOL("COORDINATOR: Network building complete, %d nodes in network", _knownNodes.count());
 }
 
 void ModBeeProtocol::resetCoordinatorState() {
@@ -502,10 +600,102 @@ void ModBeeProtocol::resetCoordinatorState() {
     _lastJoinManagement = 0;
     _lastInvitedNodeID = 0;
     _joinResponseReceived = false;
+    _joinRangeCount = 0;
+    _joinWindowOpen = false;
+    _joinWindowHeard = 0;
+    if (_io) {
+        _io->endJoinWindowMonitor();
+    }
     
     MBEE_DEBUG_PROTOCOL("COORDINATOR: State reset, _currentJoinNodeID = %d", _currentJoinNodeID);
 }
 
+// =============================================================================
+// SLOTTED JOIN WINDOWS
+// =============================================================================
+bool ModBeeProtocol::useJoinWindows() const {
+    // Slot timing needs the line speed
+    return ModBeeAPI::MODBEE_JOIN_SLOTS > 0 && _io && _io->getBaudRate() != 0;
+}
+
+uint32_t ModBeeProtocol::getJoinSlotUs() const {
+    // One join response plus an inter-frame gap on either side, in wire units
+    uint32_t slotUs = _io->getAirTimeUs(MODBEE_JOIN_RESPONSE_WIRE_BYTES) + 2 * _io->getInterFrameGapUs();
+    return (slotUs + MODBEE_JOIN_SLOT_UNIT_US - 1) / MODBEE_JOIN_SLOT_UNIT_US * MODBEE_JOIN_SLOT_UNIT_US;
+}
+
+void ModBeeProtocol::pushJoinRange(uint8_t first, uint8_t last, uint8_t slots) {
+    if (first > last || (first == last && first == _nodeID)) {
+        return;
+    }
+    if (_joinRangeCount >= MODBEE_JOIN_RANGE_STACK) {
+        // Nodes left out join through the per-token invitations later
+        MBEE_DEBUG_PROTOCOL("JOIN WINDOW: Range stack full, dropping Nodes %d-%d", first, last);
+        return;
+    }
+    
+    JoinRange& range = _joinRanges[_joinRangeCount++];
+    range.first = first;
+    range.last = last;
+    range.slots = std::min(std::min(slots, (uint8_t)MODBEE_MAX_JOIN_SLOTS), (uint8_t)(last - first + 1));
+}
+
+bool ModBeeProtocol::processSlottedBuild() {
+    if (_joinWindowOpen) {
+        if ((int32_t)(micros() - _joinWindowEndUs) < 0) {
+            return false;
+        }
+        closeJoinWindow();
+    }
+    
+    if (_joinRangeCount == 0) {
+        return true;
+    }
+    
+    // Next range from the top of the stack; stays there until the window went out
+    const JoinRange& range = _joinRanges[_joinRangeCount - 1];
+    uint32_t slotUs = getJoinSlotUs();
+    if (!_io->sendJoinWindowFrame(_nodeID, range.first, range.last, range.slots, slotUs)) {
+        return false;
+    }
+    
+    _joinWindow = range;
+    _joinRangeCount--;
+    _joinWindowOpen = true;
+    _joinWindowHeard = 0;
+    _lastJoinInvitation = millis();
+    
+    // Slots count from the end of the window frame on the wire
+    uint32_t startUs = _io->getLastTxEndUs();
+    _joinWindowEndUs = startUs + _joinWindow.slots * slotUs + _io->getInterFrameGapUs();
+    _io->beginJoinWindowMonitor(startUs, slotUs, _joinWindow.slots);
+    
+    MBEE_DEBUG_PROTOCOL("JOIN WINDOW: Nodes %d-%d, %d slots of %lu us", _joinWindow.first, _joinWindow.last, _joinWindow.slots, (unsigned long)slotUs);
+    return false;
+}
+
+void ModBeeProtocol::closeJoinWindow() {
+    _joinWindowOpen = false;
+    
+    // Traffic nobody could be heard in, or a corrupted frame: several nodes answered
+    uint32_t collided = (_io->getJoinWindowActivity() & ~_joinWindowHeard) | _io->getJoinWindowErrors();
+    _io->endJoinWindowMonitor();
+    
+    // Split each collided slot's IDs in two; pushed high to low so the lowest IDs go next.
+    // A single ID that still collides is noise, the per-token invitations pick it up later
+    for (int8_t slot = _joinWindow.slots - 1; slot >= 0; slot--) {
+        if (!(collided & (1UL << slot))) {
+            continue;
+        }
+        uint8_t first, last;
+        ModBeeFrame::getJoinSlotRange(slot, _joinWindow.first, _joinWindow.last, _joinWindow.slots, first, last);
+        if (first < last) {
+            MBEE_DEBUG_PROTOCOL("JOIN WINDOW: Collision in slot %d, splitting Nodes %d-%d", slot, first, last);
+            pushJoinRange(first, last, 2);
+        }
+    }
+}
+
 void ModBeeProtocol::resetJoiningState() {
     _waitingForInvitation = true;
     _joinWaitStart = millis();
@@ -532,17 +722,8 @@ uint8_t ModBeeProtocol::getNextJoinInvitation() {
             continue; // Try next node
         }
         
-        // Check if this node is already known
-        bool isKnown = false;
-        for (uint8_t i = 0; i < _knownNodeCount; i++) {
-            if (_knownNodes[i] == _currentJoinNodeID) {
-                isKnown = true;
-                break;
-            }
-        }
-        
         // If node is unknown, invite it
-        if (!isKnown) {
+        if (!_knownNodes.contains(_currentJoinNodeID)) {
             //MBEE_DEBUG_PROTOCOL("JOIN: Next invitation for unknown Node %d", _currentJoinNodeID);
             return _currentJoinNodeID;
         }
@@ -578,17 +759,17 @@ void ModBeeProtocol::incrementJoinCycle() {
 }
 
 bool ModBeeProtocol::shouldSendJoinInvitation() {
-    unsigned long now = millis();
+    uint32_t now = millis();
     return (now - _lastJoinInvitation >= ModBeeAPI::MODBEE_JOIN_CYCLE_INTERVAL);
 }
 
 bool ModBeeProtocol::hasNetworkBuildTimedOut() {
-    unsigned long elapsed = millis() - _networkBuildStart;
+    uint32_t elapsed = millis() - _networkBuildStart;
     return elapsed >= getNetworkBuildTimeout();
 }
 
 bool ModBeeProtocol::hasJoinWaitTimedOut() {
-    unsigned long elapsed = millis() - _joinWaitStart;
+    uint32_t elapsed = millis() - _joinWaitStart;
     return elapsed >= getJoinWaitTimeout();
 }
 
@@ -605,7 +786,9 @@ bool ModBeeProtocol::isCoordinator() const {
 // =============================================================================
 void ModBeeProtocol::handleJoinInvitation(uint8_t invitedNodeID, uint8_t fromNodeID) {
     if (isJoinInvitationForUs(invitedNodeID)) {
-        if (_state == MBEE_WAITING_FOR_JOIN_INVITATION || _state == MBEE_INITIAL_LISTEN) {
+        // A join window answer that got lost in a collision is retried on invitation
+        if (_state == MBEE_WAITING_FOR_JOIN_INVITATION || _state == MBEE_INITIAL_LISTEN ||
+            (_state == MBEE_IDLE && _awaitingFirstToken)) {
             MBEE_DEBUG_PROTOCOL("JOIN INVITATION: Accepted invitation for Node %d from Node %d", invitedNodeID, fromNodeID);
             _invitationReceived = true;
             _invitationFromNode = fromNodeID;
@@ -633,6 +816,41 @@ void ModBeeProtocol::handleJoinResponse(uint8_t joiningNodeID, uint8_t fromNodeI
     // Add the node that actually responded
     handleNodeAdd(joiningNodeID, fromNodeID);
     _joinResponseReceived = true;
+    
+    // Its slot in the open join window was not a collision
+    if (_joinWindowOpen && joiningNodeID >= _joinWindow.first && joiningNodeID <= _joinWindow.last) {
+        _joinWindowHeard |= 1UL << ModBeeFrame::getJoinSlot(joiningNodeID, _joinWindow.first, _joinWindow.last, _joinWindow.slots);
+    }
+}
+
+void ModBeeProtocol::handleJoinWindow(uint8_t fromNodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint32_t slotUs) {
+    if (_nodeID < firstNodeID || _nodeID > lastNodeID) {
+        return;
+    }
+    
+    // Nodes still joining answer; a lower coordinator wins over our own build
+    bool ready = _state == MBEE_INITIAL_LISTEN || _state == MBEE_WAITING_FOR_JOIN_INVITATION ||
+                 _state == MBEE_CONNECTING || (_state == MBEE_IDLE && _awaitingFirstToken);
+    if (_state == MBEE_COORDINATOR_BUILDING && fromNodeID < _nodeID) {
+        MBEE_DEBUG_PROTOCOL("JOIN WINDOW: Node %d is building too, yielding", fromNodeID);
+        resetCoordinatorState();
+        resetJoiningState();
+        ready = true;
+    }
+    if (!ready) {
+        return;
+    }
+    
+    // Answer centred in our slot, counted from the end of the window frame
+    uint8_t slot = ModBeeFrame::getJoinSlot(_nodeID, firstNodeID, lastNodeID, slots);
+    uint32_t airUs = _io->getAirTimeUs(MODBEE_JOIN_RESPONSE_WIRE_BYTES);
+    uint32_t offsetUs = slotUs > airUs ? (slotUs - airUs) / 2 : 0;
+    _joinSlotDueUs = _io->getLastRxActivityUs() + slot * slotUs + offsetUs;
+    _invitationFromNode = fromNodeID;
+    
+    MBEE_DEBUG_PROTOCOL("JOIN WINDOW: Nodes %d-%d from Node %d, answering in slot %d", firstNodeID, lastNodeID, fromNodeID, slot);
+    transitionToState(MBEE_CONNECTING);
+    _joinSlotPending = true;
 }
 
 // =============================================================================
@@ -674,12 +892,24 @@ bool ModBeeProtocol::isConnected() const {
 }
 
 bool ModBeeProtocol::isNodeKnown(uint8_t nodeID) const {
-    for (uint8_t i = 0; i < _knownNodeCount; i++) {
-        if (_knownNodes[i] == nodeID) {
-            return true;
-        }
+    return _knownNodes.contains(nodeID);
+}
+
+// =============================================================================
+// MULTICAST GROUPS
+// =============================================================================
+void ModBeeProtocol::joinGroup(uint8_t group) {
+    if (group != MODBEE_GROUP_ALL) {
+        _groups.insert(group);
     }
-    return false;
+}
+
+void ModBeeProtocol::leaveGroup(uint8_t group) {
+    _groups.erase(group);
+}
+
+bool ModBeeProtocol::isGroupMember(uint8_t group) const {
+    return group == MODBEE_GROUP_ALL || _groups.contains(group);
 }
 
 // =============================================================================
@@ -690,30 +920,182 @@ void ModBeeProtocol::updateNodeSeen(uint8_t nodeID) {
         return; // Invalid or self
     }
     
-    unsigned long now = millis();
+    uint32_t now = millis();
     _lastNodeSeen[nodeID] = now;
     
     // Add new node to known nodes list
-    bool found = false;
-    for (int i = 0; i < _knownNodeCount; i++) {
-        if (_knownNodes[i] == nodeID) {
-            found = true;
-            break;
+    if (!_knownNodes.contains(nodeID) && _knownNodes.count() < ModBeeAPI::MODBEE_MAX_NODES) {
+        _knownNodes.insert(nodeID);
+        
+        MBEE_DEBUG_PROTOCOL("NODE ADDED: Node %d added to network (%d total nodes)", nodeID, _knownNodes.count());
+    }
+}
+
+void ModBeeProtocol::updateNodeStuffing(uint8_t nodeID, bool stuffed) {
+    if (nodeID == 0 || nodeID == _nodeID) {
+        return; // Invalid or self
+    }
+    
+    if (_plainFrameNodes.contains(nodeID) == stuffed) {
+        if (stuffed) {
+            _plainFrameNodes.erase(nodeID);
+        } else {
+            _plainFrameNodes.insert(nodeID);
         }
+        MBEE_DEBUG_PROTOCOL("STUFFING: Node %d sends %s frames", nodeID, stuffed ? "stuffed" : "plain");
+    }
+}
+
+bool ModBeeProtocol::isByteStuffingActive() const {
+    if (!ModBeeAPI::MODBEE_BYTE_STUFFING || ModBeeAPI::MODBEE_FRAME_VERSION < MODBEE_FRAME_VERSION_2) {
+        return false;
     }
     
-    if (!found && _knownNodeCount < ModBeeAPI::MODBEE_MAX_NODES) {
-        _knownNodes[_knownNodeCount] = nodeID;
-        _knownNodeCount++;
-        
-        MBEE_DEBUG_PROTOCOL("NODE ADDED: Node %d added to network (%d total nodes)", nodeID, _knownNodeCount);
+    // Ring-wide: stuff only while every known node does too
+    return !_plainFrameNodes.intersects(_knownNodes);
+}
+
+void ModBeeProtocol::updateNodeSectionFormat(uint8_t nodeID, bool compact) {
+    if (nodeID == 0 || nodeID == _nodeID) {
+        return; // Invalid or self
+    }
+    
+    if (_delimitedFrameNodes.contains(nodeID) == compact) {
+        if (compact) {
+            _delimitedFrameNodes.erase(nodeID);
+        } else {
+            _delimitedFrameNodes.insert(nodeID);
+        }
+        MBEE_DEBUG_PROTOCOL("SECTIONS: Node %d sends %s sections", nodeID, compact ? "compact" : "delimited");
+    }
+}
+
+bool ModBeeProtocol::isCompactSectionsActive() const {
+    if (!ModBeeAPI::MODBEE_COMPACT_SECTIONS || ModBeeAPI::MODBEE_FRAME_VERSION < MODBEE_FRAME_VERSION_2) {
+        return false;
     }
+    
+    // Ring-wide, like byte stuffing: only while every known node sends compact frames
+    return !_delimitedFrameNodes.intersects(_knownNodes);
+}
+
+void ModBeeProtocol::updateNodeTokenSequence(uint8_t nodeID, uint8_t sequence) {
+    if (nodeID == 0 || nodeID == _nodeID) {
+        return; // Invalid or self
+    }
+    
+    if (_unsequencedNodes.contains(nodeID) == (sequence != 0)) {
+        if (sequence != 0) {
+            _unsequencedNodes.erase(nodeID);
+        } else {
+            _unsequencedNodes.insert(nodeID);
+        }
+        MBEE_DEBUG_PROTOCOL("SEQUENCE: Node %d sends %s frames", nodeID, sequence != 0 ? "sequenced" : "unsequenced");
+    }
+    
+    if (sequence == 0 || (_tokenSequence != 0 && !isNewerTokenSequence(sequence, _tokenSequence))) {
+        return;
+    }
+    
+    // Someone reclaimed the token: a token we still hold or retry is a duplicate
+    bool stale = _tokenSequence != 0 && (_state == MBEE_HAVE_TOKEN || _state == MBEE_PASSING_TOKEN);
+    _tokenSequence = sequence;
+    if (stale) {
+        MBEE_DEBUG_PROTOCOL("SEQUENCE: Node %d reclaimed the token (sequence %d), dropping ours", nodeID, sequence);
+        _tokenStats.staleTokens++;
+        _tokenRetryCount = 0;
+        transitionToState(MBEE_IDLE);
+    }
+}
+
+bool ModBeeProtocol::isTokenSequenceActive() const {
+    if (!ModBeeAPI::MODBEE_TOKEN_SEQUENCE || ModBeeAPI::MODBEE_FRAME_VERSION < MODBEE_FRAME_VERSION_2) {
+        return false;
+    }
+    
+    // Ring-wide, like byte stuffing: older firmware reads a sequenced LEN as oversized
+    return !_unsequencedNodes.intersects(_knownNodes);
+}
+
+uint8_t ModBeeProtocol::getTokenSequence() const {
+    return isTokenSequenceActive() ? _tokenSequence : 0;
+}
+
+bool ModBeeProtocol::checkTokenSequence(uint8_t sequence) {
+    // Unsequenced passes are always taken; sequenced ones only from the current token
+    if (sequence == 0 || _tokenSequence == 0 || !isNewerTokenSequence(_tokenSequence, sequence)) {
+        return true;
+    }
+    
+    _tokenStats.staleTokens++;
+    return false;
+}
+
+bool ModBeeProtocol::isShortTokenActive() const {
+    // Firmware without short tokens cannot parse them: configured per ring, like compact sections
+    return ModBeeAPI::MODBEE_SHORT_TOKENS && ModBeeAPI::MODBEE_FRAME_VERSION >= MODBEE_FRAME_VERSION_2;
+}
+
+void ModBeeProtocol::updateNodeWork(uint8_t nodeID, bool pending) {
+    if (nodeID == 0 || nodeID == _nodeID) {
+        return; // Invalid or self
+    }
+    
+    // A short token means the sender had nothing queued; a full frame or a section addressed to it may change that
+    if (pending) {
+        _idleNodes.erase(nodeID);
+        _idleStreak[nodeID] = 0;
+    } else if (getIdleSkipLimit() > 0 && _knownNodes.contains(nodeID)) {
+        if (_idleStreak[nodeID] <= MODBEE_MAX_IDLE_SKIP_ROTATIONS) {
+            _idleStreak[nodeID]++;
+        }
+        if (_idleStreak[nodeID] > 1) {
+            _idleNodes.insert(nodeID);
+            _idleSkips[nodeID] = 0;
+        }
+    }
+}
+
+uint8_t ModBeeProtocol::getIdleSkipLimit() const {
+    if (!isShortTokenActive()) {
+        return 0; // Only a short token tells us a node is idle
+    }
+    return std::min(ModBeeAPI::MODBEE_IDLE_SKIP_ROTATIONS, (uint8_t)MODBEE_MAX_IDLE_SKIP_ROTATIONS);
+}
+
+void ModBeeProtocol::countIdleSkips(uint8_t fromNodeID, uint8_t toNodeID) {
+    if (_idleNodes.empty() || !_knownNodes.contains(fromNodeID)) {
+        return;
+    }
+    
+    // Every node hears the same passes, so every node counts the same skips
+    uint8_t limit = getIdleSkipLimit();
+    for (uint8_t nodeID = _knownNodes.successor(fromNodeID); nodeID != toNodeID && nodeID != fromNodeID;
+         nodeID = _knownNodes.successor(nodeID)) {
+        if (_idleNodes.contains(nodeID)) {
+            if (fromNodeID == _nodeID) {
+                _tokenStats.idleSkips++;
+            }
+            if (++_idleSkips[nodeID] >= std::min((uint8_t)(_idleStreak[nodeID] - 1), limit)) {
+                _idleNodes.erase(nodeID); // Its turn comes up on the next pass
+            }
+        }
+    }
+}
+
+bool ModBeeProtocol::isNewerTokenSequence(uint8_t sequence, uint8_t reference) {
+    // Serial number arithmetic (RFC 1982) over 1..MODBEE_TOKEN_SEQ_MAX
+    uint8_t ahead = (sequence + MODBEE_TOKEN_SEQ_MAX - reference) % MODBEE_TOKEN_SEQ_MAX;
+    return ahead != 0 && ahead <= MODBEE_TOKEN_SEQ_MAX / 2;
 }
 
 // =============================================================================
 // TOKEN HANDLING
 // =============================================================================
-void ModBeeProtocol::handleTokenReceived(uint8_t fromNodeID) {
+void ModBeeProtocol::handleTokenReceived(uint8_t fromNodeID, uint8_t toNodeID, bool joinInvitation) {
+    countIdleSkips(fromNodeID, toNodeID);
+    _lastTokenTo = toNodeID;
+    _lastTokenInvitation = joinInvitation;
     
     // Set appropriate event flags based on current state
     if (_state == MBEE_PASSING_TOKEN){ // && fromNodeID == _tokenRetryNode) {
@@ -726,6 +1108,150 @@ void ModBeeProtocol::handleTokenReceived(uint8_t fromNodeID) {
     MBEE_DEBUG_PROTOCOL("TOKEN: Received from Node %d (state: %s)", fromNodeID, getStateName(_state));
 }
 
+// =============================================================================
+// TIMED TOKEN (TTRT)
+// =============================================================================
+void ModBeeProtocol::startTokenHold() {
+    uint32_t now = micros();
+    
+    if (_tokenRotationValid) {
+        _tokenRotationUs = now - _tokenArrivalUs;
+        _tokenStats.rotations++;
+        _tokenStats.rotationLastUs = _tokenRotationUs;
+        _tokenStats.rotationMaxUs = std::max(_tokenStats.rotationMaxUs, _tokenRotationUs);
+        _tokenStats.rotationSumUs += _tokenRotationUs;
+        if (ModBeeAPI::MODBEE_TARGET_ROTATION_US > 0 && _tokenRotationUs > ModBeeAPI::MODBEE_TARGET_ROTATION_US) {
+            _tokenStats.lateTokens++;
+        }
+        addRotationSample(_tokenRotationUs);
+    } else {
+        _tokenRotationUs = 0; // First token since joining: assume it is on time
+    }
+    
+    _tokenArrivalUs = now;
+    _tokenHeld = true;
+    _tokenHoldRecorded = false;
+    _tokenRotationValid = true;
+}
+
+void ModBeeProtocol::recordTokenHold() {
+    if (!_tokenHeld || _tokenHoldRecorded) {
+        return;
+    }
+    
+    // Until the last byte of the passing frame is on the line
+    uint32_t holdUs = _io->getLastTxEndUs() - _tokenArrivalUs;
+    _tokenStats.holds++;
+    _tokenStats.holdLastUs = holdUs;
+    _tokenStats.holdMaxUs = std::max(_tokenStats.holdMaxUs, holdUs);
+    _tokenStats.holdSumUs += holdUs;
+    _tokenHoldRecorded = true;
+}
+
+uint32_t ModBeeProtocol::getTokenHoldBudgetUs() const {
+    uint32_t targetUs = ModBeeAPI::MODBEE_TARGET_ROTATION_US;
+    if (targetUs == 0) {
+        return UINT32_MAX;
+    }
+    
+    // PROFIBUS TTH: target minus the measured rotation, minus what we already held
+    uint64_t usedUs = (uint64_t)_tokenRotationUs + (_tokenHeld ? (uint32_t)(micros() - _tokenArrivalUs) : 0);
+    return usedUs < targetUs ? (uint32_t)(targetUs - usedUs) : 0;
+}
+
+ModBeeTokenStats ModBeeProtocol::getTokenStatistics() const {
+    ModBeeTokenStats stats = _tokenStats;
+    stats.targetRotationUs = ModBeeAPI::MODBEE_TARGET_ROTATION_US;
+    stats.rotationSmoothedUs = _rotationEstimateValid ? _rotationMeanUs : 0;
+    stats.rotationDevUs = _rotationEstimateValid ? _rotationDevUs : 0;
+    return stats;
+}
+
+void ModBeeProtocol::resetTokenStatistics() {
+    _tokenStats = ModBeeTokenStats();
+}
+
+float ModBeeTokenStats::getRotationMeanUs() const {
+    return rotations ? (float)rotationSumUs / rotations : 0.0f;
+}
+
+float ModBeeTokenStats::getHoldMeanUs() const {
+    return holds ? (float)holdSumUs / holds : 0.0f;
+}
+
+// =============================================================================
+// ADAPTIVE TIMEOUTS
+// =============================================================================
+void ModBeeProtocol::addRotationSample(uint32_t rotationUs) {
+    int32_t sample = (int32_t)std::min(rotationUs, (uint32_t)INT32_MAX);
+    
+    if (!_rotationEstimateValid) {
+        _rotationMeanUs = sample;
+        _rotationDevUs = sample / 2;
+        _rotationEstimateValid = true;
+        return;
+    }
+    
+    // Mean gain 1/8, deviation gain 1/4 (TCP SRTT / RTTVAR)
+    int32_t error = sample - (int32_t)_rotationMeanUs;
+    _rotationMeanUs = (int32_t)_rotationMeanUs + error / 8;
+    _rotationDevUs = (int32_t)_rotationDevUs + ((error < 0 ? -error : error) - (int32_t)_rotationDevUs) / 4;
+}
+
+uint32_t ModBeeProtocol::getTokenPassTimeoutUs() const {
+    uint32_t gapUs = _io->getInterFrameGapUs();
+    uint32_t timeoutUs = (ModBeeAPI::TOKEN_RESPONSE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * 1000UL + gapUs;
+    
+    // Once in the ring, a live successor answers within the silences timed between frames
+    uint32_t silenceUs = _io->getSilenceLimitUs();
+    if (_rotationEstimateValid && silenceUs != 0) {
+        timeoutUs = std::min(timeoutUs, silenceUs + gapUs);
+    }
+    
+    // Whoever receives a join invitation first waits for the invited node's answer
+    if (_lastTokenInvitation) {
+        timeoutUs += ModBeeAPI::MODBEE_JOIN_RESPONSE_TIMEOUT * 1000UL;
+    }
+    return timeoutUs;
+}
+
+uint32_t ModBeeProtocol::getReclaimSilenceUs() const {
+    // One inter-frame gap per rank, plus how late the next in order may see the first
+    // reclaimer's frame start: its own RX latency on top of the one in the gap
+    uint32_t orderUs = (getReclaimRank() + 1) * (_io->getInterFrameGapUs() + _io->getRxLatencyLimitUs());
+    
+    // Until this ring has been timed, the static MODBEE_MAX_NODES-scaled bound
+    if (!_rotationEstimateValid) {
+        return (ModBeeAPI::MODBEE_TOKEN_RECLAIM_TIMEOUT + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES * 1000UL + orderUs;
+    }
+    
+    // No live holder stays silent longer than a token pass timeout before it retries
+    return getTokenPassTimeoutUs() + orderUs;
+}
+
+uint8_t ModBeeProtocol::getReclaimRank() const {
+    // Ring distance from the node the token was last passed to, which goes first
+    uint8_t origin = _knownNodes.contains(_lastTokenTo) ? _lastTokenTo : _knownNodes.first();
+    uint16_t count = _knownNodes.count();
+    if (count == 0) {
+        return 0;
+    }
+    return (_knownNodes.countBelow(_nodeID) + count - _knownNodes.countBelow(origin)) % count;
+}
+
+unsigned long ModBeeProtocol::getAdaptiveTimeout(unsigned long staticTimeoutMs, uint8_t rotations) const {
+    // The static MODBEE_MAX_NODES-scaled value until this ring has been timed, then as a cap
+    if (!_rotationEstimateValid) {
+        return staticTimeoutMs;
+    }
+    
+    // Rotations at the TCP RTO (mean + 4 deviations), plus the stall while a dead
+    // successor is retried: no sample arrives then, and nobody may time out over it
+    uint64_t rtoUs = (uint64_t)_rotationMeanUs + 4ULL * _rotationDevUs;
+    uint64_t timeoutMs = (rotations * rtoUs + ModBeeAPI::MODBEE_MAX_RETRIES * (uint64_t)getTokenPassTimeoutUs() + 999) / 1000;
+    return timeoutMs < staticTimeoutMs ? (unsigned long)timeoutMs : staticTimeoutMs;
+}
+
 // =============================================================================
 // NODE ADDITION AND REMOVAL
 // =============================================================================
@@ -745,22 +1271,11 @@ void ModBeeProtocol::handleNodeRemove(uint8_t nodeID, uint8_t fromNodeID) {
     
     updateNodeSeen(fromNodeID);
     
-    // Find the index of the node to remove first to avoid modifying the array while iterating.
-    int removeIndex = -1;
-    for (uint8_t i = 0; i < _knownNodeCount; i++) {
-        if (_knownNodes[i] == nodeID) {
-            removeIndex = i;
-            break;
-        }
-    }
-    
-    // If the node was found, remove it safely.
-    if (removeIndex != -1) {
-        // Shift remaining nodes down
-        for (uint8_t i = removeIndex; i < _knownNodeCount - 1; i++) {
-            _knownNodes[i] = _knownNodes[i + 1];
-        }
-        _knownNodeCount--;
+    if (_knownNodes.erase(nodeID)) {
+        _plainFrameNodes.erase(nodeID);
+        _delimitedFrameNodes.erase(nodeID);
+        _unsequencedNodes.erase(nodeID);
+        _idleNodes.erase(nodeID);
 
         // If failsafe is enabled, clear any registers that were last written by the lost node.
         if (ModBeeAPI::enableFailSafe) {
@@ -771,7 +1286,7 @@ void ModBeeProtocol::handleNodeRemove(uint8_t nodeID, uint8_t fromNodeID) {
         // Clear any pending operations that were targeting the lost node.
         _operations.clearNodeOperations(nodeID);
 
-        MBEE_DEBUG_PROTOCOL("NODE REMOVE: Node %d removed from network (%d remaining)", nodeID, _knownNodeCount);
+        MBEE_DEBUG_PROTOCOL("NODE REMOVE: Node %d removed from network (%d remaining)", nodeID, _knownNodes.count());
     }
 }
 
@@ -779,91 +1294,62 @@ void ModBeeProtocol::handleNodeRemove(uint8_t nodeID, uint8_t fromNodeID) {
 // NETWORK UTILITIES
 // =============================================================================
 uint8_t ModBeeProtocol::getNextNodeID() {
-    if (_knownNodeCount <= 1) {
+    if (_knownNodes.count() <= 1) {
         return _nodeID; // Only we exist, pass to ourselves
     }
     
-    // Create a sorted list of known nodes
-    uint8_t sortedNodes[ModBeeAPI::MODBEE_MAX_NODES];
-    uint8_t sortedCount = 0;
-    
-    // Copy and sort known nodes
-    for (uint8_t i = 0; i < _knownNodeCount; i++) {
-        sortedNodes[sortedCount++] = _knownNodes[i];
-    }
-    
-    // Simple bubble sort
-    for (uint8_t i = 0; i < sortedCount - 1; i++) {
-        for (uint8_t j = i + 1; j < sortedCount; j++) {
-            if (sortedNodes[i] > sortedNodes[j]) {
-                uint8_t temp = sortedNodes[i];
-                sortedNodes[i] = sortedNodes[j];
-                sortedNodes[j] = temp;
-            }
-        }
-    }
-    
-    // Find our position
-    int ourPos = -1;
-    for (uint8_t i = 0; i < sortedCount; i++) {
-        if (sortedNodes[i] == _nodeID) {
-            ourPos = i;
-            break;
+    // Next higher known node ID, wrapping around to the lowest, past nodes that have nothing to send.
+    // When every other node is idle, the plain successor
+    uint8_t successorID = _knownNodes.successor(_nodeID);
+    for (uint8_t nodeID = successorID; nodeID != _nodeID; nodeID = _knownNodes.successor(nodeID)) {
+        if (!_idleNodes.contains(nodeID)) {
+            return nodeID;
         }
     }
-    
-    if (ourPos == -1) {
-        MBEE_DEBUG_PROTOCOL("ERROR: We're not in our own known nodes list!");
-        return _nodeID;
-    }
-    
-    // Return next node in sequence (wrap around)
-    uint8_t nextPos = (ourPos + 1) % sortedCount;
-    return sortedNodes[nextPos];
+    return successorID;
 }
 
 bool ModBeeProtocol::isLowestNodeID() const {
-    if (_knownNodeCount == 0) {
-        return true;
-    }
-    
-    for (int i = 0; i < _knownNodeCount; i++) {
-        if (_knownNodes[i] < _nodeID) {
-            return false;
-        }
-    }
-    
-    return true;
+    return !_knownNodes.hasMemberBelow(_nodeID);
+}
+
+// =============================================================================
+// NETWORK TIME
+// =============================================================================
+bool ModBeeProtocol::isTimeMaster() const {
+    // The lowest ring member; a node outside the ring follows whoever sends the time
+    return isConnected() && isLowestNodeID();
+}
+
+uint8_t ModBeeProtocol::getTimeMasterID() const {
+    return _knownNodes.first();
 }
 
 // =============================================================================
 // TIMEOUT HANDLING
 // =============================================================================
 void ModBeeProtocol::checkNodeTimeouts() {
-    unsigned long now = millis();
+    uint32_t now = millis();
     
     // Only check timeouts when we're actually connected
     if (_state != MBEE_IDLE && _state != MBEE_HAVE_TOKEN && _state != MBEE_PASSING_TOKEN) {
         return;
     }
     
-    // Check for nodes that haven't been seen recently
-    for (uint8_t i = 0; i < _knownNodeCount; i++) {
-        uint8_t nodeID = _knownNodes[i];
-        
+    unsigned long nodeTimeout = getAdaptiveTimeout((ModBeeAPI::NODE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES, MODBEE_NODE_TIMEOUT_ROTATIONS);
+    
+    // Check for nodes that haven't been seen recently (removal does not disturb next())
+    for (uint8_t nodeID = _knownNodes.first(); nodeID != 0; nodeID = _knownNodes.next(nodeID)) {
         // Never timeout ourselves!
         if (nodeID == _nodeID) {
             continue; // Skip our own node completely
         }
         
-        unsigned long timeSinceLastSeen = now - _lastNodeSeen[nodeID];
+        uint32_t timeSinceLastSeen = now - _lastNodeSeen[nodeID];
         
-        if (timeSinceLastSeen > (ModBeeAPI::NODE_TIMEOUT_MS + ModBeeAPI::BASE_TIMEOUT) * ModBeeAPI::MODBEE_MAX_NODES) {
+        if (timeSinceLastSeen > nodeTimeout) {
             MBEE_DEBUG_PROTOCOL("NODE TIMEOUT: Node %d not seen for too long, removing", nodeID);
             handleNodeRemove(nodeID, _nodeID);
-            
-            // Restart the loop since the array has changed
-            i--;
         }
     }
 }
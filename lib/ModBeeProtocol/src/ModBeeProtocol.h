@@ -4,6 +4,31 @@
 // Forward declaration
 class ModBeeIO;
 
+// =============================================================================
+// STATISTICS STRUCTURE
+// =============================================================================
+struct ModBeeTokenStats {
+    uint32_t targetRotationUs = 0;      // MODBEE_TARGET_ROTATION_US when the stats were read
+    uint32_t rotations = 0;             // Token arrivals with a measured rotation
+    uint32_t rotationLastUs = 0;        // Time between our last two token arrivals
+    uint32_t rotationMaxUs = 0;
+    uint64_t rotationSumUs = 0;
+    uint32_t lateTokens = 0;            // Rotations longer than the target
+    uint32_t holds = 0;
+    uint32_t holdLastUs = 0;            // Token arrival until we passed it on
+    uint32_t holdMaxUs = 0;
+    uint64_t holdSumUs = 0;
+    uint32_t rotationSmoothedUs = 0;    // Estimator behind the adaptive timeouts, 0 until the first rotation
+    uint32_t rotationDevUs = 0;
+    uint32_t reclaims = 0;              // Tokens we regenerated after the bus fell silent
+    uint32_t staleTokens = 0;           // Token passes ignored or given up for an older sequence
+    uint32_t shortTokens = 0;           // Passes sent as a 5-byte short token
+    uint32_t idleSkips = 0;             // Idle nodes our passes went past
+    
+    float getRotationMeanUs() const;
+    float getHoldMeanUs() const;
+};
+
 /**
  * ModBeeProtocol - NEW JOIN PROTOCOL ONLY
  * Handles: coordinator-driven joining, token passing, node management
@@ -23,7 +48,7 @@ public:
     // =============================================================================
     // INITIALIZATION AND MAIN LOOP
     // =============================================================================
-    void begin(uint8_t nodeID, Stream* serialPort);
+    void begin(uint8_t nodeID, ModBeeTransport* transport);
     void loop();
     
     // =============================================================================
@@ -52,6 +77,7 @@ public:
     // =============================================================================
     void handleJoinInvitation(uint8_t invitedNodeID, uint8_t fromNodeID);
     void handleJoinResponse(uint8_t joiningNodeID, uint8_t fromNodeID);
+    void handleJoinWindow(uint8_t fromNodeID, uint8_t firstNodeID, uint8_t lastNodeID, uint8_t slots, uint32_t slotUs);
     bool isCoordinator() const;
     uint8_t getNextJoinInvitation();
     bool processJoinManagement();
@@ -60,7 +86,18 @@ public:
     // TOKEN RING METHODS
     // =============================================================================
     void updateNodeSeen(uint8_t nodeID);
-    void handleTokenReceived(uint8_t fromNodeID);
+    void updateNodeStuffing(uint8_t nodeID, bool stuffed);
+    bool isByteStuffingActive() const;
+    void updateNodeSectionFormat(uint8_t nodeID, bool compact);
+    bool isCompactSectionsActive() const;
+    void updateNodeTokenSequence(uint8_t nodeID, uint8_t sequence);
+    bool isTokenSequenceActive() const;
+    uint8_t getTokenSequence() const;
+    uint8_t getLastTokenTarget() const { return _lastTokenTo; }
+    bool checkTokenSequence(uint8_t sequence);
+    bool isShortTokenActive() const;
+    void updateNodeWork(uint8_t nodeID, bool pending);
+    void handleTokenReceived(uint8_t fromNodeID, uint8_t toNodeID, bool joinInvitation);
     void handleNodeAdd(uint8_t nodeID, uint8_t fromNodeID);
     void handleNodeRemove(uint8_t nodeID, uint8_t fromNodeID);
     uint8_t getNextNodeID();
@@ -70,11 +107,42 @@ public:
     // =============================================================================
     ModbusDataMap& getDataMap() { return _dataMap; }
     ModBeeOperations& getOperations() { return _operations; }
+    ModBeeCyclicData& getCyclicData() { return _cyclicData; }
+    ModBeeNetworkTime& getNetworkTime() { return _networkTime; }
+    ModBeeIO& getIO() { return *_io; }
+
+    // =============================================================================
+    // MULTICAST GROUPS
+    // =============================================================================
+    void joinGroup(uint8_t group);
+    void leaveGroup(uint8_t group);
+    bool isGroupMember(uint8_t group) const;
 
+    // =============================================================================
+    // NETWORK TIME
+    // =============================================================================
+    bool isTimeMaster() const;
+    uint8_t getTimeMasterID() const;
+    
     // =============================================================================
     // TOKEN CONTROL METHODS
     // =============================================================================
     void setTokenReceivedForUs() { _tokenReceivedForUs = true; }
+    
+    // =============================================================================
+    // TIMED TOKEN (TTRT)
+    // =============================================================================
+    uint32_t getTokenHoldBudgetUs() const;
+    ModBeeTokenStats getTokenStatistics() const;
+    void resetTokenStatistics();
+    uint32_t getTokenHoldCount() const { return _tokenStats.holds; }
+    
+    // =============================================================================
+    // ADAPTIVE TIMEOUTS
+    // =============================================================================
+    unsigned long getAdaptiveTimeout(unsigned long staticTimeoutMs, uint8_t rotations) const;
+    uint32_t getTokenPassTimeoutUs() const;
+    uint32_t getReclaimSilenceUs() const;
 
     // =============================================================================
     // NEW JOIN PROTOCOL TIMING CALCULATIONS
@@ -91,8 +159,7 @@ private:
     // =============================================================================
     uint8_t _nodeID;
     ModBeeProtocolState _state;
-    uint8_t _knownNodes[254];
-    uint8_t _knownNodeCount;
+    ModBeeNodeSet _knownNodes;          // Ring members including ourselves
     
     // =============================================================================
     // CALLBACKS
@@ -110,19 +177,45 @@ private:
     // =============================================================================
     ModbusDataMap _dataMap;
     ModBeeOperations _operations;
+    ModBeeCyclicData _cyclicData;       // Publications and subscriptions
+    ModBeeNodeSet _groups;              // Multicast groups joined (group IDs, not node IDs)
+    ModBeeNetworkTime _networkTime;     // Time base from the time master, scheduled writes
     
     // =============================================================================
     // TOKEN PASSING STATE
     // =============================================================================
     bool isLowestNodeID() const;
-    unsigned long _lastTokenSeen;
-    unsigned long _lastTimeAsMaster;
-    unsigned long _lastNodeSeen[256];
+    uint32_t _lastTokenSeen;
+    uint32_t _lastTimeAsMaster;
+    uint32_t _lastNodeSeen[256];
+    ModBeeNodeSet _plainFrameNodes;     // Nodes whose last frame was unstuffed
+    ModBeeNodeSet _delimitedFrameNodes; // Nodes whose last frame had no compact sections
+    ModBeeNodeSet _unsequencedNodes;    // Nodes whose last frame carried no token sequence
+    uint8_t _tokenSequence;             // Newest token sequence seen, 0 = none yet
+    uint8_t _lastTokenTo;               // Receiver of the last token pass seen or sent
+    bool _lastTokenInvitation;          // That pass carried a join invitation
+    bool _sequenceAnnounced;            // A full frame carried our sequence since we last reclaimed
+    ModBeeNodeSet _idleNodes;           // Passed a short token, nothing addressed to them since
+    uint8_t _idleSkips[256];            // Passes that went past each idle node since its last turn
+    uint8_t _idleStreak[256];           // Short tokens in a row: the longer idle, the more turns skipped
     bool _tokenReceivedForUs;
     bool _tokenConfirmed;
     uint8_t _tokenRetryNode;
     uint8_t _tokenRetryCount;
     
+    // Timed token: rotation measured between our own token arrivals
+    bool _tokenHeld;                    // From arrival until the token leaves our states
+    bool _tokenHoldRecorded;            // Hold time taken at the first pass attempt that went out
+    bool _tokenRotationValid;           // A previous arrival exists in this ring membership
+    uint32_t _tokenArrivalUs;
+    uint32_t _tokenRotationUs;          // Rotation measured at the current arrival
+    ModBeeTokenStats _tokenStats;
+    
+    // Rotation estimate for timeouts, smoothed like TCP SRTT/RTTVAR (gains 1/8 and 1/4)
+    bool _rotationEstimateValid;
+    uint32_t _rotationMeanUs;
+    uint32_t _rotationDevUs;
+    
     // =============================================================================
     // NEW JOIN PROTOCOL STATE VARIABLES
     // =============================================================================
@@ -130,20 +223,36 @@ private:
     // Coordinator state
     bool _isCoordinator;
     uint8_t _currentJoinNodeID;
-    unsigned long _lastJoinInvitation;
-    unsigned long _joinWindowStart;
+    uint32_t _lastJoinInvitation;
+    uint32_t _joinWindowStart;
     uint8_t _invitedNodeID;
     bool _buildingNetwork;
-    unsigned long _networkBuildStart;
+    uint32_t _networkBuildStart;
+    
+    // Slotted build: ID ranges still to be offered a join window
+    struct JoinRange {
+        uint8_t first;
+        uint8_t last;
+        uint8_t slots;
+    };
+    JoinRange _joinRanges[MODBEE_JOIN_RANGE_STACK];
+    uint8_t _joinRangeCount;
+    JoinRange _joinWindow;              // Window currently open
+    bool _joinWindowOpen;
+    uint32_t _joinWindowEndUs;
+    uint32_t _joinWindowHeard;          // Bit k: a valid join response arrived in slot k
     
     // Join management timing
-    unsigned long _lastJoinManagement;
+    uint32_t _lastJoinManagement;
     
     // Node joining state
     bool _waitingForInvitation;
-    unsigned long _joinWaitStart;
+    uint32_t _joinWaitStart;
     bool _invitationReceived;
     uint8_t _invitationFromNode;
+    bool _joinSlotPending;              // Answer a join window at _joinSlotDueUs
+    uint32_t _joinSlotDueUs;
+    bool _awaitingFirstToken;           // Answered a window, may have to answer a narrower one
     
     // Random timing for collision avoidance
     unsigned long _randomInitialListenTime;
@@ -151,27 +260,37 @@ private:
     
     // Network activity detection
     bool _networkActivityDetected;
-    unsigned long _firstActivityTime;
+    uint32_t _firstActivityTime;
     
     // State management
-    unsigned long _stateEntryTime;
+    uint32_t _stateEntryTime;           // INITIAL_LISTEN: start of the listen period
 
     // Join invitation tracking
     bool _lastJoinInvitationSent;
     bool _waitingForJoinResponse;
-    unsigned long _joinResponseStartTime;
+    uint32_t _joinResponseStartTime;
     bool _joinResponseReceived;
 
     // Add a new member variable to track if we got a response
     uint8_t _lastInvitedNodeID;
 
     // Join response waiting state (for nodes that receive token with join invitation)
-    unsigned long _joinResponseWaitStart;
+    uint32_t _joinResponseWaitStart;
+    
+    // Node timeout checks (per instance, several protocols may share a process)
+    uint32_t _lastNodeTimeoutCheck;
     
     // =============================================================================
     // HELPER METHODS
     // =============================================================================
     void checkNodeTimeouts();
+    void startTokenHold();
+    void recordTokenHold();
+    void addRotationSample(uint32_t rotationUs);
+    uint8_t getReclaimRank() const;
+    uint8_t getIdleSkipLimit() const;
+    void countIdleSkips(uint8_t fromNodeID, uint8_t toNodeID);
+    static bool isNewerTokenSequence(uint8_t sequence, uint8_t reference);
     void transitionToState(ModBeeProtocolState newState);
     void resetCoordinatorState();
     void resetJoiningState();
@@ -182,6 +301,11 @@ private:
     bool shouldSendJoinInvitation();
     void startNetworkBuilding();
     void completeNetworkBuilding();
+    bool useJoinWindows() const;
+    uint32_t getJoinSlotUs() const;
+    void pushJoinRange(uint8_t first, uint8_t last, uint8_t slots);
+    bool processSlottedBuild();
+    void closeJoinWindow();
     uint8_t findNextUnknownNode(uint8_t startFrom);
     const char* getStateName(ModBeeProtocolState state);
 };
@@ -0,0 +1,77 @@
+#include "ModBeeGlobal.h"
+
+// =============================================================================
+// CONSTRUCTORS
+// =============================================================================
+ModBeeRequest::ModBeeRequest() {
+}
+
+ModBeeRequest::ModBeeRequest(ModBeeCompletion onComplete)
+    : _status(std::make_shared<Status>()) {
+    _status->state = MBEE_REQUEST_PENDING;
+    _status->exceptionCode = 0;
+    _status->callback = std::move(onComplete);
+}
+
+// =============================================================================
+// STATUS
+// =============================================================================
+ModBeeRequestState ModBeeRequest::state() const {
+    return _status ? _status->state : MBEE_REQUEST_FAILED;
+}
+
+uint8_t ModBeeRequest::exceptionCode() const {
+    return _status ? _status->exceptionCode : 0;
+}
+
+void ModBeeRequest::onComplete(ModBeeCompletion callback) {
+    if (!_status) {
+        if (callback) {
+            callback(MBEE_REQUEST_FAILED, 0);
+        }
+        return;
+    }
+    if (_status->state != MBEE_REQUEST_PENDING) {
+        if (callback) {
+            callback(_status->state, _status->exceptionCode);
+        }
+        return;
+    }
+    _status->callback = std::move(callback);
+}
+
+// =============================================================================
+// COMPLETION
+// =============================================================================
+ModBeeCompletion ModBeeRequest::completion() const {
+    if (!_status) {
+        return nullptr;
+    }
+    std::shared_ptr<Status> status = _status;
+    return [status](ModBeeRequestState state, uint8_t exceptionCode) {
+        settle(*status, state, exceptionCode);
+    };
+}
+
+ModBeeRequest& ModBeeRequest::start(ModBeeRequestState state) {
+    if (_status && state != MBEE_REQUEST_PENDING) {
+        settle(*_status, state, 0);
+    }
+    return *this;
+}
+
+void ModBeeRequest::settle(Status& status, ModBeeRequestState state, uint8_t exceptionCode) {
+    // Only the first outcome counts
+    if (status.state != MBEE_REQUEST_PENDING) {
+        return;
+    }
+    status.state = state;
+    status.exceptionCode = exceptionCode;
+    
+    // Released before the call: a callback holding its own handle would never be freed
+    ModBeeCompletion callback = std::move(status.callback);
+    status.callback = nullptr;
+    if (callback) {
+        callback(state, exceptionCode);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+/**
+ * Handle to a remote read or write started with one of the *Async() calls
+ * Copies share one status. The queued operation holds a completion that
+ * settles it exactly once: DONE when a read's response has been written to the
+ * variable or a write has been sent (writes are not answered), EXCEPTION with
+ * the node's exception code, TIMEOUT after every retry, CANCELLED when the
+ * node is lost or the queue cleared. Callbacks run from ModBeeProtocol::loop(),
+ * from ModBeeAPI::end() for requests it cancels, or at once for local
+ * operations and calls that fail.
+ */
+class ModBeeRequest {
+public:
+    // =============================================================================
+    // CONSTRUCTORS
+    // =============================================================================
+    ModBeeRequest();                                // No request: state() is MBEE_REQUEST_FAILED
+    explicit ModBeeRequest(ModBeeCompletion onComplete);
+
+    // =============================================================================
+    // STATUS
+    // =============================================================================
+    ModBeeRequestState state() const;
+    uint8_t exceptionCode() const;                  // 0 unless state() is MBEE_REQUEST_EXCEPTION
+    bool isPending() const { return state() == MBEE_REQUEST_PENDING; }
+    bool isDone() const { return state() == MBEE_REQUEST_DONE; }
+
+    // Replaces the callback; one added after the request settled is called at once
+    void onComplete(ModBeeCompletion callback);
+
+    // =============================================================================
+    // COMPLETION - Used by ModBeeAPI
+    // =============================================================================
+    ModBeeCompletion completion() const;            // Settles this request, for the operation
+    ModBeeRequest& start(ModBeeRequestState state); // Settles it unless the operation was queued
+
+private:
+    struct Status {
+        ModBeeRequestState state;
+        uint8_t exceptionCode;
+        ModBeeCompletion callback;
+    };
+    std::shared_ptr<Status> _status;
+
+    static void settle(Status& status, ModBeeRequestState state, uint8_t exceptionCode);
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+#define MODBEE_OP_NONE           0xFF    // End of a slot list
+
+/**
+ * Timeout queue over a fixed set of slots
+ * Every entry of one kind shares one adaptive timeout, so the order entries
+ * were armed in is the order they expire in. Slots are threaded on an index
+ * list sorted by arm time: arming the newest entry is O(1), the next to expire
+ * is always at the front, and a sweep stops at the first entry that has not
+ * expired. Unlike a wheel keyed on absolute expiry, the order holds when the
+ * timeout itself changes with the measured rotation.
+ */
+template<uint8_t N>
+class ModBeeTimerQueue {
+public:
+    // =============================================================================
+    // CONSTRUCTOR
+    // =============================================================================
+    ModBeeTimerQueue() { clear(); }
+
+    // =============================================================================
+    // ARMING
+    // =============================================================================
+    void arm(uint8_t slot, uint32_t startMs) {
+        // Walk back past entries armed later, which there nearly never are
+        uint8_t after = _tail;
+        while (after != MODBEE_OP_NONE && (int32_t)(startMs - _startMs[after]) < 0) {
+            after = _prev[after];
+        }
+        uint8_t next = (after == MODBEE_OP_NONE) ? _head : _next[after];
+        _startMs[slot] = startMs;
+        _prev[slot] = after;
+        _next[slot] = next;
+        if (after != MODBEE_OP_NONE) {
+            _next[after] = slot;
+        } else {
+            _head = slot;
+        }
+        if (next != MODBEE_OP_NONE) {
+            _prev[next] = slot;
+        } else {
+            _tail = slot;
+        }
+    }
+
+    void disarm(uint8_t slot) {
+        if (_prev[slot] != MODBEE_OP_NONE) {
+            _next[_prev[slot]] = _next[slot];
+        } else {
+            _head = _next[slot];
+        }
+        if (_next[slot] != MODBEE_OP_NONE) {
+            _prev[_next[slot]] = _prev[slot];
+        } else {
+            _tail = _prev[slot];
+        }
+    }
+
+    void rearm(uint8_t slot, uint32_t startMs) {
+        disarm(slot);
+        arm(slot, startMs);
+    }
+
+    void clear() {
+        _head = MODBEE_OP_NONE;
+        _tail = MODBEE_OP_NONE;
+    }
+
+    // =============================================================================
+    // EXPIRY
+    // =============================================================================
+    uint8_t front() const { return _head; }                 // MODBEE_OP_NONE when empty
+    bool expired(uint32_t nowMs, unsigned long timeoutMs) const {
+        return _head != MODBEE_OP_NONE && nowMs - _startMs[_head] > timeoutMs;
+    }
+    const uint8_t* links() const { return _next; }          // Oldest to newest
+
+private:
+    uint32_t _startMs[N];
+    uint8_t _next[N];
+    uint8_t _prev[N];
+    uint8_t _head;
+    uint8_t _tail;
+};
@@ -6,6 +6,7 @@
 // =============================================================================
 // Abstract transport interface for ModBee protocol
 // This abstraction allows supporting different transport methods (Serial, UDP, etc.)
+// ModBeeIO performs all protocol I/O through it, reading in bulk where possible
 class ModBeeTransport {
 public:
     virtual ~ModBeeTransport() = default;
@@ -19,6 +20,9 @@ public:
     // Read a single byte
     virtual int read() = 0;
     
+    // Read up to length bytes that are already available (never blocks)
+    virtual size_t read(uint8_t* buffer, size_t length) = 0;
+    
     // Write data to the transport
     virtual size_t write(const uint8_t* buffer, size_t size) = 0;
     
@@ -30,6 +34,14 @@ public:
     
     // Check if connected
     virtual bool isConnected() const = 0;
+    
+    // Line baud rate, 0 if unknown (sets the inter-frame gap and bus utilisation)
+    virtual uint32_t getBaudRate() const { return 0; }
+    
+    // micros() at which the line went idle after the last byte read, if the
+    // transport can tell (e.g. from an RX idle interrupt) and no byte after it
+    // has been read yet
+    virtual bool getLastRxIdleUs(uint32_t& /*timestampUs*/) { return false; }
 };
 
 // =============================================================================
@@ -56,6 +68,13 @@ public:
         return _stream ? _stream->read() : -1;
     }
     
+    size_t read(uint8_t* buffer, size_t length) override {
+        if (!_stream) return 0;
+        int ready = _stream->available();
+        if (ready <= 0) return 0;
+        return _stream->readBytes(buffer, std::min(length, (size_t)ready));
+    }
+    
     size_t write(const uint8_t* buffer, size_t size) override {
         return _stream ? _stream->write(buffer, size) : 0;
     }
@@ -9,16 +9,81 @@
 #define MODBEE_SOF               0x7E    // Start of Frame marker
 #define MODBEE_PACKET_DELIM      0x7C    // Packet delimiter within frame
 
+// Multicast sections: DEST 0 is followed by a GROUP byte, every member applies the write
+#define MODBEE_BROADCAST_ID      0       // Section DEST of a multicast write
+#define MODBEE_GROUP_ALL         0       // GROUP every node belongs to (broadcast)
+
+// Transaction sections: [DEST] [0x41] [TID] tags the next section to the same DEST
+// with a transaction ID. Nodes that predate them fail to parse the section and skip it
+#define MODBEE_FC_TRANSACTION    0x41    // Modbus user-defined function code 65
+
+// Time sections: [0] [GROUP 0] [0x42] [TIME] carries the time master's network time
+// as its frame started going out; [DEST] [0x43] [TIME] (or [0] [GROUP] [0x43] [TIME]) holds the
+// next write taken with that addressing until the network time reaches TIME.
+// TIME is 32 bits of microseconds in six 6-bit groups, most significant first: no byte
+// of it is ever a framing byte, so it never needs escaping or splits a plain frame
+#define MODBEE_FC_TIME_SYNC      0x42    // Modbus user-defined function code 66
+#define MODBEE_FC_APPLY_AT       0x43    // Modbus user-defined function code 67
+#define MODBEE_TIME_FIELD_LEN    6
+#define MODBEE_TIME_STEP_US      1000    // Clock errors above this are stepped, smaller ones slewed
+#define MODBEE_TIME_MAX_DRIFT_PPB 1000000 // Rate correction limit, 1000 ppm
+#define MODBEE_TIME_HOLDOVER_US  0x40000000UL // Without samples, drift is folded into the offset this often (~18 min)
+
+// Frame format versions
+#define MODBEE_FRAME_VERSION_LEGACY  1   // [SOF][SRC][NEXT][ADD][REM]...[CRC]
+#define MODBEE_FRAME_VERSION_2       2   // [SOF][VER][LEN_H][LEN_L][SRC][NEXT][ADD][REM]...[CRC]
+#define MODBEE_FRAME_V2_MARKER   0xFB    // VER byte of v2 frames (251, above the 1-250 node ID range)
+#define MODBEE_FRAME_V2_STUFFED_MARKER 0xFC  // VER byte of byte-stuffed v2 frames
+#define MODBEE_FRAME_V2_COMPACT_MARKER 0xFD  // VER byte of v2 frames with compact sections
+#define MODBEE_FRAME_LEN_H_MASK  0x07    // LEN_H bits 2-0: v2 frames are at most 512 bytes
+#define MODBEE_TOKEN_SEQ_SHIFT   3       // LEN_H bits 7-3: token sequence, 0 = not sequenced
+#define MODBEE_TOKEN_SEQ_MAX     31      // Sequences run 1-31 and wrap
+
+// Short token pass: [SOF][0xFE][SRC][NEXT][CHK], sent instead of an empty control frame
+// CHK is a CRC-8 over VER, SRC, NEXT and the token sequence, which is not sent
+#define MODBEE_SHORT_TOKEN_MARKER 0xFE   // VER byte of a short token pass
+#define MODBEE_SHORT_TOKEN_LEN   5
+
+// Byte stuffing (HDLC-style, v2 stuffed frames only)
+#define MODBEE_ESCAPE            0x7D    // Escape marker, next byte is XORed with MODBEE_ESCAPE_XOR
+#define MODBEE_ESCAPE_XOR        0x20    // 0x7E -> 7D 5E, 0x7D -> 7D 5D, 0x7C (data) -> 7D 5C
+#define MODBEE_MAX_FRAME_SECTIONS 80     // Maximum Modbus sections tracked per stuffed frame
+
+// Compact sections (v2 compact frames only): [TAG] [LEN] [DEST] [ADDR] [COUNT] [DATA]
+// TLV with explicit length, no delimiter; ADDR and COUNT are LEB128 varints
+#define MODBEE_COMPACT_RESPONSE   0x80   // TAG: read response (with WRITE: exception response)
+#define MODBEE_COMPACT_WRITE      0x40   // TAG: write request
+#define MODBEE_COMPACT_TYPE_SHIFT 4      // TAG bits 5-4: ModBeeRegisterType
+#define MODBEE_COMPACT_LEN_MASK   0x0F   // TAG bits 3-0: LEN (DEST through DATA) when below 15
+#define MODBEE_COMPACT_LEN_EXT    0x0F   // LEN does not fit the TAG, a varint LEN follows
+#define MODBEE_COMPACT_TRANSACTION 0x60  // TAG: transaction section [DEST] [TID] (a write to inputs otherwise)
+#define MODBEE_COMPACT_EXTENSION  0x70   // TAG: [DEST] ([GROUP]) [FC] [DATA] for FCs 0x41-0x43 (a write to input registers otherwise)
+#define MODBEE_MAX_PDU_SIZE       256    // Largest Modbus PDU re-encoded as a compact section
+
 // Network configuration limits
 //#define MODBEE_MAX_NODES         10      // Maximum nodes allowed in network
 #define MODBEE_MAX_RX_BUFFER     512     // Maximum receive buffer size
 #define MODBEE_MAX_TX_BUFFER     512     // Maximum transmit buffer size
 #define MODBEE_MIN_FRAME_LEN     7       // Minimum valid frame length
+#define MODBEE_V2_MIN_FRAME_LEN  10      // Minimum valid v2 frame length
+#define MODBEE_RX_RING_SIZE      1536    // RX ring, received frames stay in place until processed
+#define MODBEE_RX_CHUNK_SIZE     64      // Bytes pulled from the transport per read
+#define MODBEE_MAX_FRAME_QUEUE   16      // Maximum complete frames waiting in the RX ring
+
+// Inter-frame gap (used when ModBeeAPI::MODBEE_INTERFRAME_GAP_US is 0)
+#define MODBEE_DEFAULT_INTERFRAME_GAP_US 5000  // Baud rate unknown
+#define MODBEE_MAX_INTERFRAME_GAP_US     20000 // Upper bound for the adaptive gap
+#define MODBEE_BITS_PER_BYTE     10      // 8N1 on the wire
 
 // Operation and data management limits
 #define MODBEE_MAX_PENDING_OPS          50    // Maximum queued operations
 #define MODBEE_MAX_PENDING_RESPONSES    50    // Maximum queued responses
+#define MODBEE_MAX_TRANSACTIONS         32    // Reads sent and awaiting their response
 #define MODBEE_MAX_DATA_POINTS          1000  // Maximum data map entries
+#define MODBEE_MAX_PUBLICATIONS         16    // Local ranges sent in every data frame
+#define MODBEE_MAX_SUBSCRIPTIONS        32    // Remote ranges mirrored into local variables
+#define MODBEE_MAX_SCHEDULED_WRITES     16    // Received writes held for their network time
+#define MODBEE_MAX_POLL_POINTS          256   // Remote ranges read on a period by the polling table
 
 // =============================================================================
 // NEW JOIN PROTOCOL STATES
@@ -36,11 +101,46 @@ enum ModBeeProtocolState {
     MBEE_DISCONNECTED                   // Disconnected state
 };
 
+// =============================================================================
+// OPERATION PRIORITY
+// =============================================================================
+
+enum ModBeePriority {
+    MBEE_PRIORITY_LOW,                  // Sent while the token-hold budget lasts
+    MBEE_PRIORITY_HIGH                  // Cyclic data, sent on every token even when late
+};
+
+// =============================================================================
+// REQUEST COMPLETION
+// =============================================================================
+
+enum ModBeeRequestState {
+    MBEE_REQUEST_PENDING,               // Queued, or sent and awaiting its response
+    MBEE_REQUEST_DONE,                  // Read answered into the variable, or write sent
+    MBEE_REQUEST_EXCEPTION,             // The node answered with a Modbus exception
+    MBEE_REQUEST_TIMEOUT,               // Unanswered or unsent after every retry
+    MBEE_REQUEST_CANCELLED,             // Dropped: the node was lost or the queue cleared
+    MBEE_REQUEST_FAILED                 // Never queued: not started, unknown node or queue full
+};
+
+// Called once with the final state; exceptionCode is set for MBEE_REQUEST_EXCEPTION
+typedef std::function<void(ModBeeRequestState state, uint8_t exceptionCode)> ModBeeCompletion;
+
 // =============================================================================
 // JOIN PROTOCOL SPECIAL VALUES
 // =============================================================================
 
 #define MODBEE_JOIN_TOKEN              255    // NEXT field value indicating join invitation
+#define MODBEE_JOIN_WINDOW             254    // REM field value of a slotted join window frame
+#define MODBEE_JOIN_WINDOW_PAYLOAD     5      // [FIRST] [LAST] [SLOTS] [SLOT_H] [SLOT_L] after the header
+#define MODBEE_JOIN_SLOT_UNIT_US       10     // SLOT field unit
+#define MODBEE_MAX_JOIN_SLOTS          32     // Slots per window (one bit each in the window masks)
+#define MODBEE_JOIN_RANGE_STACK        48     // ID ranges waiting for a window during a slotted build
+#define MODBEE_JOIN_RESPONSE_WIRE_BYTES 12    // Join response on the wire, v2 with some escapes
+#define MODBEE_LISTEN_STEP_MS          10     // Initial listen offset per node ID, the lowest ID claims the bus first
+#define MODBEE_OP_TIMEOUT_ROTATIONS    4      // Adaptive timeouts in token rotations (mean + 4 deviations each)
+#define MODBEE_NODE_TIMEOUT_ROTATIONS  8
+#define MODBEE_MAX_IDLE_SKIP_ROTATIONS 4      // A skipped node is not heard from: stay well inside the node timeout
 //#define MODBEE_TOKEN_RECLAIM_TIMEOUT   5250    // Token reclaim timeout (ms)
 //#define MODBEE_JOIN_CYCLE_INTERVAL     50     // Join invitation interval (ms)
 //#define MODBEE_JOIN_RESPONSE_TIMEOUT   20     // Join response wait time (ms)
@@ -133,21 +233,37 @@ struct ModbusRequest {
     uint16_t quantity;                  // Number of registers/coils
     std::vector<uint8_t> data;          // Data payload
     bool isResponse = false;            // Response flag
+    uint8_t transactionID = 0;          // Read transaction, echoed in its response (0 = none)
+    uint32_t applyAtUs = 0;             // Write: network time to apply it at (0 = on arrival)
+};
+
+/**
+ * A read merged into a wider queued read: where its share of the response goes
+ */
+struct ModBeeReadTarget {
+    uint16_t startAddr;                 // First address this caller asked for
+    uint16_t quantity;                  // Values written to resultPtr
+    void* resultPtr;                    // Caller's variable or array
+    ModBeeCompletion onComplete;        // Caller's completion callback
 };
 
 /**
  * Pending operation structure for queue management
  */
 struct PendingModbusOp {
-    uint8_t destNodeID;                 // Target node ID
+    uint8_t destNodeID;                 // Target node ID, MODBEE_BROADCAST_ID for a multicast write
+    uint8_t group = MODBEE_GROUP_ALL;   // Multicast group (broadcast writes only)
     uint8_t sourceNodeID;               // Source node ID
     ModbusRequest req;                  // Request data
-    unsigned long timestamp;            // Queue timestamp
+    uint32_t timestamp;                 // Queue timestamp
     uint8_t retryCount;                 // Retry counter
     void* resultPtr;                    // Result pointer for direct access
     bool isArray;                       // Array operation flag
     uint16_t arraySize;                 // Array size if applicable
-    std::function<void()> onComplete;   // Completion callback
+    ModBeePriority priority;            // Token-hold budget class
+    bool unbuildable = false;           // Found to have no encoding while packed: fails when the frame goes out
+    ModBeeCompletion onComplete;        // Completion callback
+    std::vector<ModBeeReadTarget> mergedReads; // Reads this wider one answers (resultPtr unused)
 };
 
 /**
@@ -157,7 +273,45 @@ struct PendingResponse {
     ModbusRequest response;             // Response data
     uint8_t destNodeID;                 // Response destination
     uint8_t sourceNodeID;               // Response source
-    unsigned long timestamp;            // Queue timestamp
+    uint32_t timestamp;                 // Queue timestamp
+};
+
+/**
+ * Publication: a local data map range sent in every data frame we send
+ */
+struct ModBeePublication {
+    uint8_t function;                   // Read function code of the range's type
+    uint16_t startAddr;
+    uint16_t quantity;
+};
+
+/**
+ * Subscription: a range another node publishes, mirrored into local variables
+ */
+struct ModBeeSubscription {
+    uint8_t nodeID;                     // Publisher
+    uint8_t function;                   // Read function code of the range's type
+    uint16_t startAddr;
+    uint16_t quantity;
+    void* values;                       // bool[] for coils and inputs, int16_t[] for registers
+    uint32_t lastUpdate;                // millis() of the last update
+    bool updated;                       // Set by the first update
+};
+
+/**
+ * Poll point: a remote range read into local variables every period
+ */
+struct ModBeePollPoint {
+    uint32_t id;                        // Never reused: completions of removed points are ignored
+    uint8_t nodeID;
+    uint8_t function;                   // Read function code of the range's type
+    uint16_t startAddr;
+    uint16_t quantity;
+    void* values;                       // bool[] for coils and inputs, int16_t[] for registers
+    unsigned long periodMs;
+    uint32_t nextDueMs;                 // millis() the next read is due
+    ModBeePriority priority;            // Operation priority when the point was added
+    bool outstanding;                   // A read is queued or awaiting its response
 };
 
 /**
@@ -180,7 +334,7 @@ struct PendingReadKey {
  */
 struct PendingReadInfo {
     uint16_t quantity;                  // Number of items requested
-    unsigned long timestamp;            // Request timestamp
+    uint32_t timestamp;                 // Request timestamp
     uint8_t retryCount;                 // Retry counter
 };
 
@@ -208,10 +362,14 @@ struct DataMapStats {
 struct OperationStats {
     uint16_t pendingOperations;         // Pending operations count
     uint16_t pendingResponses;          // Pending responses count
-    uint16_t pendingReads;              // Pending reads count
+    uint16_t pendingReads;              // Reads sent and awaiting their response
     uint16_t readOperations;            // Read operations count
     uint16_t writeOperations;           // Write operations count
     uint16_t retryOperations;           // Retry operations count
+    uint32_t lateResponses;             // Responses whose read had already completed or timed out
+    uint32_t mergedReads;               // Reads answered by a wider queued read instead of their own
+    uint32_t mergedWrites;              // Writes folded into a queued write to the same registers
+    uint32_t bytesSaved;                // Request bytes the merged operations would have sent
 };
 
 /**
@@ -0,0 +1,304 @@
+#include "ModBeeGlobal.h"
+
+#if defined(ESP32)
+
+// =============================================================================
+// STATISTICS
+// =============================================================================
+float ModBeeUartStats::getLatencyMeanUs() const {
+    if (latencySamples == 0) {
+        return 0.0f;
+    }
+    return (float)latencySumUs / latencySamples;
+}
+
+float ModBeeUartStats::getLatencyJitterUs() const {
+    if (latencySamples < 2) {
+        return 0.0f;
+    }
+    float mean = getLatencyMeanUs();
+    float variance = (float)latencySumSqUs / latencySamples - mean * mean;
+    return variance > 0.0f ? sqrtf(variance) : 0.0f;
+}
+
+// =============================================================================
+// CONSTRUCTOR AND SETUP
+// =============================================================================
+ModBeeUartTransport::ModBeeUartTransport(uart_port_t port, int rxPin, int txPin, uint32_t baudRate, int dePin)
+    : _port(port),
+      _rxPin(rxPin),
+      _txPin(txPin),
+      _dePin(dePin),
+      _baudRate(baudRate),
+      _rxTimeoutUs(0),
+      _eventQueue(nullptr),
+      _task(nullptr),
+      _frameCallback(nullptr),
+      _frameContext(nullptr),
+      _markHead(0),
+      _markTail(0),
+      _rxBytesTotal(0),
+      _rxBytesConsumed(0),
+      _flushCount(0),
+      _seenFlushCount(0),
+      _lastFrameEndUs(0),
+      _readFrameEndByte(0),
+      _readFrameEndUs(0),
+      _readFrameEndValid(false) {
+}
+
+ModBeeUartTransport::~ModBeeUartTransport() {
+    end();
+}
+
+bool ModBeeUartTransport::begin() {
+    if (_task) {
+        return true;
+    }
+
+    uart_config_t config = {};
+    config.baud_rate = (int)_baudRate;
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_APB;
+
+    if (uart_driver_install(_port, MODBEE_UART_RX_BUFFER, MODBEE_UART_TX_BUFFER,
+                            MODBEE_UART_EVENT_QUEUE, &_eventQueue, 0) != ESP_OK) {
+        return false;
+    }
+
+    // The hardware raises DE (RTS) for exactly as long as the transmitter runs
+    int rtsPin = _dePin >= 0 ? _dePin : UART_PIN_NO_CHANGE;
+    if (uart_param_config(_port, &config) != ESP_OK ||
+        uart_set_pin(_port, _txPin, _rxPin, rtsPin, UART_PIN_NO_CHANGE) != ESP_OK ||
+        (_dePin >= 0 && uart_set_mode(_port, UART_MODE_RS485_HALF_DUPLEX) != ESP_OK) ||
+        uart_set_rx_timeout(_port, MODBEE_UART_RX_TIMEOUT_SYMBOLS) != ESP_OK) {
+        uart_driver_delete(_port);
+        _eventQueue = nullptr;
+        return false;
+    }
+
+    // One symbol is 10 bits (start + 8 data + stop)
+    _rxTimeoutUs = (uint32_t)(MODBEE_UART_RX_TIMEOUT_SYMBOLS * 10ULL * 1000000ULL / _baudRate);
+
+    _markHead = 0;
+    _markTail = 0;
+    _rxBytesTotal = 0;
+    _rxBytesConsumed = 0;
+    _flushCount = 0;
+    _seenFlushCount = 0;
+    _readFrameEndValid = false;
+
+    if (xTaskCreatePinnedToCore(rxTaskEntry, "modbee_rx", MODBEE_UART_TASK_STACK, this,
+                                MODBEE_UART_TASK_PRIORITY, &_task, MODBEE_UART_TASK_CORE) != pdPASS) {
+        _task = nullptr;
+        uart_driver_delete(_port);
+        _eventQueue = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void ModBeeUartTransport::end() {
+    if (_task) {
+        vTaskDelete(_task);
+        _task = nullptr;
+    }
+    if (_eventQueue) {
+        uart_driver_delete(_port);
+        _eventQueue = nullptr;
+    }
+}
+
+void ModBeeUartTransport::onFrame(void (*callback)(void* context), void* context) {
+    _frameCallback = callback;
+    _frameContext = context;
+}
+
+// =============================================================================
+// RX TASK
+// =============================================================================
+void ModBeeUartTransport::rxTaskEntry(void* arg) {
+    static_cast<ModBeeUartTransport*>(arg)->rxTask();
+}
+
+void ModBeeUartTransport::rxTask() {
+    uart_event_t event;
+
+    for (;;) {
+        if (xQueueReceive(_eventQueue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // This task outranks everything else on its core, so "now" is within a
+        // context switch of the driver ISR that queued the event
+        uint32_t nowUs = (uint32_t)esp_timer_get_time();
+
+        switch (event.type) {
+            case UART_DATA: {
+                _rxBytesTotal = _rxBytesTotal + event.size;
+                _stats.rxBytes += event.size;
+
+                if (!event.timeout_flag) {
+                    break; // FIFO threshold reached mid-frame
+                }
+
+                // Bus has been idle for the RX timeout: the frame is complete
+                uint32_t endUs = nowUs - _rxTimeoutUs;
+                _lastFrameEndUs = endUs;
+                _stats.framesDetected++;
+
+                uint8_t next = (_markHead + 1) % MODBEE_UART_TIMESTAMP_QUEUE;
+                if (next != _markTail) {
+                    _marks[_markHead].endByte = _rxBytesTotal;
+                    _marks[_markHead].endUs = endUs;
+                    _markHead = next;
+                } else {
+                    _stats.timestampsDropped++;
+                }
+
+                if (_frameCallback) {
+                    _frameCallback(_frameContext);
+                }
+                break;
+            }
+
+            case UART_FIFO_OVF:
+                _stats.fifoOverflows++;
+                discardInput();
+                break;
+
+            case UART_BUFFER_FULL:
+                _stats.bufferFullEvents++;
+                discardInput();
+                break;
+
+            case UART_BREAK:
+            case UART_PARITY_ERR:
+            case UART_FRAME_ERR:
+                _stats.lineErrors++;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void ModBeeUartTransport::discardInput() {
+    // Bytes are already lost; drop the rest so the parser resynchronises on the next SOF
+    uart_flush_input(_port);
+    xQueueReset(_eventQueue);
+    _flushCount = _flushCount + 1;
+}
+
+// =============================================================================
+// TRANSPORT INTERFACE
+// =============================================================================
+int ModBeeUartTransport::available() {
+    size_t buffered = 0;
+    uart_get_buffered_data_len(_port, &buffered);
+    return (int)buffered;
+}
+
+int ModBeeUartTransport::read() {
+    uint8_t byte;
+    return read(&byte, 1) == 1 ? byte : -1;
+}
+
+size_t ModBeeUartTransport::read(uint8_t* buffer, size_t length) {
+    int got = uart_read_bytes(_port, buffer, length, 0);
+    if (got <= 0) {
+        return 0;
+    }
+
+    consumed(got);
+    return (size_t)got;
+}
+
+size_t ModBeeUartTransport::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+size_t ModBeeUartTransport::write(const uint8_t* buffer, size_t size) {
+    int written = uart_write_bytes(_port, (const char*)buffer, size);
+    return written > 0 ? (size_t)written : 0;
+}
+
+void ModBeeUartTransport::flush() {
+    uart_wait_tx_done(_port, portMAX_DELAY);
+}
+
+// =============================================================================
+// TIMING AND STATISTICS
+// =============================================================================
+void ModBeeUartTransport::consumed(size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    // Input was discarded by the RX task: byte counts no longer line up
+    if (_seenFlushCount != _flushCount) {
+        _seenFlushCount = _flushCount;
+        _rxBytesConsumed = _rxBytesTotal;
+        _markTail = _markHead;
+        _readFrameEndValid = false;
+        return;
+    }
+
+    _rxBytesConsumed += count;
+    retireMarks();
+}
+
+void ModBeeUartTransport::retireMarks() {
+    uint32_t nowUs = 0;
+
+    // Every frame whose last byte has now been read yields one latency sample
+    while (_markTail != _markHead) {
+        const FrameMark& mark = _marks[_markTail];
+        if ((int32_t)(_rxBytesConsumed - mark.endByte) < 0) {
+            break;
+        }
+
+        if (nowUs == 0) {
+            nowUs = (uint32_t)esp_timer_get_time();
+        }
+        uint32_t latency = nowUs - mark.endUs;
+        if (_stats.latencySamples == 0 || latency < _stats.latencyMinUs) {
+            _stats.latencyMinUs = latency;
+        }
+        if (latency > _stats.latencyMaxUs) {
+            _stats.latencyMaxUs = latency;
+        }
+        _stats.latencySamples++;
+        _stats.latencySumUs += latency;
+        _stats.latencySumSqUs += (uint64_t)latency * latency;
+
+        _readFrameEndByte = mark.endByte;
+        _readFrameEndUs = mark.endUs;
+        _readFrameEndValid = true;
+
+        _markTail = (_markTail + 1) % MODBEE_UART_TIMESTAMP_QUEUE;
+    }
+}
+
+bool ModBeeUartTransport::getLastRxIdleUs(uint32_t& timestampUs) {
+    // The RX timeout event can land after the frame's last byte was read
+    retireMarks();
+
+    // Only exact while nothing past that frame end has been read
+    if (!_readFrameEndValid || _rxBytesConsumed != _readFrameEndByte) {
+        return false;
+    }
+    timestampUs = _readFrameEndUs;
+    return true;
+}
+
+void ModBeeUartTransport::resetStatistics() {
+    _stats = ModBeeUartStats();
+}
+
+#endif // ESP32
@@ -0,0 +1,166 @@
+#pragma once
+#include "ModBeeGlobal.h"
+
+#if defined(ESP32)
+
+#include <driver/uart.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// =============================================================================
+// UART TRANSPORT CONFIGURATION
+// =============================================================================
+#ifndef MODBEE_UART_RX_BUFFER
+#define MODBEE_UART_RX_BUFFER        4096    // Driver RX ring (filled from the UART ISR)
+#endif
+
+#ifndef MODBEE_UART_TX_BUFFER
+#define MODBEE_UART_TX_BUFFER        0       // 0 = uart_write_bytes blocks until queued in the FIFO
+#endif
+
+#ifndef MODBEE_UART_EVENT_QUEUE
+#define MODBEE_UART_EVENT_QUEUE      32      // Driver event queue depth
+#endif
+
+#ifndef MODBEE_UART_RX_TIMEOUT_SYMBOLS
+#define MODBEE_UART_RX_TIMEOUT_SYMBOLS 3     // Idle byte times that end a frame (RX timeout event)
+#endif
+
+#ifndef MODBEE_UART_TASK_PRIORITY
+#define MODBEE_UART_TASK_PRIORITY    (configMAX_PRIORITIES - 2)
+#endif
+
+#ifndef MODBEE_UART_TASK_STACK
+#define MODBEE_UART_TASK_STACK       3072
+#endif
+
+#ifndef MODBEE_UART_TASK_CORE
+#define MODBEE_UART_TASK_CORE        0
+#endif
+
+#define MODBEE_UART_TIMESTAMP_QUEUE  16      // Frame end timestamps awaiting the consumer
+
+// =============================================================================
+// STATISTICS STRUCTURE
+// =============================================================================
+struct ModBeeUartStats {
+    uint32_t rxBytes = 0;
+    uint32_t framesDetected = 0;        // RX timeout events (bus went idle after data)
+    uint32_t fifoOverflows = 0;         // Hardware FIFO overflowed before the ISR drained it
+    uint32_t bufferFullEvents = 0;      // Driver RX ring full (consumer too slow)
+    uint32_t lineErrors = 0;            // Parity, framing and break events
+    uint32_t timestampsDropped = 0;     // Frames ended while the timestamp queue was full
+
+    // Frame end on the wire -> frame fully read by the protocol
+    uint32_t latencySamples = 0;
+    uint32_t latencyMinUs = 0;
+    uint32_t latencyMaxUs = 0;
+    uint64_t latencySumUs = 0;
+    uint64_t latencySumSqUs = 0;
+
+    float getLatencyMeanUs() const;
+    float getLatencyJitterUs() const;   // Standard deviation of the latency
+};
+
+/**
+ * Interrupt-driven UART transport built on the ESP-IDF UART driver
+ * The driver ISR moves bytes from the hardware FIFO into a large RX ring, so a
+ * slow loop() can no longer overflow the FIFO. A dedicated task waits on the
+ * driver event queue and timestamps every frame end (RX timeout event) close
+ * to the interrupt. When the protocol reads the last byte of that frame the
+ * delay is recorded, giving end-to-end latency and jitter figures.
+ *
+ * With a DE pin the UART runs in RS485 half-duplex mode and drives the
+ * transceiver's driver enable (RTS) itself, raised only while bytes go out.
+ *
+ * Pass it to ModBeeAPI::begin() instead of a HardwareSerial.
+ */
+class ModBeeUartTransport : public ModBeeTransport {
+public:
+    // =============================================================================
+    // CONSTRUCTOR AND SETUP
+    // =============================================================================
+    // dePin: transceiver driver enable, -1 when the board switches direction itself
+    ModBeeUartTransport(uart_port_t port, int rxPin, int txPin, uint32_t baudRate, int dePin = -1);
+    ~ModBeeUartTransport();
+
+    bool begin() override;
+    void end();
+
+    // Called from the RX task after every frame end, e.g. to wake a task that runs modbee.loop()
+    void onFrame(void (*callback)(void* context), void* context);
+
+    // =============================================================================
+    // TRANSPORT INTERFACE
+    // =============================================================================
+    int available() override;
+    int read() override;
+    size_t read(uint8_t* buffer, size_t length) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    size_t write(uint8_t data) override;
+    void flush() override;
+    bool isConnected() const override { return _task != nullptr; }
+    uint32_t getBaudRate() const override { return _baudRate; }
+    bool getLastRxIdleUs(uint32_t& timestampUs) override;
+
+    // =============================================================================
+    // TIMING AND STATISTICS
+    // =============================================================================
+    uint32_t getRxTimeoutUs() const { return _rxTimeoutUs; }
+    uint32_t getLastFrameEndUs() const { return _lastFrameEndUs; }
+    const ModBeeUartStats& getStatistics() const { return _stats; }
+    void resetStatistics();
+
+private:
+    // =============================================================================
+    // DRIVER STATE
+    // =============================================================================
+    uart_port_t _port;
+    int _rxPin;
+    int _txPin;
+    int _dePin;                         // RTS as driver enable, -1 = none
+    uint32_t _baudRate;
+    uint32_t _rxTimeoutUs;              // Idle time between the last byte and the timeout event
+    QueueHandle_t _eventQueue;
+    TaskHandle_t _task;
+
+    void (*_frameCallback)(void* context);
+    void* _frameContext;
+
+    // =============================================================================
+    // FRAME TIMESTAMPS (RX task produces, reader consumes)
+    // =============================================================================
+    struct FrameMark {
+        uint32_t endByte;               // Value of _rxBytesTotal when the frame ended
+        uint32_t endUs;                 // Time the last byte left the wire
+    };
+
+    FrameMark _marks[MODBEE_UART_TIMESTAMP_QUEUE];
+    volatile uint8_t _markHead;         // Written by the RX task only
+    volatile uint8_t _markTail;         // Written by the reader only
+    volatile uint32_t _rxBytesTotal;    // Bytes the driver reported (RX task)
+    uint32_t _rxBytesConsumed;          // Bytes handed to the protocol (reader)
+    volatile uint32_t _flushCount;      // Bumped by the RX task when input was discarded
+    uint32_t _seenFlushCount;
+    volatile uint32_t _lastFrameEndUs;
+
+    // Newest frame end whose bytes have all been read (reader)
+    uint32_t _readFrameEndByte;
+    uint32_t _readFrameEndUs;
+    bool _readFrameEndValid;
+
+    ModBeeUartStats _stats;
+
+    // =============================================================================
+    // INTERNAL HELPERS
+    // =============================================================================
+    static void rxTaskEntry(void* arg);
+    void rxTask();
+    void discardInput();
+    void consumed(size_t count);
+    void retireMarks();
+};
+
+#endif // ESP32
@@ -331,7 +331,8 @@ bool ModbusFrame::parseModbusResponse(const uint8_t* buffer, uint16_t length, Mo
     // Handle error responses
     if (response.function & 0x80) {
         if (length < 2) return false;
-        response.data.push_back(buffer[pos++]);
+        // The exception code is the last byte: ours repeat the function code before it
+        response.data.push_back(buffer[length - 1]);
         return true;
     }
     
@@ -387,21 +388,7 @@ uint16_t ModbusFrame::calculateCRC16(const uint8_t* buffer, uint16_t length) {
         return 0;
     }
     
-    uint16_t crc = 0xFFFF;
-    
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= buffer[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc >>= 1;
-                crc ^= 0xA001;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    
-    return crc;
+    return ModBeeCRC::calculate(buffer, length);
 }
 
 // =============================================================================
@@ -508,6 +495,56 @@ uint16_t ModbusFrame::estimateResponseSize(const ModbusRequest& request) {
     return size;
 }
 
+uint16_t ModbusFrame::getRequestLength(const PendingModbusOp& op) {
+    // Exact number of bytes buildModbusRequest() writes for this operation
+    const ModbusRequest& request = op.req;
+    bool directArray = op.resultPtr && op.isArray;
+    
+    switch (request.function) {
+        case MB_FC_READ_COILS:
+        case MB_FC_READ_DISCRETE_INPUTS:
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_READ_INPUT_REGISTERS:
+        case MB_FC_WRITE_SINGLE_COIL:
+        case MB_FC_WRITE_SINGLE_REGISTER:
+            return 5; // Function + address + quantity/value
+            
+        case MB_FC_WRITE_MULTIPLE_COILS:
+            return 5 + (directArray ? 1 + getBitPackedBytes(request.quantity) : request.data.size());
+            
+        case MB_FC_WRITE_MULTIPLE_REGISTERS:
+            return 5 + (directArray ? 1 + request.quantity * 2 : request.data.size());
+            
+        default:
+            return 0; // Not buildable
+    }
+}
+
+uint16_t ModbusFrame::getResponseLength(const ModbusRequest& response) {
+    // Exact number of bytes buildModbusResponse() writes for this response
+    switch (response.function) {
+        case MB_FC_READ_COILS:
+        case MB_FC_READ_DISCRETE_INPUTS:
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_READ_INPUT_REGISTERS: {
+            if (response.data.empty()) {
+                return 0;
+            }
+            uint16_t byteCount = std::min((uint16_t)response.data[0], (uint16_t)(response.data.size() - 1));
+            return 4 + byteCount; // Function + address + byte count + data
+        }
+            
+        case MB_FC_WRITE_SINGLE_COIL:
+        case MB_FC_WRITE_SINGLE_REGISTER:
+        case MB_FC_WRITE_MULTIPLE_COILS:
+        case MB_FC_WRITE_MULTIPLE_REGISTERS:
+            return 0; // Writes are not answered
+            
+        default:
+            return 3; // Function + error function + exception code
+    }
+}
+
 // =============================================================================
 // FUNCTION CODE UTILITIES
 // =============================================================================
@@ -565,6 +602,23 @@ uint8_t ModbusFrame::getBaseFunctionCode(uint8_t functionCode) {
     return functionCode & 0x7F;
 }
 
+ModBeeRegisterType ModbusFrame::getRegisterType(uint8_t functionCode) {
+    switch (functionCode & 0x7F) {
+        case MB_FC_READ_COILS:
+        case MB_FC_WRITE_SINGLE_COIL:
+        case MB_FC_WRITE_MULTIPLE_COILS:
+            return MB_OUTPUT_COIL;
+        case MB_FC_READ_DISCRETE_INPUTS:
+            return MB_INPUT_STATUS;
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_WRITE_SINGLE_REGISTER:
+        case MB_FC_WRITE_MULTIPLE_REGISTERS:
+            return MB_HOLDING_REGISTER;
+        default:
+            return MB_INPUT_REGISTER;
+    }
+}
+
 // =============================================================================
 // VALIDATION
 // =============================================================================
@@ -629,23 +683,107 @@ void ModbusFrame::debugPrintResponse(const ModbusRequest& response) {
 // REQUEST OPTIMIZATION
 // =============================================================================
 bool ModbusFrame::canCombineRequests(const ModbusRequest& req1, const ModbusRequest& req2) {
-    // Check if requests can be combined (same function, contiguous addresses)
+    // Check if requests can be combined (same read function, overlapping or contiguous addresses)
     if (req1.function != req2.function) return false;
     if (!isReadFunction(req1.function)) return false;
     
-    uint16_t end1 = req1.startAddr + req1.quantity;
-    uint16_t start2 = req2.startAddr;
+    uint32_t end1 = (uint32_t)req1.startAddr + req1.quantity;
+    uint32_t end2 = (uint32_t)req2.startAddr + req2.quantity;
+    if (req2.startAddr > end1 || req1.startAddr > end2) {
+        return false;
+    }
     
-    return end1 == start2;
+    // The combined read must still be one valid Modbus request
+    return validateRequest(combineRequests(req1, req2));
 }
 
 ModbusRequest ModbusFrame::combineRequests(const ModbusRequest& req1, const ModbusRequest& req2) {
     ModbusRequest combined = req1;
-    combined.quantity = req1.quantity + req2.quantity;
+    uint32_t end = std::max((uint32_t)req1.startAddr + req1.quantity, (uint32_t)req2.startAddr + req2.quantity);
+    combined.startAddr = std::min(req1.startAddr, req2.startAddr);
+    combined.quantity = std::min<uint32_t>(end - combined.startAddr, UINT16_MAX);
     return combined;
 }
 
+bool ModbusFrame::mergeWriteRequest(ModbusRequest& target, const ModbusRequest& write) {
+    bool coils = (target.function == MB_FC_WRITE_SINGLE_COIL || target.function == MB_FC_WRITE_MULTIPLE_COILS);
+    bool registers = (target.function == MB_FC_WRITE_SINGLE_REGISTER || target.function == MB_FC_WRITE_MULTIPLE_REGISTERS);
+    if ((!coils && !registers) || getRegisterType(write.function) != getRegisterType(target.function) ||
+        !validateRequest(target) || !validateRequest(write)) {
+        return false;
+    }
+    
+    // The same write again simply replaces the values
+    if (write.function == target.function && write.startAddr == target.startAddr && write.quantity == target.quantity) {
+        target.data = write.data;
+        return true;
+    }
+    
+    // Otherwise only a multiple write covering the later one can take its values
+    bool single = (write.function == MB_FC_WRITE_SINGLE_COIL || write.function == MB_FC_WRITE_SINGLE_REGISTER);
+    uint16_t quantity = single ? 1 : write.quantity;
+    uint32_t offset = write.startAddr - target.startAddr;
+    if ((target.function != MB_FC_WRITE_MULTIPLE_COILS && target.function != MB_FC_WRITE_MULTIPLE_REGISTERS) ||
+        write.startAddr < target.startAddr || offset + quantity > target.quantity) {
+        return false;
+    }
+    
+    // Packed layouts: single [VALUE], multiple [BYTE COUNT] [VALUES]
+    const uint8_t* values = &write.data[single ? 0 : 1];
+    if (registers) {
+        if (target.data.size() < 1 + (offset + quantity) * 2 || write.data.size() < (single ? 0 : 1) + quantity * 2U) {
+            return false;
+        }
+        memcpy(&target.data[1 + offset * 2], values, quantity * 2);
+        return true;
+    }
+    
+    if (target.data.size() < 1U + getBitPackedBytes(offset + quantity) ||
+        (!single && write.data.size() < 1U + getBitPackedBytes(quantity))) {
+        return false;
+    }
+    for (uint16_t i = 0; i < quantity; i++) {
+        bool value = single ? (values[0] == 0xFF) : ((values[i >> 3] >> (i & 7)) & 0x01);
+        uint32_t bit = offset + i;
+        if (value) {
+            target.data[1 + (bit >> 3)] |= (1 << (bit & 7));
+        } else {
+            target.data[1 + (bit >> 3)] &= ~(1 << (bit & 7));
+        }
+    }
+    return true;
+}
+
 std::vector<ModbusRequest> ModbusFrame::optimizeRequests(const std::vector<ModbusRequest>& requests) {
-    // Simple optimization - could be enhanced
-    return requests;
-}
\ No newline at end of file
+    std::vector<ModbusRequest> optimized;
+    optimized.reserve(requests.size());
+    
+    for (const auto& request : requests) {
+        bool read = isReadFunction(request.function);
+        uint32_t end = (uint32_t)request.startAddr + std::max<uint16_t>(request.quantity, 1);
+        
+        // Look back for the last request this one may fold into. Nothing may move
+        // past a write to the same registers: a read would see the wrong value,
+        // and a write would be overwritten by the older one
+        bool merged = false;
+        for (auto it = optimized.rbegin(); it != optimized.rend(); ++it) {
+            if (getRegisterType(it->function) != getRegisterType(request.function)) {
+                continue;
+            }
+            bool overlaps = it->startAddr < end && request.startAddr < (uint32_t)it->startAddr + it->quantity;
+            if (read && isReadFunction(it->function) && canCombineRequests(*it, request)) {
+                *it = combineRequests(*it, request);
+                merged = true;
+                break;
+            }
+            if (overlaps) {
+                merged = !read && isWriteFunction(it->function) && mergeWriteRequest(*it, request);
+                break;
+            }
+        }
+        if (!merged) {
+            optimized.push_back(request);
+        }
+    }
+    return optimized;
+}
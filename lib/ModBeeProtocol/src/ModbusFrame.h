@@ -30,6 +30,7 @@ public:
     static bool isErrorResponse(uint8_t functionCode);
     static uint8_t makeErrorResponse(uint8_t functionCode);
     static uint8_t getBaseFunctionCode(uint8_t functionCode);
+    static ModBeeRegisterType getRegisterType(uint8_t functionCode);
     
     // =============================================================================
     // REQUEST/RESPONSE VALIDATION
@@ -42,6 +43,8 @@ public:
     // =============================================================================
     static uint16_t estimateRequestSize(const ModbusRequest& request);
     static uint16_t estimateResponseSize(const ModbusRequest& request);
+    static uint16_t getRequestLength(const PendingModbusOp& op);
+    static uint16_t getResponseLength(const ModbusRequest& response);
     
     // =============================================================================
     // BIT MANIPULATION - NOW PUBLIC
@@ -51,10 +54,14 @@ public:
     static uint8_t getBitPackedBytes(uint16_t quantity);
     
     // =============================================================================
-    // REQUEST OPTIMIZATION - ADD THESE MISSING METHODS
+    // REQUEST OPTIMIZATION
     // =============================================================================
+    // Reads of one function whose ranges overlap or touch, still within Modbus limits
     static bool canCombineRequests(const ModbusRequest& req1, const ModbusRequest& req2);
     static ModbusRequest combineRequests(const ModbusRequest& req1, const ModbusRequest& req2);
+    // Last writer wins: copies a later write's packed values into an earlier one covering it
+    static bool mergeWriteRequest(ModbusRequest& target, const ModbusRequest& write);
+    // Requests to one node in send order: reads combined, same-register writes folded
     static std::vector<ModbusRequest> optimizeRequests(const std::vector<ModbusRequest>& requests);
     
     // =============================================================================
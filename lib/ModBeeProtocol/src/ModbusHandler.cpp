@@ -383,6 +383,26 @@ bool ModbusHandler::processResponse(ModBeeProtocol& protocol, const ModbusReques
     }
 }
 
+// =============================================================================
+// RESPONSE PROCESSING FOR READ OPERATIONS
+// =============================================================================
+
+bool ModbusHandler::processReadCoilsResponse(ModBeeProtocol& protocol, const ModbusRequest& response, uint8_t srcNodeID) {
+    return protocol.getOperations().matchAndFulfillResponse(response, srcNodeID);
+}
+
+bool ModbusHandler::processReadDiscreteInputsResponse(ModBeeProtocol& protocol, const ModbusRequest& response, uint8_t srcNodeID) {
+    return protocol.getOperations().matchAndFulfillResponse(response, srcNodeID);
+}
+
+bool ModbusHandler::processReadHoldingRegistersResponse(ModBeeProtocol& protocol, const ModbusRequest& response, uint8_t srcNodeID) {
+    return protocol.getOperations().matchAndFulfillResponse(response, srcNodeID);
+}
+
+bool ModbusHandler::processReadInputRegistersResponse(ModBeeProtocol& protocol, const ModbusRequest& response, uint8_t srcNodeID) {
+    return protocol.getOperations().matchAndFulfillResponse(response, srcNodeID);
+}
+
 bool ModbusHandler::matchesRequest(const ModbusRequest& request, const ModbusRequest& response) {
     uint8_t baseFunction = ModbusFrame::getBaseFunctionCode(response.function);
     
@@ -427,6 +447,35 @@ uint8_t ModbusHandler::getExceptionCode(const ModbusRequest& request) {
     return MB_EX_SLAVE_DEVICE_FAILURE;
 }
 
+// =============================================================================
+// VALIDATION
+// =============================================================================
+
+bool ModbusHandler::validateAddress(uint8_t function, uint16_t address, uint16_t quantity) {
+    return _dataMap.validateAddressRange(function, address, quantity);
+}
+
+bool ModbusHandler::validateQuantity(uint8_t function, uint16_t quantity) {
+    // Modbus application protocol limits per request
+    switch (function) {
+        case MB_FC_READ_COILS:
+        case MB_FC_READ_DISCRETE_INPUTS:
+            return quantity >= 1 && quantity <= 2000;
+        case MB_FC_READ_HOLDING_REGISTERS:
+        case MB_FC_READ_INPUT_REGISTERS:
+            return quantity >= 1 && quantity <= 125;
+        case MB_FC_WRITE_SINGLE_COIL:
+        case MB_FC_WRITE_SINGLE_REGISTER:
+            return true;
+        case MB_FC_WRITE_MULTIPLE_COILS:
+            return quantity >= 1 && quantity <= 1968;
+        case MB_FC_WRITE_MULTIPLE_REGISTERS:
+            return quantity >= 1 && quantity <= 123;
+        default:
+            return false;
+    }
+}
+
 // =============================================================================
 // DEBUG AND UTILITY METHODS
 // =============================================================================
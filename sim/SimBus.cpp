@@ -0,0 +1,218 @@
+#include "SimBus.h"
+
+// =============================================================================
+// BUS
+// =============================================================================
+SimBus::SimBus(uint32_t baudRate, uint8_t bitsPerByte)
+    : _baudRate(baudRate),
+      _byteTimeUs(bitsPerByte * 1000000.0 / baudRate),
+      _busyUntilUs(0),
+      _noise(0x9E3779B9),
+      _monitor(nullptr),
+      _monitorContext(nullptr) {
+}
+
+void SimBus::attach(SimBusTransport* endpoint) {
+    if (std::find(_endpoints.begin(), _endpoints.end(), endpoint) == _endpoints.end()) {
+        _endpoints.push_back(endpoint);
+    }
+}
+
+void SimBus::detach(SimBusTransport* endpoint) {
+    _endpoints.erase(std::remove(_endpoints.begin(), _endpoints.end(), endpoint), _endpoints.end());
+
+    // A node that loses power stops driving the line mid-frame
+    for (auto& tx : _transmissions) {
+        if (tx.sender == endpoint) {
+            tx.bytes.resize(tx.delivered);
+            tx.endUs = tx.delivered == 0 ? tx.startUs : byteEndUs(tx, tx.delivered - 1);
+            tx.sender = nullptr;
+        }
+    }
+}
+
+void SimBus::setMonitor(Monitor monitor, void* context) {
+    _monitor = monitor;
+    _monitorContext = context;
+}
+
+size_t SimBus::transmit(SimBusTransport* sender, const uint8_t* buffer, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    uint64_t now = VirtualClock::nowUs();
+
+    Transmission tx;
+    tx.sender = sender;
+    tx.bytes.assign(buffer, buffer + size);
+    tx.startUs = std::max(now, sender->getTxBusyUntilUs());
+    tx.endUs = byteEndUs(tx, size - 1);
+    tx.delivered = 0;
+    tx.collided = false;
+
+    // Mark both sides of any overlap
+    for (auto& other : _transmissions) {
+        if (other.startUs < tx.endUs && tx.startUs < other.endUs) {
+            if (!other.collided) {
+                _stats.collisions++;
+            }
+            other.collided = true;
+            if (!tx.collided) {
+                _stats.collisions++;
+            }
+            tx.collided = true;
+        }
+    }
+
+    // Bit-time accounting: count each microsecond the line is driven once
+    uint64_t busyFrom = std::max(tx.startUs, _busyUntilUs);
+    if (tx.endUs > busyFrom) {
+        _stats.busyUs += tx.endUs - busyFrom;
+    }
+    _busyUntilUs = std::max(_busyUntilUs, tx.endUs);
+
+    sender->setTxBusyUntilUs(tx.endUs);
+    _stats.transmissions++;
+    _stats.bytesSent += size;
+
+    _transmissions.push_back(std::move(tx));
+    return size;
+}
+
+void SimBus::advance() {
+    uint64_t now = VirtualClock::nowUs();
+
+    for (auto& tx : _transmissions) {
+        while (tx.delivered < tx.bytes.size()) {
+            uint64_t endUs = byteEndUs(tx, tx.delivered);
+            if (endUs > now) {
+                break;
+            }
+
+            uint8_t byte = tx.bytes[tx.delivered];
+            uint64_t startUs = endUs - (uint64_t)_byteTimeUs;
+            if (tx.collided && overlapsOthers(tx, startUs, endUs)) {
+                byte ^= nextNoise();
+                tx.bytes[tx.delivered] = byte;
+                _stats.bytesCorrupted++;
+            }
+
+            for (SimBusTransport* endpoint : _endpoints) {
+                if (endpoint != tx.sender) {
+                    endpoint->receive(byte);
+                }
+            }
+            tx.delivered++;
+        }
+    }
+
+    // Retire finished transmissions once nothing can overlap them any more
+    while (!_transmissions.empty()) {
+        const Transmission& tx = _transmissions.front();
+        if (tx.delivered < tx.bytes.size() || tx.endUs > now) {
+            break;
+        }
+        bool overlapPending = false;
+        for (size_t i = 1; i < _transmissions.size(); i++) {
+            if (_transmissions[i].startUs < tx.endUs && _transmissions[i].delivered < _transmissions[i].bytes.size()) {
+                overlapPending = true;
+                break;
+            }
+        }
+        if (overlapPending) {
+            break;
+        }
+
+        if (_monitor) {
+            _monitor(_monitorContext, tx.sender, tx.bytes.data(), tx.bytes.size(), tx.startUs, tx.endUs, tx.collided);
+        }
+        _transmissions.pop_front();
+    }
+}
+
+uint64_t SimBus::byteEndUs(const Transmission& tx, size_t index) const {
+    return tx.startUs + (uint64_t)((index + 1) * _byteTimeUs);
+}
+
+uint8_t SimBus::nextNoise() {
+    // xorshift32, never zero: a corrupted byte always differs from the one sent
+    _noise ^= _noise << 13;
+    _noise ^= _noise >> 17;
+    _noise ^= _noise << 5;
+    return (uint8_t)(_noise % 255 + 1);
+}
+
+bool SimBus::overlapsOthers(const Transmission& tx, uint64_t fromUs, uint64_t toUs) const {
+    for (const auto& other : _transmissions) {
+        if (&other != &tx && other.startUs < toUs && fromUs < other.endUs) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// =============================================================================
+// TRANSPORT
+// =============================================================================
+SimBusTransport::SimBusTransport(SimBus& bus, uint8_t nodeID)
+    : _bus(bus), _nodeID(nodeID), _attached(false), _txBusyUntilUs(0), _lastRxUs(0), _rxSeen(false) {
+}
+
+SimBusTransport::~SimBusTransport() {
+    end();
+}
+
+bool SimBusTransport::begin() {
+    if (!_attached) {
+        _bus.attach(this);
+        _attached = true;
+    }
+    return true;
+}
+
+void SimBusTransport::end() {
+    if (_attached) {
+        _bus.detach(this);
+        _attached = false;
+        _rx.clear();
+    }
+}
+
+int SimBusTransport::read() {
+    if (_rx.empty()) {
+        return -1;
+    }
+    uint8_t byte = _rx.front();
+    _rx.pop_front();
+    return byte;
+}
+
+size_t SimBusTransport::read(uint8_t* buffer, size_t length) {
+    size_t count = std::min(length, _rx.size());
+    std::copy(_rx.begin(), _rx.begin() + count, buffer);
+    _rx.erase(_rx.begin(), _rx.begin() + count);
+    return count;
+}
+
+size_t SimBusTransport::write(const uint8_t* buffer, size_t size) {
+    if (!_attached) {
+        return 0;
+    }
+    return _bus.transmit(this, buffer, size);
+}
+
+void SimBusTransport::receive(uint8_t byte) {
+    _rx.push_back(byte);
+    _lastRxUs = VirtualClock::nowUs();
+    _rxSeen = true;
+}
+
+bool SimBusTransport::getLastRxIdleUs(uint32_t& timestampUs) {
+    // Like a UART idle interrupt: only once everything received has been read
+    if (!_rxSeen || !_rx.empty()) {
+        return false;
+    }
+    timestampUs = (uint32_t)VirtualClock::toLocalUs(_lastRxUs);
+    return true;
+}
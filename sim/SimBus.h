@@ -0,0 +1,112 @@
+#pragma once
+#include "ModBeeGlobal.h"
+#include "VirtualClock.h"
+#include <deque>
+
+class SimBusTransport;
+
+// =============================================================================
+// STATISTICS STRUCTURE
+// =============================================================================
+struct SimBusStats {
+    uint32_t transmissions = 0;
+    uint64_t bytesSent = 0;
+    uint64_t bytesCorrupted = 0;        // Bytes that overlapped another transmission
+    uint32_t collisions = 0;            // Transmissions that overlapped another one
+    uint64_t busyUs = 0;                // Time at least one driver was active
+};
+
+/**
+ * Simulated RS485 half-duplex bus
+ * Every write is serialised at the configured baud rate: byte k of a
+ * transmission reaches the other nodes (bitsPerByte * (k + 1)) bit times after
+ * it started. A node's writes queue behind its own previous ones, like a UART
+ * TX buffer. Bytes sent while another node is driving the line are corrupted
+ * for every receiver with pseudo-random bit errors, so identical frames that
+ * collide do not garble into a frame that passes CRC. Nodes never hear their own transmissions.
+ */
+class SimBus {
+public:
+    // Called once per transmission after its last byte has been delivered
+    typedef void (*Monitor)(void* context, const SimBusTransport* sender, const uint8_t* wire,
+                            size_t length, uint64_t startUs, uint64_t endUs, bool collided);
+
+    SimBus(uint32_t baudRate, uint8_t bitsPerByte = 10);
+
+    void attach(SimBusTransport* endpoint);
+    void detach(SimBusTransport* endpoint);
+    void setMonitor(Monitor monitor, void* context);
+
+    // Called by SimBusTransport::write()
+    size_t transmit(SimBusTransport* sender, const uint8_t* buffer, size_t size);
+
+    // Deliver every byte that has finished by the current virtual time
+    void advance();
+
+    uint32_t getBaudRate() const { return _baudRate; }
+    double getByteTimeUs() const { return _byteTimeUs; }
+    bool isIdle() const { return _transmissions.empty(); }
+    const SimBusStats& getStatistics() const { return _stats; }
+
+private:
+    struct Transmission {
+        SimBusTransport* sender;
+        std::vector<uint8_t> bytes;
+        uint64_t startUs;
+        uint64_t endUs;
+        size_t delivered;
+        bool collided;
+    };
+
+    uint32_t _baudRate;
+    double _byteTimeUs;
+    std::vector<SimBusTransport*> _endpoints;
+    std::deque<Transmission> _transmissions;
+    uint64_t _busyUntilUs;
+    uint32_t _noise;                    // Corruption pattern, independent of the nodes' random()
+    Monitor _monitor;
+    void* _monitorContext;
+    SimBusStats _stats;
+
+    uint64_t byteEndUs(const Transmission& tx, size_t index) const;
+    uint8_t nextNoise();
+    bool overlapsOthers(const Transmission& tx, uint64_t fromUs, uint64_t toUs) const;
+};
+
+/**
+ * One simulated node's RS485 transceiver
+ */
+class SimBusTransport : public ModBeeTransport {
+public:
+    SimBusTransport(SimBus& bus, uint8_t nodeID);
+    ~SimBusTransport();
+
+    bool begin() override;
+    void end();
+
+    int available() override { return (int)_rx.size(); }
+    int read() override;
+    size_t read(uint8_t* buffer, size_t length) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    size_t write(uint8_t data) override { return write(&data, 1); }
+    void flush() override {}
+    bool isConnected() const override { return _attached; }
+    uint32_t getBaudRate() const override { return _bus.getBaudRate(); }
+    bool getLastRxIdleUs(uint32_t& timestampUs) override;
+
+    uint8_t getNodeID() const { return _nodeID; }
+    uint64_t getTxBusyUntilUs() const { return _txBusyUntilUs; }
+    void setTxBusyUntilUs(uint64_t us) { _txBusyUntilUs = us; }
+
+    // Called by the bus
+    void receive(uint8_t byte);
+
+private:
+    SimBus& _bus;
+    uint8_t _nodeID;
+    bool _attached;
+    std::deque<uint8_t> _rx;
+    uint64_t _txBusyUntilUs;
+    uint64_t _lastRxUs;
+    bool _rxSeen;
+};
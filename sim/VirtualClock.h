@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * Simulated time shared by every node in the process
+ * Only the simulator advances it; millis()/micros() read it through the local
+ * clock selected for the node that is running: a boot offset plus a crystal
+ * error in ppm, so nodes disagree on the time like real boards do. Local clocks
+ * start WRAP_LEAD_US before both millis() and micros() wrap at 32 bits, as on
+ * a board that has been up 49.7 days, so every run crosses the wrap.
+ */
+class VirtualClock {
+public:
+    static uint64_t nowUs() { return _nowUs; }
+    static void advanceTo(uint64_t us) { if (us > _nowUs) _nowUs = us; }
+    static void reset() { _nowUs = 0; useGlobal(); }
+
+    // Local clock of the node about to run
+    static void setLocalClock(uint64_t offsetUs, double driftPpm) { _offsetUs = offsetUs; _driftPpm = driftPpm; }
+    static void useGlobal() { setLocalClock(0, 0.0); }
+    static uint64_t localUs() { return toLocalUs(_nowUs); }
+    static uint64_t toLocalUs(uint64_t globalUs) {
+        return LOCAL_EPOCH_US + globalUs + _offsetUs + (int64_t)((double)globalUs * _driftPpm * 1e-6);
+    }
+
+    // 2^32 ms is also a multiple of 2^32 us, so both counters wrap together
+    static constexpr uint64_t WRAP_LEAD_US = 4000000;
+    static constexpr uint64_t LOCAL_EPOCH_US = (1ULL << 32) * 1000 - WRAP_LEAD_US;
+
+private:
+    static uint64_t _nowUs;
+    static uint64_t _offsetUs;
+    static double _driftPpm;
+};
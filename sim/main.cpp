@@ -0,0 +1,761 @@
+/**
+ * ModBee multi-node ring simulator and benchmark.
+ *
+ * Runs 2-250 ModBeeAPI instances in one process on a simulated RS485 bus
+ * (SimBus) driven by a virtual clock. Each scenario:
+ *   1. starts every node and measures the time until all nodes are connected
+ *      and know each other (network formation),
+ *   2. lets every node write a sequence number into its ring successor's
+ *      holding registers every --period ms and measures write latency
+ *      (issue -> value visible in the target's data map) and ops/s per node.
+ *      With --poll the successor reads the value from the writer's published
+ *      register each period instead, with --pubsub it subscribes to it.
+ *      --poll-regs N adds N of the writer's bulk registers to each poll, read one
+ *      register per call the way sketches often do, so queued reads get merged,
+ *      and --async issues the polls through readHregAsync() and counts how each
+ *      request ended. --poll-table puts the same reads in the polling table at
+ *      the write period instead of issuing them by hand.
+ *   3. watches the bus for token hand-overs to node 1 (token rotation time),
+ *   4. kills the highest node half way through and measures the recovery time
+ *      until every survivor has dropped it and node 1 holds the token again.
+ *      With --kill-pair its ring predecessor dies with it, right after handing
+ *      it the token, so the token is lost and has to be reclaimed; reclaim_ms is
+ *      the time until a survivor passes on a token it was given again.
+ *   5. with --sync, node 1 also sets one output register on every node each
+ *      period, one write per node or (--broadcast) a single multicast write;
+ *      sync_skew is the spread between the first and last node seeing a value.
+ *      With --at the writes are scheduled that far ahead on the network time.
+ *   6. compares every node's network time with node 1's (the time master) each
+ *      millisecond from 1 s after formation on; --clock-skew gives the nodes
+ *      different boot times and crystal errors so there is something to correct.
+ *
+ * One CSV row per scenario is appended to --csv, labelled with --label
+ * (e.g. the commit hash) so regressions show up per commit.
+ *
+ * Build and run (PlatformIO):
+ *   pio run -e native_sim
+ *   .pio/build/native_sim/program --nodes 2,10,50 --csv sim.csv --label $(git rev-parse --short HEAD)
+ */
+
+#include "ModBeeGlobal.h"
+#include "SimBus.h"
+#include <chrono>
+#include <deque>
+#include <string>
+
+#define SIM_MAX_NODES 250               // Node IDs 1-250
+#define SIM_BULK_REGS 60                // Registers per bulk write (--chatty)
+#define SIM_BULK_BASE 1000              // First bulk register address
+#define SIM_SYNC_REG 2000               // Output register node 1 sets on every node (--sync)
+#define SIM_PUB_REG 2001                // Register each node keeps its sequence in (--poll, --pubsub)
+
+// =============================================================================
+// CONFIGURATION
+// =============================================================================
+struct SimConfig {
+    std::vector<int> nodeCounts = {2, 10, 50};
+    uint32_t baudRate = 115200;
+    uint32_t stepUs = 50;               // Virtual time between loop() passes
+    uint32_t formTimeoutS = 300;
+    uint32_t durationS = 20;            // Measurement time after formation
+    uint32_t writePeriodMs = 100;
+    bool killNode = true;
+    bool killPair = false;              // Kill the predecessor too, just after it passed the victim the token
+    bool compactSections = false;
+    bool shortTokens = false;
+    uint8_t idleSkipRotations = 0;      // Rotations an idle node's turn may be skipped
+    uint32_t ttrtUs = 0;                // Target token rotation, cyclic writes go out high priority
+    uint32_t chattyOps = 0;             // Extra low-priority bulk writes node 1 queues each period
+    bool syncOutputs = false;           // Node 1 sets SIM_SYNC_REG on every node each period
+    bool broadcast = false;             // ... as one multicast write instead of one per node
+    uint32_t applyLeadMs = 0;           // ... applied this far ahead on the network time, 0 = on arrival
+    double clockSkewPpm = 0;            // Crystal error range of the nodes' local clocks
+    bool clockSkew = false;             // Nodes boot at different times with drifting clocks
+    bool poll = false;                  // Successors read SIM_PUB_REG each period instead of being written to
+    bool pubsub = false;                // ... or subscribe to it
+    uint32_t pollRegs = 0;              // Bulk registers each poll also reads, one call per register
+    bool async = false;                 // Polls go through readHregAsync() with a completion callback
+    bool pollTable = false;             // ... or are polling table points with the write period
+    uint8_t joinSlots = 0;              // Slots per join window, 0 = one invitation per node
+    int maxNodes = 0;                   // MODBEE_MAX_NODES, 0 = the node count
+    uint32_t seed = 1;
+    std::string csvPath;
+    std::string label = "local";
+};
+
+// =============================================================================
+// SIMULATED NODE
+// =============================================================================
+struct PendingWrite {
+    int16_t sequence;
+    uint64_t issuedUs;
+};
+
+struct SimNode {
+    uint8_t id;
+    SimBusTransport* transport;
+    ModBeeAPI* api;
+    bool alive;
+    uint64_t clockOffsetUs;             // Local clock: boot offset and crystal error
+    double clockDriftPpm;
+
+    int16_t inbox[SIM_MAX_NODES + 1];    // inbox[sender] = last sequence written by sender
+    int16_t bulk[SIM_BULK_REGS];
+    int16_t polled[SIM_BULK_REGS];      // Bulk registers read from the producer (--poll-regs)
+    int16_t syncOutput;
+    int16_t published;
+    uint8_t target;
+    int16_t nextSequence;
+    uint64_t nextWriteUs;
+    std::deque<PendingWrite> inFlight;
+    uint32_t completed;
+    uint32_t lost;
+};
+
+// =============================================================================
+// BUS MONITOR (token rotation)
+// =============================================================================
+struct TokenWatch {
+    uint8_t watchedNode = 1;
+    bool usedSinceHandover = true;      // Watched node transmitted since the last hand-over
+    uint64_t lastHandoverUs = 0;
+    std::vector<double> rotationsMs;
+    uint64_t handoverCount = 0;
+    uint8_t lastTokenFrom = 0;          // Latest frame that passed the token
+    uint8_t lastTokenTo = 0;
+    uint64_t acceptedCount = 0;         // Token passes sent by the node the previous pass went to
+    uint64_t lastAcceptedUs = 0;
+
+    ModBeeFrameParser parser;
+    uint8_t frame[MODBEE_MAX_RX_BUFFER];
+    uint32_t framesSeen = 0;
+    uint32_t badFrames = 0;
+};
+
+static void monitorTransmission(void* context, const SimBusTransport* /*sender*/, const uint8_t* wire,
+                                size_t length, uint64_t startUs, uint64_t endUs, bool /*collided*/) {
+    TokenWatch& watch = *static_cast<TokenWatch*>(context);
+
+    for (size_t i = 0; i < length; i++) {
+        ModBeeFrameParser::Result result = watch.parser.feed(wire[i]);
+        if (result == ModBeeFrameParser::RX_CRC_ERROR || result == ModBeeFrameParser::RX_FRAMING_ERROR) {
+            watch.badFrames++;
+        }
+        if (result != ModBeeFrameParser::RX_FRAME_COMPLETE) {
+            continue;
+        }
+
+        watch.framesSeen++;
+        const uint8_t* buffer = watch.parser.getFrame();
+        uint16_t frameLen = watch.parser.getFrameLength();
+        uint8_t src = ModBeeFrame::getSourceNodeID(buffer, frameLen);
+        uint8_t next = ModBeeFrame::getNextMasterID(buffer, frameLen);
+
+        if (next != 0 && next != src) {
+            if (src == watch.lastTokenTo) {
+                watch.acceptedCount++;
+                watch.lastAcceptedUs = startUs;
+            }
+            watch.lastTokenFrom = src;
+            watch.lastTokenTo = next;
+        }
+
+        if (src == watch.watchedNode) {
+            watch.usedSinceHandover = true;
+        } else if (next == watch.watchedNode && watch.usedSinceHandover) {
+            // Retransmitted tokens are ignored until the watched node has used the token
+            if (watch.handoverCount > 0) {
+                watch.rotationsMs.push_back((endUs - watch.lastHandoverUs) / 1000.0);
+            }
+            watch.lastHandoverUs = endUs;
+            watch.handoverCount++;
+            watch.usedSinceHandover = false;
+        }
+    }
+}
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+static double mean(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return sum / values.size();
+}
+
+static void useClock(const SimNode& node) {
+    VirtualClock::setLocalClock(node.clockOffsetUs, node.clockDriftPpm);
+}
+
+static bool networkFormed(const std::vector<SimNode>& nodes) {
+    for (const SimNode& node : nodes) {
+        if (!node.alive) {
+            continue;
+        }
+        if (!node.api->isConnected()) {
+            return false;
+        }
+        for (const SimNode& other : nodes) {
+            if (other.alive && !node.api->isNodeKnown(other.id)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool nodeForgotten(const std::vector<SimNode>& nodes, uint8_t deadID) {
+    for (const SimNode& node : nodes) {
+        if (node.alive && node.api->isNodeKnown(deadID)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// SCENARIO
+// =============================================================================
+struct SimResult {
+    int nodes = 0;
+    double formMs = -1;
+    double rotationMeanMs = 0;
+    double rotationP99Ms = 0;
+    double opsPerNodeMean = 0;
+    double opsPerNodeMin = 0;
+    double latencyP50Ms = 0;
+    double latencyP99Ms = 0;
+    uint64_t opsIssued = 0;
+    uint64_t opsCompleted = 0;
+    uint64_t opsLost = 0;
+    double recoveryMs = -1;
+    double reclaimMs = -1;              // Kill to the token circulating among the survivors again
+    uint32_t collisions = 0;
+    double busUtilisation = 0;
+    double txGapMeanUs = 0;             // Idle time seen before each transmission
+    double holdMaxMs = 0;               // Longest token hold of any node
+    uint32_t lateTokens = 0;
+    double syncSkewP50Ms = 0;           // First to last node seeing a --sync value
+    double syncSkewP99Ms = 0;
+    double timeErrorP50Us = 0;          // |network time - node 1's network time| over all synced nodes
+    double timeErrorP99Us = 0;
+    uint32_t mergedOps = 0;             // Reads and writes folded into another queued one
+    uint32_t mergeBytesSaved = 0;
+    uint32_t asyncDone = 0;             // --async requests answered
+    uint32_t asyncFailed = 0;           // ... ended by an exception, timeout or cancellation
+    uint32_t polls = 0;                 // --poll-table reads queued
+    uint32_t pollFailures = 0;          // ... not queued or not answered
+    double simSeconds = 0;
+    double wallSeconds = 0;
+};
+
+static SimResult runScenario(const SimConfig& config, int nodeCount) {
+    auto wallStart = std::chrono::steady_clock::now();
+    SimResult result;
+    result.nodes = nodeCount;
+
+    VirtualClock::reset();
+    randomSeed(config.seed);
+    ModBeeAPI::MODBEE_MAX_NODES = config.maxNodes > 0 ? std::max(config.maxNodes, nodeCount) : nodeCount;
+    ModBeeAPI::MODBEE_COMPACT_SECTIONS = config.compactSections;
+    ModBeeAPI::MODBEE_SHORT_TOKENS = config.shortTokens;
+    ModBeeAPI::MODBEE_IDLE_SKIP_ROTATIONS = config.idleSkipRotations;
+    ModBeeAPI::MODBEE_TARGET_ROTATION_US = config.ttrtUs;
+    ModBeeAPI::MODBEE_JOIN_SLOTS = config.joinSlots;
+
+    SimBus bus(config.baudRate);
+    TokenWatch watch;
+    watch.parser.attach(watch.frame, sizeof(watch.frame));
+    bus.setMonitor(monitorTransmission, &watch);
+
+    std::vector<SimNode> nodes(nodeCount);
+    for (int i = 0; i < nodeCount; i++) {
+        SimNode& node = nodes[i];
+        node.id = (uint8_t)(i + 1);
+        node.transport = new SimBusTransport(bus, node.id);
+        node.api = new ModBeeAPI();
+        node.alive = true;
+        node.target = (uint8_t)((i + 1) % nodeCount + 1);
+        node.nextSequence = 1;
+        node.nextWriteUs = 0;
+        node.completed = 0;
+        node.lost = 0;
+        memset(node.inbox, 0, sizeof(node.inbox));
+        memset(node.bulk, 0, sizeof(node.bulk));
+        memset(node.polled, 0, sizeof(node.polled));
+        node.syncOutput = 0;
+        node.published = 0;
+        node.clockOffsetUs = 0;
+        node.clockDriftPpm = 0;
+        if (config.clockSkew) {
+            // Deterministic per node: up to 10 s apart, drift spread over +-clockSkewPpm
+            node.clockOffsetUs = (uint64_t)((node.id * 7919u) % 1000u) * 10000u;
+            node.clockDriftPpm = config.clockSkewPpm * ((int)((node.id * 37u) % 201u) - 100) / 100.0;
+        }
+
+        useClock(node);
+        node.api->begin(node.transport, node.id);
+        for (int reg = 1; reg <= nodeCount; reg++) {
+            node.api->addHreg(reg, &node.inbox[reg]);
+        }
+        for (int reg = 0; reg < SIM_BULK_REGS; reg++) {
+            node.api->addHreg(SIM_BULK_BASE + reg, &node.bulk[reg]);
+        }
+        node.api->addHreg(SIM_SYNC_REG, &node.syncOutput);
+        node.api->addHreg(SIM_PUB_REG, &node.published);
+        if (config.pubsub) {
+            node.api->publishHreg(SIM_PUB_REG);
+        }
+        node.api->connect();
+    }
+    if (config.pubsub) {
+        for (SimNode& node : nodes) {
+            SimNode& consumer = nodes[node.target - 1];
+            consumer.api->subscribeHreg(node.id, SIM_PUB_REG, consumer.inbox[node.id]);
+        }
+    }
+    VirtualClock::useGlobal();
+
+    std::vector<double> latenciesMs;
+    std::vector<double> timeErrorsUs;
+    std::vector<double> syncSkewsMs;
+    int16_t syncValue = 0;              // Latest value node 1 sent, 0 = none in flight
+    uint64_t syncFirstUs = 0;           // When the first other node saw it
+    int syncSeen = 0;
+    uint64_t formTimeoutUs = (uint64_t)config.formTimeoutS * 1000000ULL;
+    uint64_t measureStartUs = 0;
+    uint64_t measureEndUs = 0;
+    uint64_t killUs = 0;
+    int killIndex = (config.killNode && nodeCount >= (config.killPair ? 4 : 3)) ? nodeCount - 1 : -1;
+    int killPairIndex = (killIndex >= 0 && config.killPair) ? killIndex - 1 : -1;
+    uint64_t killedAtUs = 0;
+    size_t handoversAtKill = 0;
+    uint64_t acceptedAtKill = 0;
+    bool forgotten = false;
+
+    for (uint64_t now = 0;; now += config.stepUs) {
+        VirtualClock::advanceTo(now);
+        bus.advance();
+
+        for (SimNode& node : nodes) {
+            if (node.alive) {
+                useClock(node);
+                node.api->loop();
+            }
+        }
+        VirtualClock::useGlobal();
+
+        // Phase 1: network formation (checked once per simulated millisecond)
+        if (measureStartUs == 0) {
+            if (now % 1000 == 0 && networkFormed(nodes)) {
+                result.formMs = now / 1000.0;
+                measureStartUs = now;
+                measureEndUs = now + (uint64_t)config.durationS * 1000000ULL;
+                killUs = now + (measureEndUs - now) / 2;
+                watch.rotationsMs.clear();
+                for (SimNode& node : nodes) {
+                    node.nextWriteUs = now + random(config.writePeriodMs * 1000);
+                }
+            } else if (now >= formTimeoutUs) {
+                break;
+            }
+            continue;
+        }
+
+        // Phase 2: cyclic writes around the ring
+        for (SimNode& node : nodes) {
+            if (!node.alive) {
+                continue;
+            }
+            useClock(node);
+
+            if (now >= node.nextWriteUs) {
+                node.nextWriteUs += (uint64_t)config.writePeriodMs * 1000;
+                if (node.id == 1) {
+                    // Background bulk traffic competing with the cyclic writes
+                    node.api->setOperationPriority(MBEE_PRIORITY_LOW);
+                    for (uint32_t k = 0; k < config.chattyOps; k++) {
+                        node.api->writeHregManual(node.target, SIM_BULK_BASE + (k % 2), node.bulk, SIM_BULK_REGS - 1);
+                    }
+                }
+                node.api->setOperationPriority(config.ttrtUs > 0 ? MBEE_PRIORITY_HIGH : MBEE_PRIORITY_LOW);
+                if (node.id == 1 && config.syncOutputs) {
+                    // A new value replaces one still in flight, which is then not measured
+                    syncValue = syncValue >= 30000 ? 1 : syncValue + 1;
+                    syncFirstUs = 0;
+                    syncSeen = 0;
+                    uint32_t applyAtUs = node.api->networkMicros() + config.applyLeadMs * 1000;
+                    if (config.broadcast && config.applyLeadMs > 0) {
+                        node.api->writeHregGroupAt(MODBEE_GROUP_ALL, SIM_SYNC_REG, syncValue, applyAtUs);
+                    } else if (config.broadcast) {
+                        node.api->writeHregGroup(MODBEE_GROUP_ALL, SIM_SYNC_REG, syncValue);
+                    } else {
+                        for (const SimNode& other : nodes) {
+                            if (other.alive && other.id != node.id && config.applyLeadMs > 0) {
+                                node.api->writeHregAt(other.id, SIM_SYNC_REG, syncValue, applyAtUs);
+                            } else if (other.alive && other.id != node.id) {
+                                node.api->writeHreg(other.id, SIM_SYNC_REG, syncValue);
+                            }
+                        }
+                    }
+                }
+                if (config.poll || config.pubsub) {
+                    // Issued by setting it locally, the successor fetches it
+                    node.published = node.nextSequence;
+                    node.inFlight.push_back({node.nextSequence, now});
+                    result.opsIssued++;
+                    if (config.poll) {
+                        ModBeeCompletion tally = [&result](ModBeeRequestState state, uint8_t) {
+                            if (state == MBEE_REQUEST_DONE) {
+                                result.asyncDone++;
+                            } else {
+                                result.asyncFailed++;
+                            }
+                        };
+                        for (const SimNode& producer : nodes) {
+                            if (producer.alive && producer.target == node.id && config.pollTable) {
+                                // Adding a point again only rebinds it, the table does the reading
+                                node.api->pollHreg(producer.id, SIM_PUB_REG, node.inbox[producer.id], config.writePeriodMs);
+                                for (uint32_t reg = 0; reg < config.pollRegs; reg++) {
+                                    node.api->pollHreg(producer.id, SIM_BULK_BASE + reg, node.polled[reg], config.writePeriodMs);
+                                }
+                            } else if (producer.alive && producer.target == node.id && config.async) {
+                                node.api->readHregAsync(producer.id, SIM_PUB_REG, node.inbox[producer.id], tally);
+                                for (uint32_t reg = 0; reg < config.pollRegs; reg++) {
+                                    node.api->readHregAsync(producer.id, SIM_BULK_BASE + reg, node.polled[reg], tally);
+                                }
+                            } else if (producer.alive && producer.target == node.id) {
+                                node.api->readHreg(producer.id, SIM_PUB_REG, node.inbox[producer.id]);
+                                for (uint32_t reg = 0; reg < config.pollRegs; reg++) {
+                                    node.api->readHreg(producer.id, SIM_BULK_BASE + reg, node.polled[reg]);
+                                }
+                            }
+                        }
+                    }
+                } else if (node.api->writeHreg(node.target, node.id, node.nextSequence)) {
+                    node.inFlight.push_back({node.nextSequence, now});
+                    result.opsIssued++;
+                }
+                node.nextSequence = node.nextSequence >= 30000 ? 1 : node.nextSequence + 1;
+            }
+
+            // Completion: the value has arrived in the target's data map
+            if (!node.inFlight.empty()) {
+                int16_t seen = nodes[node.target - 1].inbox[node.id];
+                while (!node.inFlight.empty() && node.inFlight.front().sequence != seen &&
+                       now - node.inFlight.front().issuedUs > 5000000ULL) {
+                    node.inFlight.pop_front();
+                    node.lost++;
+                }
+                if (!node.inFlight.empty()) {
+                    for (size_t k = 0; k < node.inFlight.size(); k++) {
+                        if (node.inFlight[k].sequence == seen) {
+                            // Older writes overtaken by this one never landed on their own
+                            node.lost += k;
+                            latenciesMs.push_back((now - node.inFlight[k].issuedUs) / 1000.0);
+                            node.completed++;
+                            node.inFlight.erase(node.inFlight.begin(), node.inFlight.begin() + k + 1);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        VirtualClock::useGlobal();
+
+        // Network time: every synced node against node 1, read at the same instant
+        if (now % 1000 == 0 && now >= measureStartUs + 1000000ULL && nodes[0].alive) {
+            useClock(nodes[0]);
+            uint32_t referenceUs = nodes[0].api->networkMicros();
+            for (SimNode& node : nodes) {
+                useClock(node);
+                if (node.alive && node.id != 1 && node.api->isTimeSynced()) {
+                    int32_t errorUs = (int32_t)(node.api->networkMicros() - referenceUs);
+                    timeErrorsUs.push_back(errorUs < 0 ? -(double)errorUs : (double)errorUs);
+                }
+            }
+            VirtualClock::useGlobal();
+        }
+
+        // Sync outputs: skew between the first and the last other node latching the value
+        if (syncValue != 0) {
+            int seen = 0;
+            int alive = 0;
+            for (const SimNode& node : nodes) {
+                if (node.alive && node.id != 1) {
+                    alive++;
+                    seen += (node.syncOutput == syncValue);
+                }
+            }
+            if (seen > 0 && syncSeen == 0) {
+                syncFirstUs = now;
+            }
+            syncSeen = seen;
+            if (alive > 0 && seen == alive) {
+                syncSkewsMs.push_back((now - syncFirstUs) / 1000.0);
+                syncValue = 0;
+            }
+        }
+
+        // Phase 3: kill a node (with --kill-pair, once its predecessor has passed it the
+        // token); writers to a dead node retarget to the next live one
+        bool pairReady = killPairIndex < 0 ||
+            (watch.lastTokenFrom == nodes[killPairIndex].id && watch.lastTokenTo == nodes[killIndex].id);
+        if (killIndex >= 0 && killedAtUs == 0 && now >= killUs && pairReady) {
+            for (int index : {killIndex, killPairIndex}) {
+                if (index >= 0) {
+                    nodes[index].alive = false;
+                    nodes[index].transport->end();
+                }
+            }
+            killedAtUs = now;
+            handoversAtKill = watch.handoverCount;
+            acceptedAtKill = watch.acceptedCount;
+            for (SimNode& node : nodes) {
+                if (node.alive && !nodes[node.target - 1].alive) {
+                    node.lost += node.inFlight.size();
+                    node.inFlight.clear();
+                    while (!nodes[node.target - 1].alive) {
+                        node.target = nodes[node.target - 1].target;
+                    }
+                    if (config.pubsub) {
+                        SimNode& consumer = nodes[node.target - 1];
+                        consumer.api->subscribeHreg(node.id, SIM_PUB_REG, consumer.inbox[node.id]);
+                    }
+                }
+            }
+        }
+
+        // A pass in a frame that started before the kill ends after it: only count later frames
+        if (killedAtUs != 0 && result.reclaimMs < 0 && watch.acceptedCount > acceptedAtKill &&
+            watch.lastAcceptedUs >= killedAtUs) {
+            result.reclaimMs = (watch.lastAcceptedUs - killedAtUs) / 1000.0;
+        }
+
+        if (killedAtUs != 0 && result.recoveryMs < 0 && now % 1000 == 0) {
+            bool pairForgotten = killPairIndex < 0 || nodeForgotten(nodes, nodes[killPairIndex].id);
+            if (!forgotten && nodeForgotten(nodes, nodes[killIndex].id) && pairForgotten) {
+                forgotten = true;
+                handoversAtKill = watch.handoverCount;
+            }
+            if (forgotten && watch.handoverCount > handoversAtKill) {
+                result.recoveryMs = (now - killedAtUs) / 1000.0;
+            }
+        }
+
+        if (now >= measureEndUs) {
+            break;
+        }
+    }
+
+    // Results
+    result.simSeconds = VirtualClock::nowUs() / 1e6;
+    if (measureStartUs != 0) {
+        double measureS = (VirtualClock::nowUs() - measureStartUs) / 1e6;
+        std::vector<double> opsPerNode;
+        for (SimNode& node : nodes) {
+            result.opsCompleted += node.completed;
+            result.opsLost += node.lost;
+            if (node.alive) {
+                opsPerNode.push_back(node.completed / measureS);
+            }
+        }
+        result.opsPerNodeMean = mean(opsPerNode);
+        result.opsPerNodeMin = opsPerNode.empty() ? 0 : *std::min_element(opsPerNode.begin(), opsPerNode.end());
+        result.latencyP50Ms = percentile(latenciesMs, 0.50);
+        result.latencyP99Ms = percentile(latenciesMs, 0.99);
+        result.rotationMeanMs = mean(watch.rotationsMs);
+        result.rotationP99Ms = percentile(watch.rotationsMs, 0.99);
+        result.syncSkewP50Ms = percentile(syncSkewsMs, 0.50);
+        result.syncSkewP99Ms = percentile(syncSkewsMs, 0.99);
+        result.timeErrorP50Us = percentile(timeErrorsUs, 0.50);
+        result.timeErrorP99Us = percentile(timeErrorsUs, 0.99);
+    }
+    result.collisions = bus.getStatistics().collisions;
+    result.busUtilisation = result.simSeconds > 0 ? bus.getStatistics().busyUs / (result.simSeconds * 1e6) : 0;
+
+    std::vector<double> txGaps;
+    for (SimNode& node : nodes) {
+        if (node.alive) {
+            txGaps.push_back(node.api->getBusStatistics().getTxGapMeanUs());
+            ModBeeTokenStats token = node.api->getTokenStatistics();
+            result.holdMaxMs = std::max(result.holdMaxMs, token.holdMaxUs / 1000.0);
+            result.lateTokens += token.lateTokens;
+        }
+        OperationStats operations = node.api->getOperationStatistics();
+        result.mergedOps += operations.mergedReads + operations.mergedWrites;
+        result.mergeBytesSaved += operations.bytesSaved;
+        ModBeePollStats polls = node.api->getPollStatistics();
+        result.polls += polls.polls;
+        result.pollFailures += polls.failures;
+    }
+    result.txGapMeanUs = mean(txGaps);
+
+    for (SimNode& node : nodes) {
+        delete node.api;
+        delete node.transport;
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+static const char* CSV_HEADER =
+    "label,nodes,baud,seed,form_ms,rotation_mean_ms,rotation_p99_ms,ops_per_s_node_mean,ops_per_s_node_min,"
+    "latency_p50_ms,latency_p99_ms,ops_issued,ops_completed,ops_lost,recovery_ms,reclaim_ms,collisions,bus_utilisation,"
+    "tx_gap_mean_us,hold_max_ms,late_tokens,sync_skew_p50_ms,sync_skew_p99_ms,"
+    "time_err_p50_us,time_err_p99_us,merged_ops,merge_bytes_saved,async_done,async_failed,polls,poll_failures,sim_s,wall_s";
+
+static void writeCsvRow(FILE* out, const SimConfig& config, const SimResult& r) {
+    fprintf(out, "%s,%d,%u,%u,%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%llu,%llu,%llu,%.1f,%.2f,%u,%.3f,%.0f,%.2f,%u,%.2f,%.2f,%.1f,%.1f,%u,%u,%u,%u,%u,%u,%.1f,%.1f\n",
+            config.label.c_str(), r.nodes, config.baudRate, config.seed, r.formMs,
+            r.rotationMeanMs, r.rotationP99Ms, r.opsPerNodeMean, r.opsPerNodeMin,
+            r.latencyP50Ms, r.latencyP99Ms,
+            (unsigned long long)r.opsIssued, (unsigned long long)r.opsCompleted, (unsigned long long)r.opsLost,
+            r.recoveryMs, r.reclaimMs, r.collisions, r.busUtilisation, r.txGapMeanUs, r.holdMaxMs, r.lateTokens,
+            r.syncSkewP50Ms, r.syncSkewP99Ms, r.timeErrorP50Us, r.timeErrorP99Us,
+            r.mergedOps, r.mergeBytesSaved, r.asyncDone, r.asyncFailed, r.polls, r.pollFailures, r.simSeconds, r.wallSeconds);
+}
+
+static std::vector<int> parseList(const char* text) {
+    std::vector<int> values;
+    while (*text) {
+        values.push_back(atoi(text));
+        const char* comma = strchr(text, ',');
+        if (!comma) {
+            break;
+        }
+        text = comma + 1;
+    }
+    return values;
+}
+
+static void usage(const char* program) {
+    printf("Usage: %s [options]\n"
+           "  --nodes LIST       node counts to simulate, e.g. 2,10,50,250 (2..250)\n"
+           "  --baud N           bus baud rate (default 115200)\n"
+           "  --duration S       measurement time after formation (default 20)\n"
+           "  --form-timeout S   give up forming the network after S (default 300)\n"
+           "  --period MS        write period per node (default 100)\n"
+           "  --step US          virtual time per loop() pass (default 50)\n"
+           "  --no-kill          do not kill a node during the run\n"
+           "  --kill-pair        kill the victim's predecessor too, right after it passed the token\n"
+           "  --compact          send compact (TLV) sections\n"
+           "  --short-tokens     pass an empty token as a 5-byte frame\n"
+           "  --idle-skip N      skip idle nodes' turns for up to N rotations (with --short-tokens)\n"
+           "  --ttrt US          target token rotation time; cyclic writes become high priority\n"
+           "  --chatty N         node 1 also queues N low-priority bulk writes per period\n"
+           "  --sync             node 1 also sets one output register on every node per period\n"
+           "  --broadcast        ... with a single multicast write (with --sync)\n"
+           "  --at MS            ... applied MS ahead on the network time (with --sync)\n"
+           "  --clock-skew PPM   nodes boot up to 10 s apart with clocks off by up to +-PPM\n"
+           "  --poll             successors read each node's value instead of it being written\n"
+           "  --pubsub           ... or subscribe to it\n"
+           "  --poll-regs N      each poll also reads N bulk registers, one call per register\n"
+           "  --async            issue the polls with readHregAsync() and count how they end\n"
+           "  --poll-table       ... or leave them to the polling table\n"
+           "  --join-slots N     build the ring with join windows of N contention slots (1..32)\n"
+           "  --max-nodes N      configure MODBEE_MAX_NODES above the node count\n"
+           "  --seed N           random seed (default 1)\n"
+           "  --csv PATH         append results to PATH\n"
+           "  --label TEXT       label column, e.g. the commit hash\n", program);
+}
+
+int main(int argc, char** argv) {
+    SimConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : "";
+
+        if (arg == "--nodes") { config.nodeCounts = parseList(value); i++; }
+        else if (arg == "--baud") { config.baudRate = atoi(value); i++; }
+        else if (arg == "--duration") { config.durationS = atoi(value); i++; }
+        else if (arg == "--form-timeout") { config.formTimeoutS = atoi(value); i++; }
+        else if (arg == "--period") { config.writePeriodMs = atoi(value); i++; }
+        else if (arg == "--step") { config.stepUs = atoi(value); i++; }
+        else if (arg == "--no-kill") { config.killNode = false; }
+        else if (arg == "--kill-pair") { config.killPair = true; }
+        else if (arg == "--compact") { config.compactSections = true; }
+        else if (arg == "--short-tokens") { config.shortTokens = true; }
+        else if (arg == "--idle-skip") { config.idleSkipRotations = (uint8_t)atoi(value); i++; }
+        else if (arg == "--ttrt") { config.ttrtUs = atoi(value); i++; }
+        else if (arg == "--chatty") { config.chattyOps = atoi(value); i++; }
+        else if (arg == "--sync") { config.syncOutputs = true; }
+        else if (arg == "--broadcast") { config.broadcast = true; }
+        else if (arg == "--at") { config.applyLeadMs = atoi(value); i++; }
+        else if (arg == "--clock-skew") { config.clockSkewPpm = atof(value); config.clockSkew = true; i++; }
+        else if (arg == "--poll") { config.poll = true; }
+        else if (arg == "--pubsub") { config.pubsub = true; }
+        else if (arg == "--async") { config.async = true; }
+        else if (arg == "--poll-table") { config.pollTable = true; }
+        else if (arg == "--poll-regs") { config.pollRegs = std::min(atoi(value), SIM_BULK_REGS); i++; }
+        else if (arg == "--join-slots") { config.joinSlots = (uint8_t)atoi(value); i++; }
+        else if (arg == "--max-nodes") { config.maxNodes = atoi(value); i++; }
+        else if (arg == "--seed") { config.seed = atoi(value); i++; }
+        else if (arg == "--csv") { config.csvPath = value; i++; }
+        else if (arg == "--label") { config.label = value; i++; }
+        else { usage(argv[0]); return arg == "--help" ? 0 : 1; }
+    }
+
+    if (config.stepUs == 0 || config.baudRate == 0 || config.writePeriodMs == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* csv = nullptr;
+    if (!config.csvPath.empty()) {
+        FILE* existing = fopen(config.csvPath.c_str(), "r");
+        bool needsHeader = (existing == nullptr);
+        if (existing) {
+            fclose(existing);
+        }
+        csv = fopen(config.csvPath.c_str(), "a");
+        if (!csv) {
+            fprintf(stderr, "Cannot open %s\n", config.csvPath.c_str());
+            return 1;
+        }
+        if (needsHeader) {
+            fprintf(csv, "%s\n", CSV_HEADER);
+        }
+    }
+
+    printf("%s\n", CSV_HEADER);
+    for (int nodeCount : config.nodeCounts) {
+        if (nodeCount < 2 || nodeCount > SIM_MAX_NODES) {
+            fprintf(stderr, "Skipping %d nodes (must be 2..%d)\n", nodeCount, SIM_MAX_NODES);
+            continue;
+        }
+
+        SimResult result = runScenario(config, nodeCount);
+        writeCsvRow(stdout, config, result);
+        fflush(stdout);
+        if (csv) {
+            writeCsvRow(csv, config, result);
+            fflush(csv);
+        }
+    }
+
+    if (csv) {
+        fclose(csv);
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "Arduino.h"
+#include "../VirtualClock.h"
+
+uint64_t VirtualClock::_nowUs = 0;
+uint64_t VirtualClock::_offsetUs = 0;
+double VirtualClock::_driftPpm = 0.0;
+
+// =============================================================================
+// TIME
+// =============================================================================
+// 32 bits like the ESP32's, so the library's wrap handling runs on the host too
+unsigned long millis() {
+    return (uint32_t)(VirtualClock::localUs() / 1000);
+}
+
+unsigned long micros() {
+    return (uint32_t)VirtualClock::localUs();
+}
+
+void delay(unsigned long ms) {
+    VirtualClock::advanceTo(VirtualClock::nowUs() + ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    VirtualClock::advanceTo(VirtualClock::nowUs() + us);
+}
+
+// =============================================================================
+// RANDOM (deterministic per seed so runs are reproducible)
+// =============================================================================
+static uint32_t randomState = 1;
+
+void randomSeed(unsigned long seed) {
+    randomState = seed ? (uint32_t)seed : 1;
+}
+
+static uint32_t nextRandom() {
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+long random(long max) {
+    return max > 0 ? (long)(nextRandom() % (uint32_t)max) : 0;
+}
+
+long random(long min, long max) {
+    return max > min ? min + random(max - min) : min;
+}
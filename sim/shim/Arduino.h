@@ -0,0 +1,66 @@
+#pragma once
+
+// =============================================================================
+// HOST ARDUINO SHIM
+// =============================================================================
+// Just enough of the Arduino core to build ModBeeProtocol on Linux.
+// millis()/micros() read the simulator's virtual clock.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+// =============================================================================
+// TIME AND RANDOM
+// =============================================================================
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+// =============================================================================
+// STREAMS
+// =============================================================================
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (n < size && write(buffer[n])) {
+            n++;
+        }
+        return n;
+    }
+    virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t n = 0;
+        while (n < length) {
+            int c = read();
+            if (c < 0) {
+                break;
+            }
+            buffer[n++] = (char)c;
+        }
+        return n;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return readBytes((char*)buffer, length);
+    }
+};
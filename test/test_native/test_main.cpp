@@ -0,0 +1,329 @@
+#include <unity.h>
+#include "ModBeeGlobal.h"
+#include "VirtualClock.h"
+
+/**
+ * Host-native unit tests for the fixed-size containers
+ *   pio test -e native_test
+ * ModBeeNodeSet at the word edges (IDs 0, 31, 32, 255), ModBeeTimerQueue order
+ * after a rearm and across the millis() wrap, and ModBeeOpPool's send, per-node
+ * and age lists through insert, remove, moveToFront and erase-while-iterating.
+ * Also ModBeeNetworkTime holding its drift correction over past the micros() wrap.
+ */
+
+void setUp() {}
+void tearDown() {}
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+static PendingModbusOp makeOp(uint8_t destNodeID, ModBeePriority priority, uint32_t timestamp, uint16_t tag) {
+    PendingModbusOp op = PendingModbusOp();
+    op.destNodeID = destNodeID;
+    op.priority = priority;
+    op.timestamp = timestamp;
+    op.req.startAddr = tag;             // Identifies the operation in the checks
+    return op;
+}
+
+template<typename Range>
+static std::vector<uint16_t> tags(const Range& range) {
+    std::vector<uint16_t> result;
+    for (const auto& op : range) {
+        result.push_back(op.req.startAddr);
+    }
+    return result;
+}
+
+static void assertTags(const std::vector<uint16_t>& expected, const std::vector<uint16_t>& actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT16(expected[i], actual[i]);
+    }
+}
+
+// =============================================================================
+// NODE SET
+// =============================================================================
+void test_node_set_empty() {
+    ModBeeNodeSet set;
+    TEST_ASSERT_TRUE(set.empty());
+    TEST_ASSERT_EQUAL_UINT8(0, set.first());
+    TEST_ASSERT_EQUAL_UINT8(0, set.next(0));
+    TEST_ASSERT_EQUAL_UINT8(0, set.next(255));
+    TEST_ASSERT_EQUAL_UINT8(0, set.successor(31));
+    TEST_ASSERT_EQUAL_UINT16(0, set.countBelow(255));
+    TEST_ASSERT_FALSE(set.hasMemberBelow(255));
+}
+
+void test_node_set_word_edges() {
+    ModBeeNodeSet set;
+    TEST_ASSERT_TRUE(set.insert(0));
+    TEST_ASSERT_TRUE(set.insert(31));
+    TEST_ASSERT_TRUE(set.insert(32));
+    TEST_ASSERT_TRUE(set.insert(255));
+    TEST_ASSERT_FALSE(set.insert(32));
+    TEST_ASSERT_EQUAL_UINT16(4, set.count());
+    TEST_ASSERT_TRUE(set.contains(0));
+    TEST_ASSERT_TRUE(set.contains(255));
+    TEST_ASSERT_FALSE(set.contains(30));
+    TEST_ASSERT_FALSE(set.contains(33));
+
+    // Node 0 is a member, but never reported by the ordered queries
+    TEST_ASSERT_EQUAL_UINT8(31, set.first());
+    TEST_ASSERT_EQUAL_UINT8(31, set.next(0));
+    TEST_ASSERT_EQUAL_UINT8(31, set.next(30));
+    TEST_ASSERT_EQUAL_UINT8(32, set.next(31));
+    TEST_ASSERT_EQUAL_UINT8(255, set.next(32));
+    TEST_ASSERT_EQUAL_UINT8(255, set.next(254));
+    TEST_ASSERT_EQUAL_UINT8(0, set.next(255));
+    TEST_ASSERT_EQUAL_UINT8(32, set.successor(31));
+    TEST_ASSERT_EQUAL_UINT8(31, set.successor(255));
+
+    TEST_ASSERT_EQUAL_UINT16(0, set.countBelow(0));
+    TEST_ASSERT_EQUAL_UINT16(0, set.countBelow(31));
+    TEST_ASSERT_EQUAL_UINT16(1, set.countBelow(32));
+    TEST_ASSERT_EQUAL_UINT16(2, set.countBelow(33));
+    TEST_ASSERT_EQUAL_UINT16(2, set.countBelow(255));
+    TEST_ASSERT_FALSE(set.hasMemberBelow(31));
+    TEST_ASSERT_TRUE(set.hasMemberBelow(32));
+}
+
+void test_node_set_erase() {
+    ModBeeNodeSet set;
+    set.insert(31);
+    set.insert(32);
+    set.insert(255);
+    TEST_ASSERT_TRUE(set.erase(31));
+    TEST_ASSERT_FALSE(set.erase(31));
+    TEST_ASSERT_EQUAL_UINT16(2, set.count());
+    TEST_ASSERT_EQUAL_UINT8(32, set.first());
+    TEST_ASSERT_EQUAL_UINT16(0, set.countBelow(32));
+
+    ModBeeNodeSet other;
+    other.insert(31);
+    TEST_ASSERT_FALSE(set.intersects(other));
+    other.insert(255);
+    TEST_ASSERT_TRUE(set.intersects(other));
+}
+
+// =============================================================================
+// TIMER QUEUE
+// =============================================================================
+static std::vector<uint8_t> timerOrder(const ModBeeTimerQueue<4>& timers) {
+    std::vector<uint8_t> result;
+    for (uint8_t slot = timers.front(); slot != MODBEE_OP_NONE; slot = timers.links()[slot]) {
+        result.push_back(slot);
+    }
+    return result;
+}
+
+void test_timer_queue_rearm_order() {
+    ModBeeTimerQueue<4> timers;
+    timers.arm(0, 100);
+    timers.arm(1, 200);
+    timers.arm(2, 300);
+    TEST_ASSERT_EQUAL_UINT8(0, timers.front());
+
+    // A retried entry restarts its timeout and goes behind everything armed before
+    timers.rearm(0, 400);
+    std::vector<uint8_t> order = timerOrder(timers);
+    TEST_ASSERT_EQUAL_UINT32(3, order.size());
+    TEST_ASSERT_EQUAL_UINT8(1, order[0]);
+    TEST_ASSERT_EQUAL_UINT8(2, order[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, order[2]);
+
+    // Armed out of order, an entry still lands by its start time
+    timers.arm(3, 250);
+    order = timerOrder(timers);
+    TEST_ASSERT_EQUAL_UINT8(1, order[0]);
+    TEST_ASSERT_EQUAL_UINT8(3, order[1]);
+    TEST_ASSERT_EQUAL_UINT8(2, order[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, order[3]);
+
+    TEST_ASSERT_FALSE(timers.expired(300, 100));
+    TEST_ASSERT_TRUE(timers.expired(301, 100));
+    timers.disarm(1);
+    TEST_ASSERT_EQUAL_UINT8(3, timers.front());
+    TEST_ASSERT_FALSE(timers.expired(301, 100));
+}
+
+void test_timer_queue_wrap() {
+    ModBeeTimerQueue<4> timers;
+    timers.arm(0, 0xFFFFFFF0UL);
+    timers.arm(1, 0x10);
+    timers.rearm(0, 0x20);
+    std::vector<uint8_t> order = timerOrder(timers);
+    TEST_ASSERT_EQUAL_UINT8(1, order[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, order[1]);
+    TEST_ASSERT_FALSE(timers.expired(0x30, 0x20));
+    TEST_ASSERT_TRUE(timers.expired(0x31, 0x20));
+}
+
+// =============================================================================
+// OPERATION POOL
+// =============================================================================
+void test_op_pool_insert_order() {
+    ModBeeOpPool pool;
+    pool.insert(makeOp(5, MBEE_PRIORITY_LOW, 10, 1));
+    pool.insert(makeOp(6, MBEE_PRIORITY_LOW, 11, 2));
+    pool.insert(makeOp(5, MBEE_PRIORITY_HIGH, 12, 3));
+    pool.insert(makeOp(6, MBEE_PRIORITY_HIGH, 13, 4));
+
+    // High priority first, each class in arrival order
+    assertTags({3, 4, 1, 2}, tags(pool.all()));
+    assertTags({1, 3}, tags(pool.forNode(5)));
+    assertTags({2, 4}, tags(pool.forNode(6)));
+    assertTags({1, 2, 3, 4}, tags(pool.byAge()));
+    TEST_ASSERT_EQUAL_UINT16(4, pool.size());
+    TEST_ASSERT_TRUE(pool.hasNode(5));
+    TEST_ASSERT_FALSE(pool.hasNode(7));
+}
+
+void test_op_pool_remove() {
+    ModBeeOpPool pool;
+    PendingModbusOp* first = pool.insert(makeOp(5, MBEE_PRIORITY_LOW, 10, 1));
+    PendingModbusOp* high = pool.insert(makeOp(5, MBEE_PRIORITY_HIGH, 11, 2));
+    pool.insert(makeOp(6, MBEE_PRIORITY_LOW, 12, 3));
+
+    pool.remove(*high);
+    assertTags({1, 3}, tags(pool.all()));
+    assertTags({1}, tags(pool.forNode(5)));
+
+    // A high-priority operation queued now is the head again
+    pool.insert(makeOp(6, MBEE_PRIORITY_HIGH, 13, 4));
+    assertTags({4, 1, 3}, tags(pool.all()));
+
+    pool.remove(*first);
+    TEST_ASSERT_FALSE(pool.hasNode(5));
+    assertTags({4, 3}, tags(pool.all()));
+    assertTags({3, 4}, tags(pool.byAge()));
+    TEST_ASSERT_EQUAL_UINT16(2, pool.size());
+}
+
+void test_op_pool_move_to_front() {
+    ModBeeOpPool pool;
+    pool.insert(makeOp(5, MBEE_PRIORITY_HIGH, 10, 1));
+    pool.insert(makeOp(5, MBEE_PRIORITY_LOW, 11, 2));
+    PendingModbusOp* low = pool.insert(makeOp(6, MBEE_PRIORITY_LOW, 12, 3));
+    PendingModbusOp* high = pool.insert(makeOp(6, MBEE_PRIORITY_HIGH, 13, 4));
+
+    // Each to the front of its own class: a low one never overtakes the high ones
+    pool.moveToFront(*low);
+    assertTags({1, 4, 3, 2}, tags(pool.all()));
+    pool.moveToFront(*high);
+    assertTags({4, 1, 3, 2}, tags(pool.all()));
+
+    // The per-node lists keep arrival order
+    assertTags({3, 4}, tags(pool.forNode(6)));
+
+    // Low operations still queue behind the last high one
+    pool.insert(makeOp(7, MBEE_PRIORITY_HIGH, 14, 5));
+    assertTags({4, 1, 5, 3, 2}, tags(pool.all()));
+}
+
+void test_op_pool_erase_while_iterating() {
+    ModBeeOpPool pool;
+    for (uint16_t tag = 1; tag <= 6; tag++) {
+        pool.insert(makeOp(tag % 2 ? 5 : 6, MBEE_PRIORITY_LOW, tag, tag));
+    }
+
+    // Erase every operation for node 5 while walking the send queue
+    for (auto it = pool.all().begin(); it != pool.all().end();) {
+        if (it->destNodeID == 5) {
+            it = pool.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    assertTags({2, 4, 6}, tags(pool.all()));
+    TEST_ASSERT_FALSE(pool.hasNode(5));
+
+    // And through a node's own list
+    for (auto it = pool.forNode(6).begin(); it != pool.forNode(6).end();) {
+        if (it->req.startAddr == 4) {
+            it = pool.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    assertTags({2, 6}, tags(pool.forNode(6)));
+    assertTags({2, 6}, tags(pool.byAge()));
+    TEST_ASSERT_EQUAL_UINT16(2, pool.size());
+}
+
+void test_op_pool_full() {
+    ModBeeOpPool pool;
+    for (uint16_t i = 0; i < MODBEE_MAX_PENDING_OPS; i++) {
+        TEST_ASSERT_NOT_NULL(pool.insert(makeOp(1 + i % 8, MBEE_PRIORITY_LOW, i, i)));
+    }
+    TEST_ASSERT_TRUE(pool.full());
+    TEST_ASSERT_NULL(pool.insert(makeOp(1, MBEE_PRIORITY_LOW, 0, 999)));
+
+    // A freed slot takes the next operation
+    pool.remove(*pool.front());
+    TEST_ASSERT_FALSE(pool.full());
+    TEST_ASSERT_NOT_NULL(pool.insert(makeOp(1, MBEE_PRIORITY_LOW, 100, 1000)));
+    TEST_ASSERT_EQUAL_UINT16(MODBEE_MAX_PENDING_OPS, pool.size());
+
+    pool.clear();
+    TEST_ASSERT_TRUE(pool.empty());
+    TEST_ASSERT_NULL(pool.front());
+    TEST_ASSERT_NULL(pool.oldest());
+}
+
+void test_op_pool_rearm() {
+    ModBeeOpPool pool;
+    PendingModbusOp* first = pool.insert(makeOp(5, MBEE_PRIORITY_LOW, 10, 1));
+    pool.insert(makeOp(6, MBEE_PRIORITY_LOW, 20, 2));
+
+    pool.rearm(*first, 30);
+    TEST_ASSERT_EQUAL_UINT32(30, first->timestamp);
+    assertTags({2, 1}, tags(pool.byAge()));
+    assertTags({1, 2}, tags(pool.all()));
+    TEST_ASSERT_FALSE(pool.expired(40, 20));
+    TEST_ASSERT_TRUE(pool.expired(41, 20));
+}
+
+// =============================================================================
+// NETWORK TIME
+// =============================================================================
+void test_network_time_holdover() {
+    // A master 500 ppm fast, sampled twice, then silent for two hours: longer
+    // than micros() takes to wrap
+    VirtualClock::reset();
+    ModBeeNetworkTime time;
+    time.addSample(1000000, micros());
+    delay(1000);
+    time.addSample(2000500, micros());
+    TEST_ASSERT_TRUE(time.getStatistics().driftPpb > 0);
+
+    uint32_t last = time.now();
+    for (uint32_t second = 0; second < 7200; second++) {
+        delay(1000);
+        time.holdOver(micros());
+        uint32_t stepUs = time.now() - last;
+        TEST_ASSERT_TRUE(stepUs > 1000000 && stepUs < 1001000);
+        last = time.now();
+    }
+}
+
+// =============================================================================
+// RUNNER
+// =============================================================================
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_node_set_empty);
+    RUN_TEST(test_node_set_word_edges);
+    RUN_TEST(test_node_set_erase);
+    RUN_TEST(test_timer_queue_rearm_order);
+    RUN_TEST(test_timer_queue_wrap);
+    RUN_TEST(test_op_pool_insert_order);
+    RUN_TEST(test_op_pool_remove);
+    RUN_TEST(test_op_pool_move_to_front);
+    RUN_TEST(test_op_pool_erase_while_iterating);
+    RUN_TEST(test_op_pool_full);
+    RUN_TEST(test_op_pool_rearm);
+    RUN_TEST(test_network_time_holdover);
+    return UNITY_END();
+}
@@ -0,0 +1,132 @@
+#include <unity.h>
+#include "ModBeeGlobal.h"
+#include "VirtualClock.h"
+
+/**
+ * Host-native tests of two nodes forming a ring over a LoopbackBus
+ *   pio test -e native_test
+ * The simulator's virtual clock only moves when a test advances it, so each
+ * run is deterministic and takes simulated seconds, not real ones.
+ */
+
+static const uint32_t STEP_US = 100;                // Virtual time per loop() pass
+
+void setUp() {
+    VirtualClock::reset();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+// Runs both nodes until done() or maxUs of virtual time, returns done()
+template<typename Node, typename Done>
+static bool runUntil(Node& a, Node& b, uint32_t maxUs, Done done) {
+    for (uint32_t elapsedUs = 0; elapsedUs < maxUs; elapsedUs += STEP_US) {
+        a.loop();
+        b.loop();
+        if (done()) {
+            return true;
+        }
+        delayMicroseconds(STEP_US);
+    }
+    return false;
+}
+
+template<typename Node>
+static bool formRing(Node& a, Node& b) {
+    return runUntil(a, b, 10000000, [&]() {
+        return a.isConnected() && b.isConnected() && a.isNodeKnown(2) && b.isNodeKnown(1);
+    });
+}
+
+// =============================================================================
+// UNBUILDABLE OPERATIONS
+// =============================================================================
+static void checkUnbuildableFails(bool compact) {
+    ModBeeAPI::MODBEE_COMPACT_SECTIONS = compact;
+    LoopbackBus bus;
+    LoopbackBusTransport link1(bus), link2(bus);
+    link1.begin();
+    link2.begin();
+    ModBeeProtocol node1, node2;
+    node1.begin(1, &link1);
+    node2.begin(2, &link2);
+    node1.nodeConnect();
+    node2.nodeConnect();
+    TEST_ASSERT_TRUE(formRing(node1, node2));
+
+    // A read with no Modbus encoding: nothing can be sent, so nothing may wait for a reply
+    int16_t value = 0;
+    int state = -1;
+    PendingModbusOp op = PendingModbusOp();
+    op.destNodeID = 2;
+    op.sourceNodeID = 1;
+    op.req.function = 0x41;
+    op.req.startAddr = 0;
+    op.req.quantity = 1;
+    op.timestamp = millis();
+    op.resultPtr = &value;
+    op.priority = MBEE_PRIORITY_LOW;
+    op.onComplete = [&state](ModBeeRequestState result, uint8_t) { state = result; };
+    TEST_ASSERT_TRUE(node1.getOperations().addPendingOperation(op, node1));
+
+    TEST_ASSERT_TRUE(runUntil(node1, node2, 1000000, [&]() { return state != -1; }));
+    TEST_ASSERT_EQUAL_INT(MBEE_REQUEST_FAILED, state);
+    TEST_ASSERT_EQUAL_UINT16(0, node1.getOperations().getTransactionCount());
+    TEST_ASSERT_EQUAL_UINT16(0, node1.getOperations().getPendingOpCount());
+    ModBeeAPI::MODBEE_COMPACT_SECTIONS = false;
+}
+
+void test_unbuildable_operation_fails() {
+    checkUnbuildableFails(false);
+}
+
+void test_unbuildable_operation_fails_compact() {
+    checkUnbuildableFails(true);
+}
+
+// =============================================================================
+// POLLING TABLE
+// =============================================================================
+void test_unpoll_detaches_read_in_flight() {
+    LoopbackBus bus;
+    LoopbackBusTransport link1(bus), link2(bus);
+    ModBeeAPI node1, node2;
+    int16_t remote = 1234;
+    TEST_ASSERT_TRUE(node1.begin(&link1, 1));
+    TEST_ASSERT_TRUE(node2.begin(&link2, 2));
+    node2.addHreg(0, &remote);
+    node1.connect();
+    node2.connect();
+    TEST_ASSERT_TRUE(formRing(node1, node2));
+
+    // Unpolled once its read has left the queue and waits for the reply
+    int16_t value = -1;
+    TEST_ASSERT_TRUE(node1.pollHreg(2, 0, value, 1000));
+    uint16_t pendingOps = 0, completedOps = 0;
+    TEST_ASSERT_TRUE(runUntil(node1, node2, 3000000, [&]() {
+        node1.getStatistics(pendingOps, completedOps);
+        return node1.getPollStatistics().outstanding == 1 && pendingOps == 0;
+    }));
+    TEST_ASSERT_TRUE(node1.unpoll(2, MB_HOLDING_REGISTER, 0));
+
+    // The sketch may have freed the variable by now: the reply must not reach it
+    runUntil(node1, node2, 500000, []() { return false; });
+    TEST_ASSERT_EQUAL_INT(-1, value);
+    TEST_ASSERT_EQUAL_UINT16(0, node1.getPollStatistics().points);
+    node1.end();
+    node2.end();
+}
+
+// =============================================================================
+// RUNNER
+// =============================================================================
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_unbuildable_operation_fails);
+    RUN_TEST(test_unbuildable_operation_fails_compact);
+    RUN_TEST(test_unpoll_detaches_read_in_flight);
+    return UNITY_END();
+}